@@ -0,0 +1,45 @@
+// DRATCheck.cpp : Defines the entry point for the console application.
+// Checks DRAT or LRAT refutations written by SATSolver --prove.
+//
+
+#include "stdafx.h"
+#include "Proof_checker.h"
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	bool lrat = argc == 4 && _tcscmp(argv[1], _T("--lrat")) == 0;
+	if (argc != 3 && !lrat)
+	{
+		printf("Usage: DRATCheck [--lrat] <cnf file> <proof file>\n");
+		return 2;
+	}
+
+	FILE *cnfFile = NULL, *proofFile = NULL;
+	_tfopen_s(&cnfFile, argv[argc - 2], _T("rb"));
+	_tfopen_s(&proofFile, argv[argc - 1], _T("rb"));
+	if (cnfFile == NULL || proofFile == NULL)
+	{
+		printf("c could not open %s\n", cnfFile == NULL ? "the cnf file" : "the proof file");
+		return 2;
+	}
+
+	Proof_checker checker;
+	Proof_reader cnfReader(cnfFile), proofReader(proofFile);
+	bool verified = checker.loadFormula(cnfReader);
+	fclose(cnfFile);
+	if (verified)
+	{
+		verified = lrat ? checker.checkLRAT(proofReader) : checker.checkDRAT(proofReader);
+	}
+	fclose(proofFile);
+
+	printf("c %lld lemmas checked\n", checker.getLemmaCount());
+	if (!verified)
+	{
+		printf("c %s\n", checker.getError().c_str());
+		printf("s NOT VERIFIED\n");
+		return 1;
+	}
+	printf("s VERIFIED\n");
+	return 0;
+}
@@ -0,0 +1,834 @@
+#include "stdafx.h"
+#include <algorithm>
+#include "Proof_checker.h"
+
+/***************************************************
+* Proof_reader START
+***************************************************/
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inFile">file opened for binary reading</param>
+Proof_reader::Proof_reader(FILE *inFile)
+{
+	file = inFile;
+	buffer.resize(1 << 20);
+	position = 0;
+	length = 0;
+}
+
+/// <summary>
+/// Gets the next byte without consuming it.
+/// </summary>
+/// <returns>the byte, or -1 at the end of the file</returns>
+int Proof_reader::peek()
+{
+	if (position == length)
+	{
+		fill();
+		if (length == 0)
+		{
+			return -1;
+		}
+	}
+	return buffer[position];
+}
+
+/// <summary>
+/// Consumes and returns the next byte.
+/// </summary>
+/// <returns>the byte, or -1 at the end of the file</returns>
+int Proof_reader::next()
+{
+	int c = peek();
+	if (c >= 0)
+	{
+		position++;
+	}
+	return c;
+}
+
+/// <summary>
+/// Skips whitespace and comment lines starting with 'c'.
+/// </summary>
+void Proof_reader::skipBlank()
+{
+	while (true)
+	{
+		int c = peek();
+		if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+		{
+			position++;
+		}
+		else if (c == 'c')
+		{
+			while (c >= 0 && c != '\n')
+			{
+				c = next();
+			}
+		}
+		else
+		{
+			return;
+		}
+	}
+}
+
+/// <summary>
+/// Reads a signed decimal number after skipping blanks.
+/// </summary>
+/// <param name="value">receives the number</param>
+/// <returns>false if no number follows</returns>
+bool Proof_reader::readText(long long &value)
+{
+	skipBlank();
+	bool negative = false;
+	if (peek() == '-')
+	{
+		negative = true;
+		position++;
+	}
+	int c = peek();
+	if (c < '0' || c > '9')
+	{
+		return false;
+	}
+	value = 0;
+	while (c >= '0' && c <= '9')
+	{
+		value = value * 10 + (c - '0');
+		position++;
+		c = peek();
+	}
+	if (negative)
+	{
+		value = -value;
+	}
+	return true;
+}
+
+/// <summary>
+/// Reads a number in the binary DRAT encoding.
+/// </summary>
+/// <param name="value">receives the number</param>
+/// <returns>false at the end of the file</returns>
+bool Proof_reader::readBinary(long long &value)
+{
+	unsigned long long encoded = 0;
+	int shift = 0, c;
+	do
+	{
+		c = next();
+		if (c < 0 || shift > 63)
+		{
+			return false;
+		}
+		encoded |= (unsigned long long)(c & 127) << shift;
+		shift += 7;
+	} while (c & 128);
+
+	value = (encoded & 1) ? -(long long)(encoded >> 1) : (long long)(encoded >> 1);
+	return true;
+}
+
+/// <summary>
+/// Determines whether the unread data is in a binary encoding.  Binary proofs end every
+/// line with a zero byte, which never appears in text.
+/// </summary>
+/// <returns>true if a zero or non-ASCII byte appears within the first buffer</returns>
+bool Proof_reader::looksBinary()
+{
+	peek();
+	for (size_t i = position; i < length; i++)
+	{
+		if (buffer[i] == 0 || buffer[i] > 127)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/// <summary>
+/// Refills the buffer from the file.
+/// </summary>
+void Proof_reader::fill()
+{
+	length = fread(&buffer[0], 1, buffer.size(), file);
+	position = 0;
+}
+
+/***************************************************
+* Proof_reader END
+***************************************************/
+
+/***************************************************
+* Proof_checker public functions START
+***************************************************/
+
+/// <summary>
+/// Default constructor.
+/// </summary>
+Proof_checker::Proof_checker()
+{
+	num_members = 0;
+	qhead = 0;
+	refuted = false;
+	lemmas = 0;
+}
+
+/// <summary>
+/// Reads the formula to be refuted.
+/// </summary>
+/// <param name="reader">reader positioned at the start of a cnf file</param>
+/// <returns>false if the file is not a cnf formula</returns>
+bool Proof_checker::loadFormula(Proof_reader &reader)
+{
+	long long members, count;
+	reader.skipBlank();
+	if (reader.next() != 'p')
+	{
+		error = "the formula has no 'p cnf' line";
+		return false;
+	}
+	while (reader.peek() == ' ' || (reader.peek() >= 'a' && reader.peek() <= 'z'))
+	{
+		reader.next();
+	}
+	if (!reader.readText(members) || !reader.readText(count))
+	{
+		error = "the formula's 'p cnf' line is malformed";
+		return false;
+	}
+
+	num_members = 0;
+	growMembers((int)members);
+	formula.clear();
+	vector<int> clause;
+	long long literal;
+	//a '%' line ends some benchmark files
+	while (reader.peek() != '%' && reader.readText(literal))
+	{
+		if (literal == 0)
+		{
+			formula.push_back(clause);
+			clause.clear();
+		}
+		else
+		{
+			clause.push_back((int)literal);
+		}
+	}
+	if (!clause.empty())
+	{
+		formula.push_back(clause);
+	}
+	return true;
+}
+
+/// <summary>
+/// Checks a DRAT proof, in text or binary form.
+/// </summary>
+/// <param name="reader">reader positioned at the start of the proof</param>
+/// <returns>true if the proof refutes the formula</returns>
+bool Proof_checker::checkDRAT(Proof_reader &reader)
+{
+	for (unsigned int i = 0; i < formula.size(); i++)
+	{
+		for (unsigned int j = 0; j < formula[i].size(); j++)
+		{
+			growMembers(abs(formula[i][j]));
+		}
+		addClause(formula[i]);
+	}
+
+	bool binary = reader.looksBinary();
+	bool deletion;
+	long long id;
+	vector<int> literals;
+	vector<long long> hints;
+	while (readLine(reader, binary, false, deletion, id, literals, hints))
+	{
+		if (deletion)
+		{
+			deleteClause(literals);
+			continue;
+		}
+
+		lemmas++;
+		for (unsigned int i = 0; i < literals.size(); i++)
+		{
+			growMembers(abs(literals[i]));
+		}
+		if (!isRUP(literals) && !isRAT(literals))
+		{
+			error = "lemma " + to_string(lemmas) + " is neither RUP nor RAT";
+			return false;
+		}
+		if (literals.empty())
+		{
+			return true;
+		}
+		addClause(literals);
+	}
+	if (!error.empty())
+	{
+		return false;
+	}
+
+	//propagation alone refutes the formula and lemmas, which is as good as an empty clause
+	if (refuted)
+	{
+		return true;
+	}
+	error = "the proof does not derive the empty clause";
+	return false;
+}
+
+/// <summary>
+/// Checks an LRAT proof, in text or binary form.
+/// </summary>
+/// <param name="reader">reader positioned at the start of the proof</param>
+/// <returns>true if the proof refutes the formula</returns>
+bool Proof_checker::checkLRAT(Proof_reader &reader)
+{
+	unordered_map<long long, vector<int>> known;
+	for (unsigned int i = 0; i < formula.size(); i++)
+	{
+		known[i + 1] = formula[i];
+	}
+
+	//members assigned while checking lemma number epoch are stamped with it, so nothing
+	// has to be cleared between lemmas
+	vector<long long> stamp(num_members + 1, 0);
+	vector<char> truth(num_members + 1, 0);
+
+	bool binary = reader.looksBinary();
+	bool deletion;
+	long long id;
+	vector<int> literals;
+	vector<long long> hints;
+	while (readLine(reader, binary, true, deletion, id, literals, hints))
+	{
+		if (deletion)
+		{
+			for (unsigned int i = 0; i < hints.size(); i++)
+			{
+				known.erase(hints[i]);
+			}
+			continue;
+		}
+
+		long long epoch = ++lemmas;
+		bool conflict = false;
+		for (unsigned int i = 0; i < literals.size(); i++)
+		{
+			int member = abs(literals[i]);
+			if (member >= (int)stamp.size())
+			{
+				stamp.resize(member + 1, 0);
+				truth.resize(member + 1, 0);
+			}
+			//the lemma is assumed false; a member occurring in both polarities makes it a tautology
+			if (stamp[member] == epoch && (truth[member] != 0) == (literals[i] > 0))
+			{
+				conflict = true;
+			}
+			stamp[member] = epoch;
+			truth[member] = literals[i] < 0;
+		}
+
+		for (unsigned int h = 0; h < hints.size() && !conflict; h++)
+		{
+			if (hints[h] < 0)
+			{
+				error = "lemma " + to_string(id) + " uses RAT hints, which are not supported";
+				return false;
+			}
+			unordered_map<long long, vector<int>>::iterator found = known.find(hints[h]);
+			if (found == known.end())
+			{
+				error = "lemma " + to_string(id) + " refers to missing clause " + to_string(hints[h]);
+				return false;
+			}
+
+			const vector<int> &clause = found->second;
+			int unassigned = 0, unit = 0;
+			for (unsigned int i = 0; i < clause.size(); i++)
+			{
+				int member = abs(clause[i]);
+				if (member >= (int)stamp.size() || stamp[member] != epoch)
+				{
+					if (unassigned == 0 || clause[i] != unit)
+					{
+						unassigned++;
+					}
+					unit = clause[i];
+				}
+				else if ((truth[member] != 0) == (clause[i] > 0))
+				{
+					error = "lemma " + to_string(id) + ": hint " + to_string(hints[h]) + " is already satisfied";
+					return false;
+				}
+			}
+			if (unassigned == 0)
+			{
+				conflict = true;
+			}
+			else if (unassigned == 1)
+			{
+				int member = abs(unit);
+				if (member >= (int)stamp.size())
+				{
+					stamp.resize(member + 1, 0);
+					truth.resize(member + 1, 0);
+				}
+				stamp[member] = epoch;
+				truth[member] = unit > 0;
+			}
+			else
+			{
+				error = "lemma " + to_string(id) + ": hint " + to_string(hints[h]) + " is not unit";
+				return false;
+			}
+		}
+		if (!conflict)
+		{
+			error = "lemma " + to_string(id) + " does not follow from its hints";
+			return false;
+		}
+		if (literals.empty())
+		{
+			return true;
+		}
+		known[id] = literals;
+	}
+	if (error.empty())
+	{
+		error = "the proof does not derive the empty clause";
+	}
+	return false;
+}
+
+/// <summary>
+/// Gets the reason the last check failed.
+/// </summary>
+/// <returns></returns>
+string Proof_checker::getError()
+{
+	return error;
+}
+
+/// <summary>
+/// Gets the number of lemmas checked.
+/// </summary>
+/// <returns></returns>
+long long Proof_checker::getLemmaCount()
+{
+	return lemmas;
+}
+
+/***************************************************
+* Proof_checker public functions END
+***************************************************/
+
+/***************************************************
+* Proof_checker private functions START
+***************************************************/
+
+/// <summary>
+/// Reads one proof line.
+/// </summary>
+/// <param name="lrat">true for LRAT lines, which carry an id and hints</param>
+/// <param name="deletion">receives whether the line deletes clauses</param>
+/// <param name="id">receives the id of an LRAT addition</param>
+/// <param name="literals">receives the literals, or the ids of an LRAT deletion</param>
+/// <param name="hints">receives the hints of an LRAT addition</param>
+/// <returns>false at the end of the proof or on a malformed line</returns>
+bool Proof_checker::readLine(Proof_reader &reader, bool binary, bool lrat, bool &deletion, long long &id, vector<int> &literals, vector<long long> &hints)
+{
+	literals.clear();
+	hints.clear();
+	deletion = false;
+	long long number;
+
+	if (binary)
+	{
+		int kind = reader.next();
+		if (kind < 0)
+		{
+			return false;
+		}
+		if (kind != 'a' && kind != 'd')
+		{
+			error = "unexpected byte in binary proof after lemma " + to_string(lemmas);
+			return false;
+		}
+		deletion = kind == 'd';
+		if (lrat && !deletion && !reader.readBinary(id))
+		{
+			error = "binary proof ends inside a line";
+			return false;
+		}
+	}
+	else
+	{
+		reader.skipBlank();
+		if (reader.peek() < 0)
+		{
+			return false;
+		}
+		if (lrat && !reader.readText(id))
+		{
+			error = "malformed proof line after lemma " + to_string(lemmas);
+			return false;
+		}
+		reader.skipBlank();
+		if (reader.peek() == 'd')
+		{
+			reader.next();
+			deletion = true;
+		}
+	}
+
+	//an LRAT deletion lists clause ids; everything else starts with literals
+	bool ids = lrat && deletion;
+	int sections = (lrat && !deletion) ? 2 : 1;
+	for (int section = 0; section < sections; section++)
+	{
+		while (true)
+		{
+			if (!(binary ? reader.readBinary(number) : reader.readText(number)))
+			{
+				error = "proof ends inside a line";
+				return false;
+			}
+			if (number == 0)
+			{
+				break;
+			}
+			if (section == 0 && !ids)
+			{
+				literals.push_back((int)number);
+			}
+			else
+			{
+				hints.push_back(number);
+			}
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// Makes room for members numbered up to member.
+/// </summary>
+void Proof_checker::growMembers(int member)
+{
+	if (member > num_members)
+	{
+		num_members = member;
+		values.resize(num_members, -1);
+		reasons.resize(num_members, -1);
+		watches.resize(2 * num_members);
+	}
+}
+
+/// <summary>
+/// Adds a clause to the DRAT database and propagates any unit it produces at the top level.
+/// </summary>
+void Proof_checker::addClause(const vector<int> &clause)
+{
+	vector<int> literals;
+	for (unsigned int i = 0; i < clause.size(); i++)
+	{
+		if (find(literals.begin(), literals.end(), clause[i]) == literals.end())
+		{
+			literals.push_back(clause[i]);
+		}
+	}
+
+	int index = clauses.size();
+	by_hash[hashClause(literals)].push_back(index);
+	active.push_back(1);
+	clauses.push_back(literals);
+	if (refuted)
+	{
+		return;
+	}
+	if (literals.empty())
+	{
+		refuted = true;
+		return;
+	}
+
+	//put the literals that are not false at the top level first, true ones before unassigned
+	vector<int> &stored = clauses[index];
+	int front = 0;
+	for (int pass = 1; pass >= -1; pass -= 2)
+	{
+		for (unsigned int i = front; i < stored.size(); i++)
+		{
+			if (value(stored[i]) == pass)
+			{
+				swap(stored[i], stored[front++]);
+			}
+		}
+	}
+	if (stored.size() > 1)
+	{
+		watches[slot(stored[0])].push_back(index);
+		watches[slot(stored[1])].push_back(index);
+	}
+
+	if (front == 0)
+	{
+		refuted = true;
+	}
+	else if (front == 1 && value(stored[0]) < 0)
+	{
+		assign(stored[0], index);
+		if (propagate())
+		{
+			refuted = true;
+		}
+	}
+}
+
+/// <summary>
+/// Removes a clause from the DRAT database.  Unit clauses and reasons of top-level
+/// assignments are kept, as their removal would undo propagation already relied upon.
+/// </summary>
+void Proof_checker::deleteClause(vector<int> &clause)
+{
+	sort(clause.begin(), clause.end());
+	clause.erase(unique(clause.begin(), clause.end()), clause.end());
+	if (clause.size() <= 1)
+	{
+		return;
+	}
+
+	unordered_map<unsigned long long, vector<int>>::iterator bucket = by_hash.find(hashClause(clause));
+	if (bucket == by_hash.end())
+	{
+		return;
+	}
+	vector<int> &candidates = bucket->second;
+	for (unsigned int i = 0; i < candidates.size(); i++)
+	{
+		vector<int> stored = clauses[candidates[i]];
+		sort(stored.begin(), stored.end());
+		if (stored != clause)
+		{
+			continue;
+		}
+		const vector<int> &original = clauses[candidates[i]];
+		if (reasons[abs(original[0]) - 1] == candidates[i] && value(original[0]) == 1)
+		{
+			return;
+		}
+		active[candidates[i]] = 0;
+		candidates.erase(candidates.begin() + i);
+		return;
+	}
+}
+
+/// <summary>
+/// Checks that a clause follows by unit propagation from the database.
+/// </summary>
+bool Proof_checker::isRUP(const vector<int> &clause)
+{
+	if (refuted)
+	{
+		return true;
+	}
+
+	unsigned int saved = trail.size();
+	bool conflict = false;
+	for (unsigned int i = 0; i < clause.size() && !conflict; i++)
+	{
+		int v = value(clause[i]);
+		if (v == 1)
+		{
+			//true at the top level, or the clause is a tautology
+			conflict = true;
+		}
+		else if (v < 0)
+		{
+			assign(-clause[i], -1);
+		}
+	}
+	if (!conflict)
+	{
+		conflict = propagate();
+	}
+
+	for (unsigned int i = saved; i < trail.size(); i++)
+	{
+		values[abs(trail[i]) - 1] = -1;
+		reasons[abs(trail[i]) - 1] = -1;
+	}
+	trail.resize(saved);
+	qhead = saved;
+	return conflict;
+}
+
+/// <summary>
+/// Checks that every resolvent of a clause on its first literal follows by unit propagation.
+/// </summary>
+bool Proof_checker::isRAT(const vector<int> &clause)
+{
+	if (clause.empty())
+	{
+		return false;
+	}
+	int pivot = clause[0];
+	for (unsigned int c = 0; c < clauses.size(); c++)
+	{
+		const vector<int> &other = clauses[c];
+		if (!active[c] || find(other.begin(), other.end(), -pivot) == other.end())
+		{
+			continue;
+		}
+
+		vector<int> resolvent = clause;
+		bool tautology = false;
+		for (unsigned int i = 0; i < other.size() && !tautology; i++)
+		{
+			if (other[i] == -pivot)
+			{
+				continue;
+			}
+			if (find(clause.begin(), clause.end(), -other[i]) != clause.end())
+			{
+				tautology = true;
+			}
+			resolvent.push_back(other[i]);
+		}
+		if (!tautology && !isRUP(resolvent))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// Sets a literal true with the given reason clause.
+/// </summary>
+void Proof_checker::assign(int literal, int reason)
+{
+	int member = abs(literal) - 1;
+	values[member] = (literal > 0) ? 1 : 0;
+	reasons[member] = reason;
+	trail.push_back(literal);
+}
+
+/// <summary>
+/// Propagates the queued assignments through the watched literals.
+/// </summary>
+/// <returns>true if a clause was falsified</returns>
+bool Proof_checker::propagate()
+{
+	while (qhead < trail.size())
+	{
+		int falseLiteral = -trail[qhead++];
+		vector<int> &watchList = watches[slot(falseLiteral)];
+		unsigned int i = 0, j = 0;
+		while (i < watchList.size())
+		{
+			int c = watchList[i++];
+			//deleted clauses leave their watch lists as they are met
+			if (!active[c])
+			{
+				continue;
+			}
+			vector<int> &clause = clauses[c];
+			if (clause[0] == falseLiteral)
+			{
+				clause[0] = clause[1];
+				clause[1] = falseLiteral;
+			}
+			if (value(clause[0]) == 1)
+			{
+				watchList[j++] = c;
+				continue;
+			}
+
+			bool moved = false;
+			for (unsigned int k = 2; k < clause.size(); k++)
+			{
+				if (value(clause[k]) != 0)
+				{
+					clause[1] = clause[k];
+					clause[k] = falseLiteral;
+					watches[slot(clause[1])].push_back(c);
+					moved = true;
+					break;
+				}
+			}
+			if (moved)
+			{
+				continue;
+			}
+
+			watchList[j++] = c;
+			if (value(clause[0]) == 0)
+			{
+				while (i < watchList.size())
+				{
+					watchList[j++] = watchList[i++];
+				}
+				watchList.resize(j);
+				qhead = trail.size();
+				return true;
+			}
+			assign(clause[0], c);
+		}
+		watchList.resize(j);
+	}
+	return false;
+}
+
+/// <summary>
+/// Gets the value of a literal: 1 true, 0 false, -1 unassigned.
+/// </summary>
+int Proof_checker::value(int literal)
+{
+	signed char v = values[abs(literal) - 1];
+	if (v < 0)
+	{
+		return -1;
+	}
+	return (literal > 0) ? v : 1 - v;
+}
+
+/// <summary>
+/// Maps a literal onto its position in the watch lists.
+/// </summary>
+int Proof_checker::slot(int literal)
+{
+	return literal > 0 ? 2 * (literal - 1) : 2 * (-literal - 1) + 1;
+}
+
+/// <summary>
+/// Hashes a clause independently of the order of its literals.
+/// </summary>
+unsigned long long Proof_checker::hashClause(const vector<int> &clause)
+{
+	//sum and product of per-literal mixes are both order independent
+	unsigned long long sum = 0, product = 1;
+	for (unsigned int i = 0; i < clause.size(); i++)
+	{
+		unsigned long long mixed = (unsigned long long)(long long)clause[i] * 0x9E3779B97F4A7C15ULL;
+		mixed ^= mixed >> 29;
+		sum += mixed;
+		product *= mixed | 1;
+	}
+	return sum ^ (product << 1) ^ clause.size();
+}
+
+/***************************************************
+* Proof_checker private functions END
+***************************************************/
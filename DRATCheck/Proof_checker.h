@@ -0,0 +1,197 @@
+#pragma once
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+/// <summary>
+/// Buffered reader for cnf and proof files, in text or in the binary DRAT encoding.
+/// </summary>
+class Proof_reader
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inFile">file opened for binary reading</param>
+	Proof_reader(FILE *inFile);
+
+	/// <summary>
+	/// Gets the next byte without consuming it.
+	/// </summary>
+	/// <returns>the byte, or -1 at the end of the file</returns>
+	int peek();
+
+	/// <summary>
+	/// Consumes and returns the next byte.
+	/// </summary>
+	/// <returns>the byte, or -1 at the end of the file</returns>
+	int next();
+
+	/// <summary>
+	/// Skips whitespace and comment lines starting with 'c'.
+	/// </summary>
+	void skipBlank();
+
+	/// <summary>
+	/// Reads a signed decimal number after skipping blanks.
+	/// </summary>
+	/// <param name="value">receives the number</param>
+	/// <returns>false if no number follows</returns>
+	bool readText(long long &value);
+
+	/// <summary>
+	/// Reads a number in the binary DRAT encoding.
+	/// </summary>
+	/// <param name="value">receives the number</param>
+	/// <returns>false at the end of the file</returns>
+	bool readBinary(long long &value);
+
+	/// <summary>
+	/// Determines whether the unread data is in a binary encoding.  Binary proofs end every
+	/// line with a zero byte, which never appears in text.
+	/// </summary>
+	/// <returns>true if a zero or non-ASCII byte appears within the first buffer</returns>
+	bool looksBinary();
+
+private:
+
+	/// <summary>
+	/// Refills the buffer from the file.
+	/// </summary>
+	void fill();
+
+	FILE *file;
+	vector<unsigned char> buffer;
+	size_t position, length;
+};
+
+/// <summary>
+/// Checks clausal refutation proofs against a cnf formula.
+/// DRAT proofs are checked forwards: every lemma must follow by unit propagation (RUP) from the
+/// formula and the earlier lemmas, or else have the resolution asymmetric tautology property on
+/// its first literal (RAT).  LRAT proofs are checked by replaying their hints, which needs no search.
+/// Both succeed only once the empty clause has been derived.
+/// </summary>
+class Proof_checker
+{
+public:
+
+	/// <summary>
+	/// Default constructor.
+	/// </summary>
+	Proof_checker();
+
+	/// <summary>
+	/// Reads the formula to be refuted.
+	/// </summary>
+	/// <param name="reader">reader positioned at the start of a cnf file</param>
+	/// <returns>false if the file is not a cnf formula</returns>
+	bool loadFormula(Proof_reader &reader);
+
+	/// <summary>
+	/// Checks a DRAT proof, in text or binary form.
+	/// </summary>
+	/// <param name="reader">reader positioned at the start of the proof</param>
+	/// <returns>true if the proof refutes the formula</returns>
+	bool checkDRAT(Proof_reader &reader);
+
+	/// <summary>
+	/// Checks an LRAT proof, in text or binary form.
+	/// </summary>
+	/// <param name="reader">reader positioned at the start of the proof</param>
+	/// <returns>true if the proof refutes the formula</returns>
+	bool checkLRAT(Proof_reader &reader);
+
+	/// <summary>
+	/// Gets the reason the last check failed.
+	/// </summary>
+	/// <returns></returns>
+	string getError();
+
+	/// <summary>
+	/// Gets the number of lemmas checked.
+	/// </summary>
+	/// <returns></returns>
+	long long getLemmaCount();
+
+private:
+
+	/// <summary>
+	/// Reads one proof line.
+	/// </summary>
+	/// <param name="lrat">true for LRAT lines, which carry an id and hints</param>
+	/// <param name="deletion">receives whether the line deletes clauses</param>
+	/// <param name="id">receives the id of an LRAT addition</param>
+	/// <param name="literals">receives the literals, or the ids of an LRAT deletion</param>
+	/// <param name="hints">receives the hints of an LRAT addition</param>
+	/// <returns>false at the end of the proof or on a malformed line</returns>
+	bool readLine(Proof_reader &reader, bool binary, bool lrat, bool &deletion, long long &id, vector<int> &literals, vector<long long> &hints);
+
+	/// <summary>
+	/// Makes room for members numbered up to member.
+	/// </summary>
+	void growMembers(int member);
+
+	/// <summary>
+	/// Adds a clause to the DRAT database and propagates any unit it produces at the top level.
+	/// </summary>
+	void addClause(const vector<int> &clause);
+
+	/// <summary>
+	/// Removes a clause from the DRAT database.  Unit clauses and reasons of top-level
+	/// assignments are kept, as their removal would undo propagation already relied upon.
+	/// </summary>
+	void deleteClause(vector<int> &clause);
+
+	/// <summary>
+	/// Checks that a clause follows by unit propagation from the database.
+	/// </summary>
+	bool isRUP(const vector<int> &clause);
+
+	/// <summary>
+	/// Checks that every resolvent of a clause on its first literal follows by unit propagation.
+	/// </summary>
+	bool isRAT(const vector<int> &clause);
+
+	/// <summary>
+	/// Sets a literal true with the given reason clause.
+	/// </summary>
+	void assign(int literal, int reason);
+
+	/// <summary>
+	/// Propagates the queued assignments through the watched literals.
+	/// </summary>
+	/// <returns>true if a clause was falsified</returns>
+	bool propagate();
+
+	/// <summary>
+	/// Gets the value of a literal: 1 true, 0 false, -1 unassigned.
+	/// </summary>
+	int value(int literal);
+
+	/// <summary>
+	/// Maps a literal onto its position in the watch lists.
+	/// </summary>
+	int slot(int literal);
+
+	/// <summary>
+	/// Hashes a clause independently of the order of its literals.
+	/// </summary>
+	unsigned long long hashClause(const vector<int> &clause);
+
+	int num_members;
+	vector<vector<int>> formula; //clauses as read from the cnf file
+	vector<vector<int>> clauses; //DRAT database
+	vector<char> active;
+	vector<vector<int>> watches;
+	unordered_map<unsigned long long, vector<int>> by_hash;
+	vector<signed char> values;
+	vector<int> reasons, trail;
+	unsigned int qhead;
+	bool refuted; //true once the top level is inconsistent
+	long long lemmas;
+	string error;
+};
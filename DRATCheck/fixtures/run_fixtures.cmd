@@ -0,0 +1,35 @@
+@echo off
+rem Runs DRATCheck on the fixtures beside this script and compares every exit code with the
+rem expected one: 0 for a proof that must be verified, 1 for one that must be rejected.
+rem Usage: run_fixtures.cmd <path to DRATCheck.exe>
+setlocal
+if "%~1"=="" (
+	echo Usage: run_fixtures.cmd ^<path to DRATCheck.exe^>
+	exit /b 2
+)
+set CHECK=%~1
+set DIR=%~dp0
+set FAILED=0
+
+call :expect 0 "%DIR%unsat.cnf" "%DIR%valid.drat"
+call :expect 0 "%DIR%unsat.cnf" "%DIR%valid_binary.drat"
+call :expect 1 "%DIR%unsat.cnf" "%DIR%corrupt.drat"
+call :expect 0 --lrat "%DIR%unsat.cnf" "%DIR%valid.lrat"
+call :expect 1 --lrat "%DIR%unsat.cnf" "%DIR%corrupt.lrat"
+
+if %FAILED%==0 echo All fixtures gave the expected result.
+exit /b %FAILED%
+
+rem Runs the checker on the arguments after the first and compares its exit code with the first.
+:expect
+set WANT=%1
+shift
+"%CHECK%" %1 %2 %3 >nul
+set GOT=%ERRORLEVEL%
+if "%GOT%"=="%WANT%" (
+	echo ok: %~nx1 %~nx2 %~nx3
+) else (
+	echo FAILED: %~nx1 %~nx2 %~nx3 exited with %GOT%, expected %WANT%
+	set FAILED=1
+)
+exit /b 0
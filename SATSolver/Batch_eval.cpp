@@ -0,0 +1,281 @@
+#include "stdafx.h"
+#include "Batch_eval.h"
+
+/***************************************************
+* Batch_eval functions START
+***************************************************/
+
+/// <summary>
+/// Constructor; starts with an empty formula.
+/// </summary>
+Batch_eval::Batch_eval()
+{
+	numMembers = 0;
+	starts.push_back(0);
+}
+
+/// <summary>
+/// Constructor taking the clauses of a formula.
+/// </summary>
+/// <param name="formula">formula whose clauses are scored</param>
+Batch_eval::Batch_eval(SAT_puzzle &formula)
+{
+	numMembers = formula.getNumMembers();
+	starts.push_back(0);
+	vector<int> clause_literals;
+	for (int i = 0; i < formula.getNumClauses(); i++)
+	{
+		const vector<int> &clause = formula.getClause(i);
+		clause_literals.clear();
+		for (unsigned int j = 0; j < clause.size() && clause[j] != 0; j++)
+		{
+			clause_literals.push_back(clause[j]);
+		}
+		addClause(clause_literals);
+	}
+}
+
+/// <summary>
+/// Appends a clause, adding members when it names ones the formula does not have yet.
+/// </summary>
+/// <param name="clause">literals of the clause, numbered as in the file, without the terminating 0</param>
+void Batch_eval::addClause(const vector<int> &clause)
+{
+	int first = starts.back();
+	for (unsigned int i = 0; i < clause.size(); i++)
+	{
+		int member = abs(clause[i]) - 1;
+		int literal = 2 * member + (clause[i] < 0 ? 1 : 0);
+		bool repeated = false;
+		for (int j = first; j < (int)literals.size() && !repeated; j++)
+		{
+			repeated = literals[j] == literal;
+		}
+		if (!repeated)
+		{
+			literals.push_back(literal);
+		}
+		if (member >= numMembers)
+		{
+			numMembers = member + 1;
+		}
+	}
+	starts.push_back((int)literals.size());
+}
+
+/// <summary>
+/// Raises the number of members, widening the packed candidates without adding clauses.
+/// </summary>
+/// <param name="inNumMembers">new number of members, ignored if not above the current one</param>
+void Batch_eval::addMembers(int inNumMembers)
+{
+	if (inNumMembers > numMembers)
+	{
+		numMembers = inNumMembers;
+	}
+}
+
+/// <summary>
+/// Scores a batch of candidates.
+/// </summary>
+/// <param name="assignments">count packed candidates, one after another</param>
+/// <param name="count">number of candidates</param>
+/// <param name="satisfied">receives the number of clauses each candidate satisfies</param>
+/// <param name="falsified">if not nullptr, receives the indices of the clauses each candidate falsifies</param>
+void Batch_eval::evaluate(const unsigned long long *assignments, int count, int *satisfied, vector<vector<int>> *falsified)
+{
+	int numBlocks = (count + 63) / 64;
+	if (falsified != nullptr)
+	{
+		falsified->assign(count, vector<int>());
+	}
+	//a single block cannot be shared out, so it is scored here like any small batch
+	if (numBlocks == 1 || (long long)numBlocks * ((long long)literals.size() + numMembers) < PARALLEL_WORK)
+	{
+		evaluateBlocks(0, numBlocks, assignments, count, satisfied, falsified, slices, counters);
+		return;
+	}
+
+	//several chunks per core, so idle threads can steal work
+	int numTasks = Environment::ProcessorCount * 4;
+	int blocksPerChunk = (numBlocks + numTasks - 1) / numTasks;
+	Batch_chunks^ chunks = gcnew Batch_chunks(this, assignments, count, satisfied, falsified, blocksPerChunk);
+	Parallel::For(0, chunks->getNumChunks(), gcnew Action<int>(chunks, &Batch_chunks::evaluateChunk));
+}
+
+/// <summary>
+/// Scores the candidate blocks in the range [first, last); blocks hold 64 candidates.
+/// Called for each chunk of a batch, possibly on several threads at once, each with scratch
+/// space of its own.
+/// </summary>
+/// <param name="slices">scratch space for the transposed candidates</param>
+/// <param name="counters">scratch space for the bit-sliced counters</param>
+void Batch_eval::evaluateBlocks(int first, int last, const unsigned long long *assignments, int count, int *satisfied, vector<vector<int>> *falsified,
+	vector<unsigned long long> &slices, vector<unsigned long long> &counters)
+{
+	int words = getWordsPerAssignment();
+	int numClauses = getNumClauses();
+	int counterBits = 1;
+	while ((1 << counterBits) <= numClauses)
+	{
+		counterBits++;
+	}
+
+	//slices[2 * m] holds member m across the block's candidates, slices[2 * m + 1] its negation
+	slices.resize(2 * (words * 64));
+	counters.resize(counterBits);
+	unsigned long long rows[64];
+
+	for (int block = first; block < last; block++)
+	{
+		int base = block * 64;
+		int lanes = count - base < 64 ? count - base : 64;
+		unsigned long long laneMask = lanes == 64 ? ~0ULL : (1ULL << lanes) - 1;
+
+		for (int w = 0; w < words; w++)
+		{
+			for (int j = 0; j < 64; j++)
+			{
+				rows[j] = j < lanes ? assignments[(long long)(base + j) * words + w] : 0;
+			}
+			transpose(rows);
+			for (int b = 0; b < 64; b++)
+			{
+				slices[2 * (w * 64 + b)] = rows[b];
+				slices[2 * (w * 64 + b) + 1] = ~rows[b];
+			}
+		}
+
+		//each clause word is added into the bit-sliced counters with a ripple carry, which
+		// rarely travels past the lowest bits
+		for (int k = 0; k < counterBits; k++)
+		{
+			counters[k] = 0;
+		}
+		for (int c = 0; c < numClauses; c++)
+		{
+			unsigned long long word = 0;
+			for (int l = starts[c]; l < starts[c + 1]; l++)
+			{
+				word |= slices[literals[l]];
+			}
+			word &= laneMask;
+
+			unsigned long long carry = word;
+			for (int k = 0; k < counterBits && carry != 0; k++)
+			{
+				unsigned long long next = counters[k] & carry;
+				counters[k] ^= carry;
+				carry = next;
+			}
+
+			if (falsified != nullptr)
+			{
+				unsigned long long missed = ~word & laneMask;
+				while (missed != 0)
+				{
+					int lane = 0;
+					while (((missed >> lane) & 1) == 0)
+					{
+						lane++;
+					}
+					(*falsified)[base + lane].push_back(c);
+					missed &= missed - 1;
+				}
+			}
+		}
+
+		for (int j = 0; j < lanes; j++)
+		{
+			int total = 0;
+			for (int k = 0; k < counterBits; k++)
+			{
+				total |= (int)((counters[k] >> j) & 1) << k;
+			}
+			satisfied[base + j] = total;
+		}
+	}
+}
+
+/// <summary>
+/// Gets the number of 64-bit words each packed candidate takes.
+/// </summary>
+/// <returns></returns>
+int Batch_eval::getWordsPerAssignment()
+{
+	return (numMembers + 63) / 64;
+}
+
+/// <summary>
+/// Get the number of clauses in the formula.
+/// </summary>
+/// <returns></returns>
+int Batch_eval::getNumClauses()
+{
+	return (int)starts.size() - 1;
+}
+
+/// <summary>
+/// Transposes a 64 x 64 bit matrix held one row per word, so bit j of row i moves to bit i of row j.
+/// Blocks are swapped recursively in place: 32 x 32 quarters first, down to single bits.
+/// </summary>
+void Batch_eval::transpose(unsigned long long rows[64])
+{
+	unsigned long long mask = 0x00000000FFFFFFFFULL;
+	for (int width = 32; width != 0; width >>= 1, mask ^= mask << width)
+	{
+		for (int k = 0; k < 64; k = ((k | width) + 1) & ~width)
+		{
+			unsigned long long swapped = ((rows[k] >> width) ^ rows[k | width]) & mask;
+			rows[k] ^= swapped << width;
+			rows[k | width] ^= swapped;
+		}
+	}
+}
+
+/***************************************************
+* Batch_eval functions END
+***************************************************/
+
+/***************************************************
+* Batch_chunks functions START
+***************************************************/
+
+/// <summary>
+/// Constructor.
+/// </summary>
+Batch_chunks::Batch_chunks(Batch_eval *inEval, const unsigned long long *inAssignments, int inCount, int *inSatisfied, vector<vector<int>> *inFalsified, int inBlocksPerChunk)
+{
+	eval = inEval;
+	assignments = inAssignments;
+	count = inCount;
+	satisfied = inSatisfied;
+	falsified = inFalsified;
+	numBlocks = (count + 63) / 64;
+	blocksPerChunk = inBlocksPerChunk > 0 ? inBlocksPerChunk : 1;
+}
+
+/// <summary>
+/// Scores the candidate blocks of one chunk.
+/// </summary>
+/// <param name="chunk">index of the chunk</param>
+void Batch_chunks::evaluateChunk(int chunk)
+{
+	int first = chunk * blocksPerChunk;
+	int last = Math::Min(first + blocksPerChunk, numBlocks);
+	vector<unsigned long long> slices, counters;
+	eval->evaluateBlocks(first, last, assignments, count, satisfied, falsified, slices, counters);
+}
+
+/// <summary>
+/// Gets the number of chunks the batch was split into.
+/// </summary>
+/// <returns></returns>
+int Batch_chunks::getNumChunks()
+{
+	return (numBlocks + blocksPerChunk - 1) / blocksPerChunk;
+}
+
+/***************************************************
+* Batch_chunks functions END
+***************************************************/
@@ -0,0 +1,123 @@
+#pragma once
+#include <vector>
+#include "SAT_puzzle.h"
+using namespace std;
+using namespace System;
+using namespace System::Threading::Tasks;
+
+/// <summary>
+/// Scores many candidate assignments against one formula.  Candidates are packed: each takes
+/// getWordsPerAssignment() 64-bit words, bit i of word k holding member 64 * k + i.
+/// They are evaluated bit-sliced, 64 at a time: each block of candidates is transposed so that a
+/// word holds one member across the 64 candidates, a clause is then a handful of ORs, and the
+/// satisfied counts are summed in bit-sliced counters.  Large batches are split across threads,
+/// which share the clause data read-only.
+/// </summary>
+class Batch_eval
+{
+public:
+
+	/// <summary>
+	/// Batches with fewer clause literals times candidate blocks than this are scored on the calling thread.
+	/// </summary>
+	static const int PARALLEL_WORK = 1 << 16;
+
+	/// <summary>
+	/// Constructor; starts with an empty formula.
+	/// </summary>
+	Batch_eval();
+
+	/// <summary>
+	/// Constructor taking the clauses of a formula.
+	/// </summary>
+	/// <param name="formula">formula whose clauses are scored</param>
+	Batch_eval(SAT_puzzle &formula);
+
+	/// <summary>
+	/// Appends a clause, adding members when it names ones the formula does not have yet.
+	/// </summary>
+	/// <param name="clause">literals of the clause, numbered as in the file, without the terminating 0</param>
+	void addClause(const vector<int> &clause);
+
+	/// <summary>
+	/// Raises the number of members, widening the packed candidates without adding clauses.
+	/// </summary>
+	/// <param name="inNumMembers">new number of members, ignored if not above the current one</param>
+	void addMembers(int inNumMembers);
+
+	/// <summary>
+	/// Scores a batch of candidates.
+	/// </summary>
+	/// <param name="assignments">count packed candidates, one after another</param>
+	/// <param name="count">number of candidates</param>
+	/// <param name="satisfied">receives the number of clauses each candidate satisfies</param>
+	/// <param name="falsified">if not nullptr, receives the indices of the clauses each candidate falsifies</param>
+	void evaluate(const unsigned long long *assignments, int count, int *satisfied, vector<vector<int>> *falsified);
+
+	/// <summary>
+	/// Scores the candidate blocks in the range [first, last); blocks hold 64 candidates.
+	/// Called for each chunk of a batch, possibly on several threads at once, each with scratch
+	/// space of its own.
+	/// </summary>
+	/// <param name="slices">scratch space for the transposed candidates</param>
+	/// <param name="counters">scratch space for the bit-sliced counters</param>
+	void evaluateBlocks(int first, int last, const unsigned long long *assignments, int count, int *satisfied, vector<vector<int>> *falsified,
+		vector<unsigned long long> &slices, vector<unsigned long long> &counters);
+
+	/// <summary>
+	/// Gets the number of 64-bit words each packed candidate takes.
+	/// </summary>
+	/// <returns></returns>
+	int getWordsPerAssignment();
+
+	/// <summary>
+	/// Get the number of clauses in the formula.
+	/// </summary>
+	/// <returns></returns>
+	int getNumClauses();
+
+private:
+
+	/// <summary>
+	/// Transposes a 64 x 64 bit matrix held one row per word, so bit j of row i moves to bit i of row j.
+	/// </summary>
+	static void transpose(unsigned long long rows[64]);
+
+	int numMembers;
+	vector<int> starts; //where each clause's literals begin, plus one entry past the last clause
+	vector<int> literals; //2 * member for a member, 2 * member + 1 for its negation, repeats removed
+	//scratch space of batches scored on the calling thread, kept so repeated small batches do not allocate
+	vector<unsigned long long> slices, counters;
+};
+
+/// <summary>
+/// One batch split into chunks of candidate blocks for the .NET work-stealing thread pool.
+/// </summary>
+ref class Batch_chunks
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	Batch_chunks(Batch_eval *inEval, const unsigned long long *inAssignments, int inCount, int *inSatisfied, vector<vector<int>> *inFalsified, int inBlocksPerChunk);
+
+	/// <summary>
+	/// Scores the candidate blocks of one chunk.
+	/// </summary>
+	/// <param name="chunk">index of the chunk</param>
+	void evaluateChunk(int chunk);
+
+	/// <summary>
+	/// Gets the number of chunks the batch was split into.
+	/// </summary>
+	/// <returns></returns>
+	int getNumChunks();
+
+private:
+	Batch_eval *eval;
+	const unsigned long long *assignments;
+	int count, numBlocks, blocksPerChunk;
+	int *satisfied;
+	vector<vector<int>> *falsified;
+};
@@ -0,0 +1,327 @@
+#include "stdafx.h"
+#include "Batch_runner.h"
+#include "Solver_server.h"
+#include "DPLL.h"
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inPath">file to be solved</param>
+/// <param name="inReserved">bytes of the memory budget held for the parsed formula</param>
+Batch_instance::Batch_instance(String^ inPath, long long inReserved)
+{
+	path = inPath;
+	formula = NULL;
+	loaded = false;
+	reserved = inReserved;
+	parseTime = 0;
+	solveTime = 0;
+}
+
+/// <summary>
+/// Destructor; releases the parsed formula.
+/// </summary>
+Batch_instance::~Batch_instance()
+{
+	this->!Batch_instance();
+}
+
+/// <summary>
+/// Finalizer; releases the parsed formula if the instance was never disposed.
+/// </summary>
+Batch_instance::!Batch_instance()
+{
+	delete formula;
+	formula = NULL;
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inDirectory">directory holding the formulas</param>
+/// <param name="inSolver">paws, saps, maxsat, dpll or exhaustive</param>
+/// <param name="inBudget">time budget of each search in milliseconds</param>
+/// <param name="inMemoryBudget">bytes parsed formulas may take up at once</param>
+/// <param name="inSeed">random seed of every search; a negative seed draws from the clock</param>
+Batch_runner::Batch_runner(String^ inDirectory, String^ inSolver, int inBudget, long long inMemoryBudget, int inSeed)
+{
+	directory = inDirectory;
+	solver = inSolver;
+	budget = inBudget;
+	memoryBudget = inMemoryBudget;
+	seed = inSeed;
+	gate = gcnew Object();
+}
+
+/// <summary>
+/// Solves the batch, printing each result as soon as those of the earlier files are out.
+/// </summary>
+/// <returns>process exit code</returns>
+int Batch_runner::run()
+{
+	if (solver != "paws" && solver != "saps" && solver != "maxsat" && solver != "dpll" && solver != "exhaustive")
+	{
+		Console::WriteLine("Batches are solved by paws, saps, maxsat, dpll or exhaustive.");
+		return 1;
+	}
+
+	List<String^>^ found = gcnew List<String^>();
+	try
+	{
+		for each (String^ path in Directory::GetFiles(directory))
+		{
+			String^ extension = Path::GetExtension(path)->ToLowerInvariant();
+			if (extension == ".cnf" || extension == ".wcnf")
+			{
+				found->Add(path);
+			}
+		}
+	}
+	catch (Exception^ list_error)
+	{
+		Console::WriteLine("Directory " + directory + " could not be read: " + list_error->Message);
+		return 1;
+	}
+	found->Sort(StringComparer::Ordinal);
+	files = found->ToArray();
+	estimates = gcnew array<long long>(files->Length);
+	for (int i = 0; i < files->Length; i++)
+	{
+		//a file that cannot be sized will fail to parse too, so it is charged nothing
+		try
+		{
+			estimates[i] = (gcnew FileInfo(files[i]))->Length * MEMORY_FACTOR;
+		}
+		catch (Exception^ size_error)
+		{
+			estimates[i] = 0;
+		}
+	}
+	instances = gcnew array<Batch_instance^>(files->Length);
+	nextLoad = nextSolve = nextPrint = 0;
+	memoryUsed = parseTotal = solveTotal = 0;
+
+	//the searches are single-threaded, so the cores not parsing each run one
+	int loaders = Math::Max(1, Environment::ProcessorCount / 4);
+	int solvers = Math::Max(1, Environment::ProcessorCount - loaders);
+	Console::WriteLine("c " + files->Length.ToString() + " formulas, " + loaders.ToString() + " loader and "
+		+ solvers.ToString() + " solver threads");
+
+	Stopwatch ^ timeKeep = gcnew Stopwatch();
+	timeKeep->Start();
+	List<Thread^>^ threads = gcnew List<Thread^>();
+	for (int i = 0; i < loaders; i++)
+	{
+		threads->Add(gcnew Thread(gcnew ThreadStart(this, &Batch_runner::loadInstances)));
+	}
+	for (int i = 0; i < solvers; i++)
+	{
+		threads->Add(gcnew Thread(gcnew ThreadStart(this, &Batch_runner::solveInstances)));
+	}
+	for each (Thread^ thread in threads)
+	{
+		thread->Start();
+	}
+	for each (Thread^ thread in threads)
+	{
+		thread->Join();
+	}
+	timeKeep->Stop();
+
+	Console::WriteLine("c milliseconds elapsed: " + timeKeep->ElapsedMilliseconds.ToString());
+	Console::WriteLine("c milliseconds parsing: " + parseTotal.ToString() + ", searching: " + solveTotal.ToString());
+	return 0;
+}
+
+/// <summary>
+/// Loader thread: parses claimed files until none are left.
+/// </summary>
+void Batch_runner::loadInstances()
+{
+	Batch_instance^ instance = claimLoad();
+	while (instance != nullptr)
+	{
+		Stopwatch ^ timeKeep = gcnew Stopwatch();
+		timeKeep->Start();
+		SAT_puzzle *parsed = NULL;
+		String^ problem = nullptr;
+		try
+		{
+			parsed = new SAT_puzzle(instance->path);
+		}
+		catch (Exception^ parse_error)
+		{
+			problem = parse_error->Message;
+		}
+		catch (String^ parse_error)
+		{
+			problem = parse_error;
+		}
+		timeKeep->Stop();
+
+		Monitor::Enter(gate);
+		try
+		{
+			instance->formula = parsed;
+			instance->error = problem;
+			instance->parseTime = timeKeep->ElapsedMilliseconds;
+			instance->loaded = true;
+			parseTotal += instance->parseTime;
+			//a file that failed to parse holds no formula, so its share of the budget is free again
+			if (parsed == NULL)
+			{
+				memoryUsed -= instance->reserved;
+				instance->reserved = 0;
+			}
+			Monitor::PulseAll(gate);
+		}
+		finally
+		{
+			Monitor::Exit(gate);
+		}
+		instance = claimLoad();
+	}
+}
+
+/// <summary>
+/// Solver thread: solves parsed formulas in file order until none are left.
+/// </summary>
+void Batch_runner::solveInstances()
+{
+	Batch_instance^ instance = claimSolve();
+	while (instance != nullptr)
+	{
+		String^ name = Path::GetFileName(instance->path);
+		String^ report;
+		if (instance->error != nullptr)
+		{
+			report = name + " ERROR " + instance->error;
+		}
+		else
+		{
+			Stopwatch ^ timeKeep = gcnew Stopwatch();
+			timeKeep->Start();
+			try
+			{
+				long long cost = -1;
+				vector<bool> model;
+				//concurrent searches stay quiet; each file's cost is on its result line
+				int result = Solver_server::solve(solver, budget, seed, *instance->formula, cost, model, nullptr);
+				String^ status = "UNKNOWN";
+				if (result == -1)
+				{
+					status = "SATISFIABLE";
+				}
+				else if (result == DPLL::UNSATISFIABLE)
+				{
+					status = "UNSATISFIABLE";
+				}
+				report = name + " " + status;
+				if (cost >= 0)
+				{
+					report += " cost " + cost.ToString();
+				}
+			}
+			catch (Exception^ solve_error)
+			{
+				report = name + " ERROR " + solve_error->Message;
+			}
+			timeKeep->Stop();
+			instance->solveTime = timeKeep->ElapsedMilliseconds;
+			report += " (parsed in " + instance->parseTime.ToString() + " ms, searched in "
+				+ instance->solveTime.ToString() + " ms)";
+		}
+		finish(instance, report);
+		instance = claimSolve();
+	}
+}
+
+/// <summary>
+/// Claims the next file to parse, first waiting until its estimated size fits in the memory budget.
+/// </summary>
+/// <returns>the claimed instance, or nullptr when every file has been claimed</returns>
+Batch_instance^ Batch_runner::claimLoad()
+{
+	Monitor::Enter(gate);
+	try
+	{
+		//Files are claimed and charged in order, so everything holding memory comes before the
+		// file waited for and will be solved and released; the wait cannot deadlock.
+		while (nextLoad < files->Length && memoryUsed > 0 && memoryUsed + estimates[nextLoad] > memoryBudget)
+		{
+			Monitor::Wait(gate);
+		}
+		if (nextLoad == files->Length)
+		{
+			return nullptr;
+		}
+		Batch_instance^ instance = gcnew Batch_instance(files[nextLoad], estimates[nextLoad]);
+		instances[nextLoad] = instance;
+		memoryUsed += instance->reserved;
+		nextLoad++;
+		Monitor::PulseAll(gate);
+		return instance;
+	}
+	finally
+	{
+		Monitor::Exit(gate);
+	}
+}
+
+/// <summary>
+/// Claims the next file to solve and waits for its parse to finish.
+/// </summary>
+/// <returns>the parsed instance, or nullptr when every file has been claimed</returns>
+Batch_instance^ Batch_runner::claimSolve()
+{
+	Monitor::Enter(gate);
+	try
+	{
+		if (nextSolve == files->Length)
+		{
+			return nullptr;
+		}
+		int index = nextSolve++;
+		while (instances[index] == nullptr || !instances[index]->loaded)
+		{
+			Monitor::Wait(gate);
+		}
+		return instances[index];
+	}
+	finally
+	{
+		Monitor::Exit(gate);
+	}
+}
+
+/// <summary>
+/// Releases an instance's formula and memory budget, then prints every result that is now
+/// next in file order.
+/// </summary>
+/// <param name="instance">instance that has been solved</param>
+/// <param name="report">result line of the instance</param>
+void Batch_runner::finish(Batch_instance^ instance, String^ report)
+{
+	delete instance->formula;
+	instance->formula = NULL;
+
+	Monitor::Enter(gate);
+	try
+	{
+		memoryUsed -= instance->reserved;
+		instance->reserved = 0;
+		instance->report = report;
+		solveTotal += instance->solveTime;
+		while (nextPrint < files->Length && instances[nextPrint] != nullptr && instances[nextPrint]->report != nullptr)
+		{
+			Console::WriteLine(instances[nextPrint]->report);
+			instances[nextPrint] = nullptr;
+			nextPrint++;
+		}
+		Monitor::PulseAll(gate);
+	}
+	finally
+	{
+		Monitor::Exit(gate);
+	}
+}
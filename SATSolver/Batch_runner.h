@@ -0,0 +1,129 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SAT_puzzle.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+using namespace System::Threading;
+using namespace System::Diagnostics;
+using namespace System::Collections::Generic;
+
+/// <summary>
+/// One file of a batch, from the moment a loader claims it until its result is printed.
+/// </summary>
+ref class Batch_instance
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inPath">file to be solved</param>
+	/// <param name="inReserved">bytes of the memory budget held for the parsed formula</param>
+	Batch_instance(String^ inPath, long long inReserved);
+
+	/// <summary>
+	/// Destructor; releases the parsed formula.
+	/// </summary>
+	~Batch_instance();
+
+	/// <summary>
+	/// Finalizer; releases the parsed formula if the instance was never disposed.
+	/// </summary>
+	!Batch_instance();
+
+	String^ path;
+	SAT_puzzle *formula; //parsed formula, or NULL before parsing and after solving
+	bool loaded; //parsing has finished, successfully or not
+	String^ error; //why the file could not be parsed, or nullptr
+	String^ report; //result line, set once the instance is solved
+	long long reserved;
+	long long parseTime, solveTime;
+};
+
+/// <summary>
+/// Solves every cnf and wcnf file of a directory with one solver, overlapping the parsing of
+/// upcoming files with the solving of earlier ones.  Loader threads parse files in name order;
+/// solver threads take the parsed formulas in the same order, so apart from the first parse the
+/// cores spend the batch searching.
+/// Each claimed file holds part of a memory budget, estimated from its size, until its formula
+/// is solved and released.  A loader waits before claiming a file that would exceed the budget,
+/// so parsed formulas never pile up behind slow searches.  A file larger than the whole budget
+/// is still loaded, but only once nothing else is held.
+/// Results are printed in file order, one line per file, followed by the batch totals.
+/// </summary>
+ref class Batch_runner
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inDirectory">directory holding the formulas</param>
+	/// <param name="inSolver">paws, saps, maxsat, dpll or exhaustive</param>
+	/// <param name="inBudget">time budget of each search in milliseconds</param>
+	/// <param name="inMemoryBudget">bytes parsed formulas may take up at once</param>
+	/// <param name="inSeed">random seed of every search; a negative seed draws from the clock</param>
+	Batch_runner(String^ inDirectory, String^ inSolver, int inBudget, long long inMemoryBudget, int inSeed);
+
+	/// <summary>
+	/// Solves the batch, printing each result as soon as those of the earlier files are out.
+	/// </summary>
+	/// <returns>process exit code</returns>
+	int run();
+
+	//rough bytes of parsed formula per byte of formula text, used to charge the memory budget
+	literal int MEMORY_FACTOR = 6;
+	//memory budget in megabytes when none is given
+	literal int DEFAULT_MEMORY_MB = 512;
+
+private:
+
+	/// <summary>
+	/// Loader thread: parses claimed files until none are left.
+	/// </summary>
+	void loadInstances();
+
+	/// <summary>
+	/// Solver thread: solves parsed formulas in file order until none are left.
+	/// </summary>
+	void solveInstances();
+
+	/// <summary>
+	/// Claims the next file to parse, first waiting until its estimated size fits in the memory budget.
+	/// </summary>
+	/// <returns>the claimed instance, or nullptr when every file has been claimed</returns>
+	Batch_instance^ claimLoad();
+
+	/// <summary>
+	/// Claims the next file to solve and waits for its parse to finish.
+	/// </summary>
+	/// <returns>the parsed instance, or nullptr when every file has been claimed</returns>
+	Batch_instance^ claimSolve();
+
+	/// <summary>
+	/// Releases an instance's formula and memory budget, then prints every result that is now
+	/// next in file order.
+	/// </summary>
+	/// <param name="instance">instance that has been solved</param>
+	/// <param name="report">result line of the instance</param>
+	void finish(Batch_instance^ instance, String^ report);
+
+	String^ directory;
+	String^ solver;
+	int budget;
+	long long memoryBudget;
+	int seed;
+
+	array<String^>^ files; //in name order
+	array<long long>^ estimates; //budget charged for each file
+	array<Batch_instance^>^ instances; //created as files are claimed
+
+	//guards everything below; waited on by loaders for memory and by solvers for parses
+	Object^ gate;
+	int nextLoad, nextSolve, nextPrint;
+	long long memoryUsed;
+	long long parseTotal, solveTotal;
+};
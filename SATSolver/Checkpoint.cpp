@@ -0,0 +1,151 @@
+#include "stdafx.h"
+#include "Checkpoint.h"
+
+/// <summary>
+/// Starts a new snapshot in a temporary file next to path and writes its header.
+/// </summary>
+/// <param name="path">checkpoint file</param>
+/// <param name="kind">WALKSAT or GENETIC</param>
+/// <param name="formula">formula being solved</param>
+/// <returns>writer for the solver's state</returns>
+BinaryWriter^ Checkpoint::create(String^ path, int kind, SAT_puzzle *formula)
+{
+	BinaryWriter^ writer = gcnew BinaryWriter(gcnew FileStream(path + ".tmp", FileMode::Create, FileAccess::Write));
+	writer->Write(MAGIC);
+	writer->Write(VERSION);
+	writer->Write(kind);
+	writer->Write(formula->getNumMembers());
+	writer->Write(formula->getNumClauses());
+	writer->Write(fingerprint(formula));
+	return writer;
+}
+
+/// <summary>
+/// Finishes a snapshot, replacing the previous checkpoint with it.
+/// </summary>
+/// <param name="writer">writer returned by create</param>
+/// <param name="path">checkpoint file</param>
+void Checkpoint::commit(BinaryWriter^ writer, String^ path)
+{
+	writer->Close();
+	if (File::Exists(path))
+	{
+		File::Replace(path + ".tmp", path, nullptr);
+	}
+	else
+	{
+		File::Move(path + ".tmp", path);
+	}
+}
+
+/// <summary>
+/// Opens a checkpoint for resuming.
+/// </summary>
+/// <param name="path">checkpoint file</param>
+/// <param name="kind">WALKSAT or GENETIC</param>
+/// <param name="formula">formula being solved</param>
+/// <returns>reader positioned after the header, or nullptr if there is no usable checkpoint</returns>
+BinaryReader^ Checkpoint::open(String^ path, int kind, SAT_puzzle *formula)
+{
+	if (!File::Exists(path))
+	{
+		return nullptr;
+	}
+	BinaryReader^ reader = gcnew BinaryReader(File::OpenRead(path));
+	try
+	{
+		if (reader->ReadInt32() == MAGIC && reader->ReadInt32() == VERSION && reader->ReadInt32() == kind
+			&& reader->ReadInt32() == formula->getNumMembers() && reader->ReadInt32() == formula->getNumClauses()
+			&& reader->ReadInt64() == fingerprint(formula))
+		{
+			return reader;
+		}
+	}
+	catch (EndOfStreamException^ short_file)
+	{
+	}
+	Console::WriteLine("Checkpoint " + path + " does not belong to this formula and solver; starting afresh.");
+	reader->Close();
+	return nullptr;
+}
+
+/// <summary>
+/// Deletes a checkpoint once its run has finished.
+/// </summary>
+/// <param name="path">checkpoint file</param>
+void Checkpoint::remove(String^ path)
+{
+	if (File::Exists(path))
+	{
+		File::Delete(path);
+	}
+}
+
+/// <summary>
+/// Writes an assignment packed eight members to a byte.
+/// </summary>
+void Checkpoint::writeAssignment(BinaryWriter^ writer, const vector<bool> &assignment)
+{
+	array<Byte>^ packed = gcnew array<Byte>((assignment.size() + 7) / 8);
+	for (unsigned int i = 0; i < assignment.size(); i++)
+	{
+		if (assignment[i])
+		{
+			packed[i / 8] |= (Byte)(1 << (i % 8));
+		}
+	}
+	writer->Write((int)assignment.size());
+	writer->Write(packed);
+}
+
+/// <summary>
+/// Reads an assignment written by writeAssignment.
+/// </summary>
+vector<bool> Checkpoint::readAssignment(BinaryReader^ reader)
+{
+	int size = reader->ReadInt32();
+	array<Byte>^ packed = reader->ReadBytes((size + 7) / 8);
+	vector<bool> assignment(size);
+	for (int i = 0; i < size; i++)
+	{
+		assignment[i] = (packed[i / 8] >> (i % 8) & 1) != 0;
+	}
+	return assignment;
+}
+
+/// <summary>
+/// Writes the full internal state of a random number source.
+/// </summary>
+void Checkpoint::writeRandom(BinaryWriter^ writer, Random^ rand)
+{
+	//Random is serializable, which keeps its whole seed array rather than just the original seed
+	writer->Flush();
+	BinaryFormatter^ formatter = gcnew BinaryFormatter();
+	formatter->Serialize(writer->BaseStream, rand);
+}
+
+/// <summary>
+/// Reads a random number source written by writeRandom; it continues the original sequence.
+/// </summary>
+Random^ Checkpoint::readRandom(BinaryReader^ reader)
+{
+	BinaryFormatter^ formatter = gcnew BinaryFormatter();
+	return safe_cast<Random^>(formatter->Deserialize(reader->BaseStream));
+}
+
+/// <summary>
+/// Hashes the clauses of a formula (FNV-1a over its literals).
+/// </summary>
+long long Checkpoint::fingerprint(SAT_puzzle *formula)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for (int i = 0; i < formula->getNumClauses(); i++)
+	{
+		const vector<int> &clause = formula->getClause(i);
+		for (unsigned int j = 0; j < clause.size(); j++)
+		{
+			hash = (hash ^ (unsigned int)clause[j]) * 1099511628211ULL;
+		}
+	}
+	return (long long)hash;
+}
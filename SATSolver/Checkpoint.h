@@ -0,0 +1,89 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SAT_puzzle.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+using namespace System::Runtime::Serialization::Formatters::Binary;
+
+/// <summary>
+/// Binary checkpoint files that let a long search resume after the process is stopped.
+/// A checkpoint starts with a header naming the solver and fingerprinting the formula, so a
+/// checkpoint is never applied to a different formula; the rest is written by the solver.
+/// Each snapshot goes to a temporary file that then replaces the previous checkpoint, so an
+/// eviction part-way through a write leaves the last complete snapshot in place.
+/// </summary>
+ref class Checkpoint
+{
+public:
+
+	literal int WALKSAT = 0;
+	literal int GENETIC = 1;
+
+	//milliseconds between snapshots; well below any budget a resumable run would be given
+	literal int INTERVAL = 5000;
+
+	/// <summary>
+	/// Starts a new snapshot in a temporary file next to path and writes its header.
+	/// </summary>
+	/// <param name="path">checkpoint file</param>
+	/// <param name="kind">WALKSAT or GENETIC</param>
+	/// <param name="formula">formula being solved</param>
+	/// <returns>writer for the solver's state</returns>
+	static BinaryWriter^ create(String^ path, int kind, SAT_puzzle *formula);
+
+	/// <summary>
+	/// Finishes a snapshot, replacing the previous checkpoint with it.
+	/// </summary>
+	/// <param name="writer">writer returned by create</param>
+	/// <param name="path">checkpoint file</param>
+	static void commit(BinaryWriter^ writer, String^ path);
+
+	/// <summary>
+	/// Opens a checkpoint for resuming.
+	/// </summary>
+	/// <param name="path">checkpoint file</param>
+	/// <param name="kind">WALKSAT or GENETIC</param>
+	/// <param name="formula">formula being solved</param>
+	/// <returns>reader positioned after the header, or nullptr if there is no usable checkpoint</returns>
+	static BinaryReader^ open(String^ path, int kind, SAT_puzzle *formula);
+
+	/// <summary>
+	/// Deletes a checkpoint once its run has finished.
+	/// </summary>
+	/// <param name="path">checkpoint file</param>
+	static void remove(String^ path);
+
+	/// <summary>
+	/// Writes an assignment packed eight members to a byte.
+	/// </summary>
+	static void writeAssignment(BinaryWriter^ writer, const vector<bool> &assignment);
+
+	/// <summary>
+	/// Reads an assignment written by writeAssignment.
+	/// </summary>
+	static vector<bool> readAssignment(BinaryReader^ reader);
+
+	/// <summary>
+	/// Writes the full internal state of a random number source.
+	/// </summary>
+	static void writeRandom(BinaryWriter^ writer, Random^ rand);
+
+	/// <summary>
+	/// Reads a random number source written by writeRandom; it continues the original sequence.
+	/// </summary>
+	static Random^ readRandom(BinaryReader^ reader);
+
+private:
+
+	/// <summary>
+	/// Hashes the clauses of a formula (FNV-1a over its literals).
+	/// </summary>
+	static long long fingerprint(SAT_puzzle *formula);
+
+	//"SATC" read as a little-endian integer
+	literal int MAGIC = 0x43544153;
+	literal int VERSION = 3;
+};
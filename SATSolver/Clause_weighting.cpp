@@ -0,0 +1,458 @@
+#include "stdafx.h"
+#include "Clause_weighting.h"
+#include "DPLL.h"
+
+/***************************************************
+* public functions START
+***************************************************/
+
+/// <summary>
+/// Default constructor.
+/// </summary>
+Clause_weighting::Clause_weighting()
+{
+	scheme = PAWS;
+	increases = 0;
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+/// <param name="inScheme">weighting scheme, PAWS or SAPS.</param>
+Clause_weighting::Clause_weighting(SAT_puzzle inPuzzle, int inScheme)
+{
+	baseFormula = std::move(inPuzzle);
+	scheme = inScheme;
+	increases = 0;
+}
+
+/// <summary>
+/// Runs the clause weighting algorithm
+/// </summary>
+/// <returns>-1 if the formula was satisfied, DPLL::UNSATISFIABLE if it holds an empty clause,
+/// otherwise the most clauses satisfied at once.</returns>
+int Clause_weighting::run_ClauseWeighting()
+{
+	Random ^ rand = (seed < 0) ? gcnew Random() : gcnew Random(seed);
+	Stopwatch ^ timeKeeper = gcnew Stopwatch();
+	timeKeeper->Start();
+
+	int numMembers = baseFormula.getNumMembers();
+	values.resize(numMembers);
+	for (int i = 0; i < numMembers; i++)
+	{
+		values[i] = (char)rand->Next(2);
+	}
+	initialize();
+
+	//an empty clause stays falsified whatever is flipped, and offers no member to pick; a
+	// tautology also has no literals here, but is never falsified
+	for (unsigned int i = 0; i < clauses.size(); i++)
+	{
+		if (clauses[i].empty() && baseFormula.getClause(i)[0] == 0)
+		{
+			timeKeeper->Stop();
+			return DPLL::UNSATISFIABLE;
+		}
+	}
+
+	vector<char> bestValues = values;
+	unsigned int bestFalsified = falsified.size();
+	long long steps = 0;
+
+	while (!falsified.empty())
+	{
+		//the clock is only read, and progress published, every 256 steps to keep them off the flip path
+		if ((++steps & 255) == 0)
+		{
+			if (timeKeeper->ElapsedMilliseconds >= MAXTIME)
+			{
+				break;
+			}
+			if (progress != nullptr)
+			{
+				progress->publish(steps, (int)falsified.size(), (int)bestFalsified);
+			}
+		}
+
+		double bestScore;
+		int member = pickMember(rand, bestScore);
+
+		if (bestScore > EPSILON)
+		{
+			flip(member);
+		}
+		else if (scheme == PAWS)
+		{
+			//at a local minimum PAWS sometimes takes a sideways move, otherwise it reweights
+			if (bestScore > -EPSILON && rand->NextDouble() < FLATPROB)
+			{
+				flip(member);
+			}
+			else
+			{
+				increaseWeights();
+				increases++;
+				if (increases % DECREASEPERIOD == 0)
+				{
+					smoothWeights();
+				}
+			}
+		}
+		else
+		{
+			if (rand->NextDouble() < WALKPROB)
+			{
+				flip(rand->Next(numMembers));
+			}
+			else
+			{
+				increaseWeights();
+				if (rand->NextDouble() < SMOOTHPROB)
+				{
+					smoothWeights();
+				}
+			}
+		}
+
+		if (falsified.size() < bestFalsified)
+		{
+			bestFalsified = falsified.size();
+			bestValues = values;
+		}
+	}
+
+	timeKeeper->Stop();
+
+	//leave the best assignment seen in the formula so it can be reported
+	for (int i = 0; i < numMembers; i++)
+	{
+		baseFormula.setMemberAtIndex(i, bestValues[i] != 0);
+	}
+	int num_trues = baseFormula.check_trues();
+	if (baseFormula.satisfied())
+	{
+		return -1;
+	}
+	else { return num_trues; }
+}
+
+/// <summary>
+/// checks to see if the formula has been solved or not.
+/// </summary>
+/// <returns>returns true if solved, false if not</returns>
+bool Clause_weighting::formulaSolved()
+{
+	return baseFormula.satisfied();
+}
+
+/// <summary>
+/// checks how many clauses in the formula have been satisfied
+/// </summary>
+/// <returns>an integer equal to the number of satisfied clauses</returns>
+int Clause_weighting::checkPuzzle()
+{
+	return baseFormula.check_trues();
+}
+
+/// <summary>
+/// Gets the formula holding the best assignment found by the search.
+/// </summary>
+/// <returns>the SAT_puzzle object being solved</returns>
+const SAT_puzzle& Clause_weighting::getFormula()
+{
+	return baseFormula;
+}
+
+/// <summary>
+/// Sets the time budget for subsequent runs.
+/// </summary>
+/// <param name="maxTime">time budget in milliseconds</param>
+void Clause_weighting::setMaxTime(int maxTime)
+{
+	MAXTIME = maxTime;
+}
+
+/// <summary>
+/// Sets the seed of the random number source, making runs repeatable.
+/// </summary>
+/// <param name="inSeed">seed for subsequent runs; a negative seed draws from the clock</param>
+void Clause_weighting::setSeed(int inSeed)
+{
+	seed = inSeed;
+}
+
+/// <summary>
+/// Sets where the search publishes its progress for telemetry.
+/// </summary>
+/// <param name="record">progress record owned by the caller, or nullptr for none</param>
+void Clause_weighting::setProgress(Search_progress *record)
+{
+	progress = record;
+}
+
+/***************************************************
+* public functions END
+***************************************************/
+
+/***************************************************
+* private functions START
+***************************************************/
+
+/// <summary>
+/// Builds the clause lists, true-literal counts and weighted scores for the current assignment.
+/// </summary>
+void Clause_weighting::initialize()
+{
+	int numClauses = baseFormula.getNumClauses();
+
+	//a literal repeated within a clause would be counted twice by the incremental updates, and a
+	// tautology, which would charge its true member a break on every flip, is left with no literals
+	clauses.assign(numClauses, vector<int>());
+	for (int i = 0; i < numClauses; i++)
+	{
+		baseFormula.getDistinctLiterals(i, clauses[i]);
+	}
+
+	weights.assign(numClauses, 1.0);
+	increases = 0;
+	computeScores();
+}
+
+/// <summary>
+/// Recomputes every member's weighted score from the clause counts and weights.
+/// </summary>
+void Clause_weighting::computeScores()
+{
+	int numClauses = clauses.size();
+	scores.assign(baseFormula.getNumMembers(), 0.0);
+	true_counts.assign(numClauses, 0);
+	true_sums.assign(numClauses, 0);
+	falsified.clear();
+	falsified_pos.assign(numClauses, -1);
+
+	for (int i = 0; i < numClauses; i++)
+	{
+		//tautologies take no part, and an empty clause ends the run before the first step
+		if (clauses[i].empty())
+		{
+			continue;
+		}
+		for (unsigned int j = 0; j < clauses[i].size(); j++)
+		{
+			int literal = clauses[i][j];
+			int member = (literal > 0) ? literal - 1 : (-literal) - 1;
+			if ((literal > 0) == (values[member] != 0))
+			{
+				true_counts[i]++;
+				true_sums[i] += member;
+			}
+		}
+
+		//a falsified clause is made by each of its members; a clause with one true member is broken by it
+		if (true_counts[i] == 0)
+		{
+			addFalsified(i);
+			for (unsigned int j = 0; j < clauses[i].size(); j++)
+			{
+				scores[abs(clauses[i][j]) - 1] += weights[i];
+			}
+		}
+		else if (true_counts[i] == 1)
+		{
+			scores[true_sums[i]] -= weights[i];
+		}
+	}
+}
+
+/// <summary>
+/// Flips a member, updating true-literal counts and the weighted scores of affected members.
+/// Costs O(occurrences of the member), plus the clause length when a clause changes between
+/// falsified and satisfied.
+/// </summary>
+/// <param name="member">index of the member to be flipped</param>
+void Clause_weighting::flip(int member)
+{
+	values[member] = !values[member];
+	int trueLiteral = values[member] ? member + 1 : -(member + 1);
+
+	//clauses where the member's literal has just become true
+	const vector<int> &made = baseFormula.getOccurrences(trueLiteral);
+	for (unsigned int i = 0; i < made.size(); i++)
+	{
+		int c = made[i];
+		double w = weights[c];
+		if (true_counts[c] == 0)
+		{
+			//no longer falsified: nobody makes it any more, and the flipped member now breaks it
+			removeFalsified(c);
+			for (unsigned int j = 0; j < clauses[c].size(); j++)
+			{
+				scores[abs(clauses[c][j]) - 1] -= w;
+			}
+			scores[member] -= w;
+		}
+		else if (true_counts[c] == 1)
+		{
+			//the previously critical member can now be flipped without breaking the clause
+			scores[true_sums[c]] += w;
+		}
+		true_counts[c]++;
+		true_sums[c] += member;
+	}
+
+	//clauses where the member's literal has just become false
+	const vector<int> &broken = baseFormula.getOccurrences(-trueLiteral);
+	for (unsigned int i = 0; i < broken.size(); i++)
+	{
+		int c = broken[i];
+		double w = weights[c];
+		true_counts[c]--;
+		true_sums[c] -= member;
+		if (true_counts[c] == 0)
+		{
+			addFalsified(c);
+			scores[member] += w;
+			for (unsigned int j = 0; j < clauses[c].size(); j++)
+			{
+				scores[abs(clauses[c][j]) - 1] += w;
+			}
+		}
+		else if (true_counts[c] == 1)
+		{
+			//the remaining true member has become critical
+			scores[true_sums[c]] -= w;
+		}
+	}
+}
+
+/// <summary>
+/// Finds the member of a falsified clause with the highest weighted score, breaking ties randomly.
+/// Scans every literal of every falsified clause, so a step costs O(total length of the falsified
+/// clauses); this is small once the search is near a solution, but large early on.
+/// </summary>
+/// <param name="rand">random number source for tie-breaking</param>
+/// <param name="bestScore">set to the score of the returned member</param>
+/// <returns>the index of the chosen member</returns>
+int Clause_weighting::pickMember(Random ^ rand, double &bestScore)
+{
+	candidates.clear();
+	bestScore = 0.0;
+	for (unsigned int i = 0; i < falsified.size(); i++)
+	{
+		const vector<int> &clause = clauses[falsified[i]];
+		for (unsigned int j = 0; j < clause.size(); j++)
+		{
+			int member = abs(clause[j]) - 1;
+			double score = scores[member];
+			if (candidates.empty() || score > bestScore + EPSILON)
+			{
+				candidates.clear();
+				candidates.push_back(member);
+				bestScore = score;
+			}
+			else if (score > bestScore - EPSILON)
+			{
+				candidates.push_back(member);
+			}
+		}
+	}
+	return candidates[rand->Next((int)candidates.size())];
+}
+
+/// <summary>
+/// Raises the weight of every falsified clause: +1 for PAWS, times ALPHA for SAPS.
+/// </summary>
+void Clause_weighting::increaseWeights()
+{
+	for (unsigned int i = 0; i < falsified.size(); i++)
+	{
+		int c = falsified[i];
+		setWeight(c, scheme == PAWS ? weights[c] + 1.0 : weights[c] * ALPHA);
+	}
+}
+
+/// <summary>
+/// Decays the weights of all clauses: -1 on every raised clause for PAWS, or towards the mean
+/// weight for SAPS.
+/// </summary>
+void Clause_weighting::smoothWeights()
+{
+	int numClauses = weights.size();
+	if (scheme == PAWS)
+	{
+		for (int i = 0; i < numClauses; i++)
+		{
+			if (weights[i] > 1.0)
+			{
+				setWeight(i, weights[i] - 1.0);
+			}
+		}
+	}
+	else
+	{
+		double mean = 0.0;
+		for (int i = 0; i < numClauses; i++)
+		{
+			mean += weights[i];
+		}
+		mean /= numClauses;
+		for (int i = 0; i < numClauses; i++)
+		{
+			weights[i] = RHO * weights[i] + (1.0 - RHO) * mean;
+		}
+		//every weight moved, so the scores are rebuilt, which also clears accumulated rounding error
+		computeScores();
+	}
+}
+
+/// <summary>
+/// Changes the weight of one clause and adjusts the scores that depend on it.
+/// </summary>
+/// <param name="clause">index of the clause to be changed</param>
+/// <param name="newWeight">the new weight of the clause</param>
+void Clause_weighting::setWeight(int clause, double newWeight)
+{
+	double delta = newWeight - weights[clause];
+	if (true_counts[clause] == 0)
+	{
+		for (unsigned int j = 0; j < clauses[clause].size(); j++)
+		{
+			scores[abs(clauses[clause][j]) - 1] += delta;
+		}
+	}
+	else if (true_counts[clause] == 1)
+	{
+		scores[true_sums[clause]] -= delta;
+	}
+	weights[clause] = newWeight;
+}
+
+/// <summary>
+/// Adds a clause to the list of falsified clauses.
+/// </summary>
+/// <param name="clause">index of the clause that became falsified</param>
+void Clause_weighting::addFalsified(int clause)
+{
+	falsified_pos[clause] = falsified.size();
+	falsified.push_back(clause);
+}
+
+/// <summary>
+/// Removes a clause from the list of falsified clauses in constant time.
+/// </summary>
+/// <param name="clause">index of the clause that became satisfied</param>
+void Clause_weighting::removeFalsified(int clause)
+{
+	int position = falsified_pos[clause];
+	int last = falsified.back();
+	falsified[position] = last;
+	falsified_pos[last] = position;
+	falsified.pop_back();
+	falsified_pos[clause] = -1;
+}
+
+/***************************************************
+* private functions END
+***************************************************/
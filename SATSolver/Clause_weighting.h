@@ -0,0 +1,170 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SAT_puzzle.h"
+#include "Telemetry.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+using namespace System::Diagnostics;
+
+/// <summary>
+/// Class containing the necessary data structures and methods to
+/// solve a SAT formula through use of dynamic clause weighting local search.
+/// Falsified clauses gain weight at local minima, so the search is pushed out of
+/// minima that an unweighted count cannot escape.  Two schedules are supported:
+/// PAWS (additive increases, periodic decrease) and SAPS (multiplicative scaling,
+/// probabilistic smoothing towards the mean weight).
+/// </summary>
+class Clause_weighting
+{
+public:
+
+	/// <summary>
+	/// Pure additive weighting scheme: +1 per falsified clause, -1 on all raised clauses every few increases.
+	/// </summary>
+	static const int PAWS = 0;
+
+	/// <summary>
+	/// Scaling and probabilistic smoothing scheme.
+	/// </summary>
+	static const int SAPS = 1;
+
+	/// <summary>
+	/// Default constructor.
+	/// </summary>
+	Clause_weighting();
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+	/// <param name="inScheme">weighting scheme, PAWS or SAPS.</param>
+	Clause_weighting(SAT_puzzle inPuzzle, int inScheme);
+
+	/// <summary>
+	/// Runs the clause weighting algorithm
+	/// </summary>
+	/// <returns>-1 if the formula was satisfied, DPLL::UNSATISFIABLE if it holds an empty clause,
+	/// otherwise the most clauses satisfied at once.</returns>
+	int run_ClauseWeighting();
+
+	/// <summary>
+	/// checks to see if the formula has been solved or not.
+	/// </summary>
+	/// <returns>returns true if solved, false if not</returns>
+	bool formulaSolved();
+
+	/// <summary>
+	/// checks how many clauses in the formula have been satisfied
+	/// </summary>
+	/// <returns>an integer equal to the number of satisfied clauses</returns>
+	int checkPuzzle();
+
+	/// <summary>
+	/// Gets the formula holding the best assignment found by the search.
+	/// </summary>
+	/// <returns>the SAT_puzzle object being solved</returns>
+	const SAT_puzzle& getFormula();
+
+	/// <summary>
+	/// Sets the time budget for subsequent runs.
+	/// </summary>
+	/// <param name="maxTime">time budget in milliseconds</param>
+	void setMaxTime(int maxTime);
+
+	/// <summary>
+	/// Sets the seed of the random number source, making runs repeatable.
+	/// </summary>
+	/// <param name="inSeed">seed for subsequent runs; a negative seed draws from the clock</param>
+	void setSeed(int inSeed);
+
+	/// <summary>
+	/// Sets where the search publishes its progress for telemetry.
+	/// </summary>
+	/// <param name="record">progress record owned by the caller, or nullptr for none</param>
+	void setProgress(Search_progress *record);
+
+private:
+
+	/// <summary>
+	/// Builds the clause lists, true-literal counts and weighted scores for the current assignment.
+	/// </summary>
+	void initialize();
+
+	/// <summary>
+	/// Recomputes every member's weighted score from the clause counts and weights.
+	/// </summary>
+	void computeScores();
+
+	/// <summary>
+	/// Flips a member, updating true-literal counts and the weighted scores of affected members.
+	/// Costs O(occurrences of the member), plus the clause length when a clause changes between
+	/// falsified and satisfied.
+	/// </summary>
+	/// <param name="member">index of the member to be flipped</param>
+	void flip(int member);
+
+	/// <summary>
+	/// Finds the member of a falsified clause with the highest weighted score, breaking ties randomly.
+	/// Scans every literal of every falsified clause, so a step costs O(total length of the falsified
+	/// clauses); this is small once the search is near a solution, but large early on.
+	/// </summary>
+	/// <param name="rand">random number source for tie-breaking</param>
+	/// <param name="bestScore">set to the score of the returned member</param>
+	/// <returns>the index of the chosen member</returns>
+	int pickMember(Random ^ rand, double &bestScore);
+
+	/// <summary>
+	/// Raises the weight of every falsified clause: +1 for PAWS, times ALPHA for SAPS.
+	/// </summary>
+	void increaseWeights();
+
+	/// <summary>
+	/// Decays the weights of all clauses: -1 on every raised clause for PAWS, or towards the mean
+	/// weight for SAPS.
+	/// </summary>
+	void smoothWeights();
+
+	/// <summary>
+	/// Changes the weight of one clause and adjusts the scores that depend on it.
+	/// </summary>
+	/// <param name="clause">index of the clause to be changed</param>
+	/// <param name="newWeight">the new weight of the clause</param>
+	void setWeight(int clause, double newWeight);
+
+	/// <summary>
+	/// Adds a clause to the list of falsified clauses.
+	/// </summary>
+	/// <param name="clause">index of the clause that became falsified</param>
+	void addFalsified(int clause);
+
+	/// <summary>
+	/// Removes a clause from the list of falsified clauses in constant time.
+	/// </summary>
+	/// <param name="clause">index of the clause that became satisfied</param>
+	void removeFalsified(int clause);
+
+	SAT_puzzle baseFormula;
+	int MAXTIME = 10000;
+	Search_progress *progress = nullptr;
+	int seed = -1;
+	int scheme;
+
+	//PAWS: probability of taking a flat move, and increases between decreases
+	double FLATPROB = 0.15;
+	int DECREASEPERIOD = 10;
+	//SAPS: scaling factor, smoothing factor, smoothing probability and random walk probability
+	double ALPHA = 1.3, RHO = 0.8, SMOOTHPROB = 0.05, WALKPROB = 0.01;
+	//scores within this distance of zero are treated as zero, since SAPS weights are fractional
+	double EPSILON = 1e-9;
+
+	vector<vector<int>> clauses; //literals of each clause, with repeats removed; none for a tautology
+	vector<char> values; //current value of each member
+	vector<double> weights, scores; //clause weights and weighted make - break of each member
+	vector<int> true_counts, true_sums; //number and index sum of true members in each clause
+	vector<int> falsified, falsified_pos; //falsified clauses and each clause's position in that list
+	vector<int> candidates;
+	int increases;
+};
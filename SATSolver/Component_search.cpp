@@ -0,0 +1,367 @@
+#include "stdafx.h"
+#include <algorithm>
+#include "Component_search.h"
+
+/// <summary>
+/// Orders components by decreasing number of clauses, breaking ties by index.
+/// </summary>
+struct Component_larger
+{
+	const vector<vector<int>> *clauses;
+
+	bool operator()(int a, int b) const
+	{
+		return (*clauses)[a].size() > (*clauses)[b].size() || ((*clauses)[a].size() == (*clauses)[b].size() && a < b);
+	}
+};
+
+/***************************************************
+* Component_split functions START
+***************************************************/
+
+/// <summary>
+/// Finds the components of a formula.
+/// </summary>
+/// <param name="inFormula">formula to be split; it must outlive this object</param>
+Component_split::Component_split(SAT_puzzle &inFormula)
+{
+	formula = &inFormula;
+	int numMembers = formula->getNumMembers();
+	int numClauses = formula->getNumClauses();
+	parent.resize(numMembers);
+	size.assign(numMembers, 1);
+	for (int i = 0; i < numMembers; i++)
+	{
+		parent[i] = i;
+	}
+
+	//union by size: every member of a clause joins the set of its first member
+	emptyClause = false;
+	vector<bool> used(numMembers, false);
+	for (int i = 0; i < numClauses; i++)
+	{
+		const vector<int> &clause = formula->getClause(i);
+		if (clause.empty() || clause[0] == 0)
+		{
+			emptyClause = true;
+			continue;
+		}
+		int root = find(abs(clause[0]) - 1);
+		used[abs(clause[0]) - 1] = true;
+		for (unsigned int j = 1; j < clause.size() && clause[j] != 0; j++)
+		{
+			int other = find(abs(clause[j]) - 1);
+			used[abs(clause[j]) - 1] = true;
+			if (other != root)
+			{
+				if (size[other] > size[root])
+				{
+					swap(other, root);
+				}
+				parent[other] = root;
+				size[root] += size[other];
+			}
+		}
+	}
+
+	//number the components by root, then order them largest first
+	vector<int> index(numMembers, -1);
+	vector<vector<int>> found_members, found_clauses;
+	for (int i = 0; i < numMembers; i++)
+	{
+		if (!used[i])
+		{
+			continue;
+		}
+		int root = find(i);
+		if (index[root] < 0)
+		{
+			index[root] = (int)found_members.size();
+			found_members.push_back(vector<int>());
+			found_clauses.push_back(vector<int>());
+		}
+		found_members[index[root]].push_back(i);
+	}
+	for (int i = 0; i < numClauses; i++)
+	{
+		const vector<int> &clause = formula->getClause(i);
+		if (!clause.empty() && clause[0] != 0)
+		{
+			found_clauses[index[find(abs(clause[0]) - 1)]].push_back(i);
+		}
+	}
+	vector<int> order(found_members.size());
+	for (unsigned int i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
+	Component_larger by_size;
+	by_size.clauses = &found_clauses;
+	sort(order.begin(), order.end(), by_size);
+	members.resize(order.size());
+	clauses.resize(order.size());
+	for (unsigned int i = 0; i < order.size(); i++)
+	{
+		members[i].swap(found_members[order[i]]);
+		clauses[i].swap(found_clauses[order[i]]);
+	}
+
+	local.assign(numMembers, 0);
+	for (unsigned int c = 0; c < members.size(); c++)
+	{
+		for (unsigned int i = 0; i < members[c].size(); i++)
+		{
+			local[members[c][i]] = i + 1;
+		}
+	}
+}
+
+/// <summary>
+/// Gets the number of components, largest first.
+/// </summary>
+/// <returns></returns>
+int Component_split::getNumComponents()
+{
+	return (int)members.size();
+}
+
+/// <summary>
+/// Gets the formula member behind each member of a component.  The component numbers
+/// its members from 1 in the order listed here.
+/// </summary>
+/// <param name="component">index of the component</param>
+/// <returns>formula member indices, ascending</returns>
+const vector<int>& Component_split::getMembers(int component)
+{
+	return members[component];
+}
+
+/// <summary>
+/// Builds a component as a formula of its own.
+/// </summary>
+/// <param name="component">index of the component</param>
+/// <returns>the clauses of the component over its own members</returns>
+SAT_puzzle Component_split::buildComponent(int component)
+{
+	SAT_puzzle part;
+	vector<int> literals;
+	for (unsigned int i = 0; i < clauses[component].size(); i++)
+	{
+		const vector<int> &clause = formula->getClause(clauses[component][i]);
+		literals.clear();
+		for (unsigned int j = 0; j < clause.size() && clause[j] != 0; j++)
+		{
+			int member = local[abs(clause[j]) - 1];
+			literals.push_back(clause[j] > 0 ? member : -member);
+		}
+		part.addClause(literals);
+	}
+	return part;
+}
+
+/// <summary>
+/// Determines whether the formula holds a clause without literals, which no assignment satisfies.
+/// </summary>
+/// <returns></returns>
+bool Component_split::hasEmptyClause()
+{
+	return emptyClause;
+}
+
+/// <summary>
+/// Finds the representative of a member's set, halving the path on the way.
+/// </summary>
+int Component_split::find(int member)
+{
+	while (parent[member] != member)
+	{
+		parent[member] = parent[parent[member]];
+		member = parent[member];
+	}
+	return member;
+}
+
+/***************************************************
+* Component_split functions END
+***************************************************/
+
+/***************************************************
+* Component_thread functions START
+***************************************************/
+
+/// <summary>
+/// Constructor.
+/// </summary>
+Component_thread::Component_thread(Component_search *inSearch, int inFirst, int inStride, Stopwatch ^ inTimeKeeper)
+{
+	search = inSearch;
+	first = inFirst;
+	stride = inStride;
+	timeKeeper = inTimeKeeper;
+}
+
+/// <summary>
+/// Solves this thread's share of the components on the calling thread.
+/// </summary>
+void Component_thread::Run()
+{
+	search->solveComponents(first, stride, timeKeeper);
+}
+
+/***************************************************
+* Component_thread functions END
+***************************************************/
+
+/***************************************************
+* Component_search functions START
+***************************************************/
+
+/// <summary>
+/// Default constructor.
+/// </summary>
+Component_search::Component_search()
+{
+	split = nullptr;
+	stopped = 0;
+	numComponents = 0;
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+Component_search::Component_search(SAT_puzzle inPuzzle)
+{
+	baseFormula = std::move(inPuzzle);
+	split = nullptr;
+	stopped = 0;
+	numComponents = 0;
+}
+
+/// <summary>
+/// Solves every component and merges their assignments into the formula.
+/// </summary>
+/// <returns>-1 if satisfied, DPLL::UNSATISFIABLE if a component is unsatisfiable, otherwise the clauses satisfied when time ran out.</returns>
+int Component_search::run_Components()
+{
+	Stopwatch ^ timeKeeper = gcnew Stopwatch();
+	timeKeeper->Start();
+
+	Component_split parts(baseFormula);
+	numComponents = parts.getNumComponents();
+	if (parts.hasEmptyClause())
+	{
+		return DPLL::UNSATISFIABLE;
+	}
+
+	split = &parts;
+	stopped = 0;
+	results.assign(numComponents, 0);
+	models.assign(numComponents, vector<bool>());
+
+	//components are dealt round-robin, and since they are sorted largest first every thread
+	// starts on a large one
+	int numWorkers = Math::Min(Environment::ProcessorCount, numComponents);
+	array<Thread^>^ threads = gcnew array<Thread^>(numWorkers);
+	for (int w = 0; w < numWorkers; w++)
+	{
+		Component_thread^ entry = gcnew Component_thread(this, w, numWorkers, timeKeeper);
+		threads[w] = gcnew Thread(gcnew ThreadStart(entry, &Component_thread::Run));
+		threads[w]->Start();
+	}
+	for (int w = 0; w < numWorkers; w++)
+	{
+		threads[w]->Join();
+	}
+	split = nullptr;
+
+	//merge the component assignments; members outside every component stay as they are
+	bool refuted = false;
+	for (int c = 0; c < numComponents; c++)
+	{
+		refuted = refuted || results[c] == DPLL::UNSATISFIABLE;
+		const vector<int> &members = parts.getMembers(c);
+		for (unsigned int i = 0; i < models[c].size(); i++)
+		{
+			baseFormula.setMemberAtIndex(members[i], models[c][i]);
+		}
+	}
+	if (refuted)
+	{
+		return DPLL::UNSATISFIABLE;
+	}
+
+	int num_trues = baseFormula.check_trues();
+	if (baseFormula.satisfied())
+	{
+		return -1;
+	}
+	else { return num_trues; }
+}
+
+/// <summary>
+/// Solves the components dealt to one thread: every stride-th one, starting at first.
+/// </summary>
+/// <param name="first">index of the thread's first component</param>
+/// <param name="stride">number of threads</param>
+/// <param name="timeKeeper">clock started when the search began</param>
+void Component_search::solveComponents(int first, int stride, Stopwatch ^ timeKeeper)
+{
+	for (int c = first; c < numComponents && stopped == 0; c += stride)
+	{
+		int remaining = MAXTIME - (int)timeKeeper->ElapsedMilliseconds;
+		if (remaining <= 0)
+		{
+			return;
+		}
+		DPLL solver(split->buildComponent(c));
+		solver.setMaxTime(remaining);
+		solver.setStopFlag(&stopped);
+		results[c] = solver.run_DPLL();
+		models[c] = solver.getFormula().getMemberList();
+		if (results[c] == DPLL::UNSATISFIABLE)
+		{
+			stopped = 1;
+		}
+	}
+}
+
+/// <summary>
+/// checks to see if the formula has been solved or not.
+/// </summary>
+/// <returns>returns true if solved, false if not</returns>
+bool Component_search::formulaSolved()
+{
+	return baseFormula.satisfied();
+}
+
+/// <summary>
+/// Gets the formula holding the merged assignment of the components.
+/// </summary>
+/// <returns>the SAT_puzzle object being solved</returns>
+const SAT_puzzle& Component_search::getFormula()
+{
+	return baseFormula;
+}
+
+/// <summary>
+/// Sets the time budget for subsequent runs.
+/// </summary>
+/// <param name="maxTime">time budget in milliseconds</param>
+void Component_search::setMaxTime(int maxTime)
+{
+	MAXTIME = maxTime;
+}
+
+/// <summary>
+/// Gets the number of components found by the last run.
+/// </summary>
+/// <returns></returns>
+int Component_search::getNumComponents()
+{
+	return numComponents;
+}
+
+/***************************************************
+* Component_search functions END
+***************************************************/
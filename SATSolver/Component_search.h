@@ -0,0 +1,163 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SAT_puzzle.h"
+#include "DPLL.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+using namespace System::Diagnostics;
+using namespace System::Threading;
+
+/// <summary>
+/// Splits a formula into components that share no members, found by union-find over the
+/// members of each clause.  Members that occur in no clause belong to no component.
+/// </summary>
+class Component_split
+{
+public:
+
+	/// <summary>
+	/// Finds the components of a formula.
+	/// </summary>
+	/// <param name="inFormula">formula to be split; it must outlive this object</param>
+	Component_split(SAT_puzzle &inFormula);
+
+	/// <summary>
+	/// Gets the number of components, largest first.
+	/// </summary>
+	/// <returns></returns>
+	int getNumComponents();
+
+	/// <summary>
+	/// Gets the formula member behind each member of a component.  The component numbers
+	/// its members from 1 in the order listed here.
+	/// </summary>
+	/// <param name="component">index of the component</param>
+	/// <returns>formula member indices, ascending</returns>
+	const vector<int>& getMembers(int component);
+
+	/// <summary>
+	/// Builds a component as a formula of its own.
+	/// </summary>
+	/// <param name="component">index of the component</param>
+	/// <returns>the clauses of the component over its own members</returns>
+	SAT_puzzle buildComponent(int component);
+
+	/// <summary>
+	/// Determines whether the formula holds a clause without literals, which no assignment satisfies.
+	/// </summary>
+	/// <returns></returns>
+	bool hasEmptyClause();
+
+private:
+
+	/// <summary>
+	/// Finds the representative of a member's set, halving the path on the way.
+	/// </summary>
+	int find(int member);
+
+	SAT_puzzle *formula;
+	vector<int> parent, size;
+	vector<vector<int>> members; //formula members of each component
+	vector<vector<int>> clauses; //formula clauses of each component
+	vector<int> local; //number of each member within its component, from 1
+	bool emptyClause;
+};
+
+/// <summary>
+/// Class containing the necessary data structures and methods to
+/// solve a SAT formula one component at a time.  Components are handed out to one thread per
+/// processor, largest first, and each is solved by DPLL on its own, so small components are not
+/// held up by the search over the largest.  The formula is unsatisfiable as soon as any
+/// component is, at which point the other threads are stopped.
+/// </summary>
+class Component_search
+{
+public:
+
+	/// <summary>
+	/// Default constructor.
+	/// </summary>
+	Component_search();
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+	Component_search(SAT_puzzle inPuzzle);
+
+	/// <summary>
+	/// Solves every component and merges their assignments into the formula.
+	/// </summary>
+	/// <returns>-1 if satisfied, DPLL::UNSATISFIABLE if a component is unsatisfiable, otherwise the clauses satisfied when time ran out.</returns>
+	int run_Components();
+
+	/// <summary>
+	/// Solves the components dealt to one thread: every stride-th one, starting at first.
+	/// </summary>
+	/// <param name="first">index of the thread's first component</param>
+	/// <param name="stride">number of threads</param>
+	/// <param name="timeKeeper">clock started when the search began</param>
+	void solveComponents(int first, int stride, Stopwatch ^ timeKeeper);
+
+	/// <summary>
+	/// checks to see if the formula has been solved or not.
+	/// </summary>
+	/// <returns>returns true if solved, false if not</returns>
+	bool formulaSolved();
+
+	/// <summary>
+	/// Gets the formula holding the merged assignment of the components.
+	/// </summary>
+	/// <returns>the SAT_puzzle object being solved</returns>
+	const SAT_puzzle& getFormula();
+
+	/// <summary>
+	/// Sets the time budget for subsequent runs.
+	/// </summary>
+	/// <param name="maxTime">time budget in milliseconds</param>
+	void setMaxTime(int maxTime);
+
+	/// <summary>
+	/// Gets the number of components found by the last run.
+	/// </summary>
+	/// <returns></returns>
+	int getNumComponents();
+
+private:
+
+	SAT_puzzle baseFormula;
+	int MAXTIME = 10000;
+
+	Component_split *split;
+	vector<int> results; //DPLL result of each component
+	vector<vector<bool>> models; //assignment each component's search ended with
+	volatile int stopped; //set once a component is refuted
+	int numComponents;
+};
+
+/// <summary>
+/// Thread entry point wrapping Component_search::solveComponents, since thread delegates must
+/// bind to managed classes.
+/// </summary>
+ref class Component_thread
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	Component_thread(Component_search *inSearch, int inFirst, int inStride, Stopwatch ^ inTimeKeeper);
+
+	/// <summary>
+	/// Solves this thread's share of the components on the calling thread.
+	/// </summary>
+	void Run();
+
+private:
+	Component_search *search;
+	int first, stride;
+	Stopwatch ^ timeKeeper;
+};
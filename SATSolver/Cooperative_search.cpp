@@ -0,0 +1,563 @@
+#include "stdafx.h"
+#include "Cooperative_search.h"
+
+/***************************************************
+* Walk_worker functions START
+***************************************************/
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inFormula">shared formula, used for its occurrence lists</param>
+/// <param name="inClauses">shared clause literals with repeats removed</param>
+/// <param name="inProgress">progress record of this worker, or nullptr for none</param>
+Walk_worker::Walk_worker(SAT_puzzle *inFormula, const vector<vector<int>> *inClauses, Search_progress *inProgress)
+{
+	formula = inFormula;
+	clauses = inClauses;
+	progress = inProgress;
+	best_falsified = 0;
+}
+
+/// <summary>
+/// Runs WalkSAT steps until the formula is solved by any worker or time runs out.
+/// Improvements are published to the pool, and stagnating runs restart from elite members.
+/// </summary>
+/// <param name="pool">elite pool shared by all workers</param>
+/// <param name="rand">random number source owned by this worker</param>
+/// <param name="timeKeeper">clock started when the search began</param>
+/// <param name="maxTime">time budget in milliseconds</param>
+/// <param name="lockstep">rounds the workers meet at, or nullptr to run freely</param>
+/// <param name="index">number of this worker, which orders its offers within a round</param>
+void Walk_worker::run(Elite_pool^ pool, Random ^ rand, Stopwatch ^ timeKeeper, int maxTime, Walk_lockstep^ lockstep, int index)
+{
+	restart(pool, rand);
+	bool published = true;
+	long long steps = 0, lastImprovement = 0;
+	int restarts = 0;
+
+	while (!falsified.empty())
+	{
+		//the pool and the clock are only consulted every PUBLISHPERIOD flips
+		if (++steps % PUBLISHPERIOD == 0)
+		{
+			if (lockstep != nullptr)
+			{
+				//the round publishes the offer, and decides whether to stop, the same way every run
+				array<Byte>^ offer = published ? nullptr : snapshot(best_values);
+				published = true;
+				if (lockstep->endRound(index, offer, best_falsified, nullptr))
+				{
+					break;
+				}
+			}
+			else if (pool->isSolved() || timeKeeper->ElapsedMilliseconds >= maxTime)
+			{
+				break;
+			}
+			if (progress != nullptr)
+			{
+				progress->publish(steps, (int)falsified.size(), (int)best_falsified);
+				progress->restarts = restarts;
+			}
+			if (!published)
+			{
+				pool->publish(snapshot(best_values), best_falsified);
+				published = true;
+			}
+			if (steps - lastImprovement >= STAGNATION)
+			{
+				restart(pool, rand);
+				restarts++;
+				lastImprovement = steps;
+				published = true;
+			}
+		}
+
+		step(rand);
+
+		if (falsified.size() < best_falsified)
+		{
+			best_falsified = falsified.size();
+			best_values = values;
+			lastImprovement = steps;
+			published = false;
+		}
+	}
+
+	if (lockstep != nullptr)
+	{
+		//a solver still ends its round, so the solution is only taken once every worker is waiting
+		if (falsified.empty())
+		{
+			lockstep->endRound(index, nullptr, 0, snapshot(values));
+		}
+	}
+	else if (falsified.empty())
+	{
+		pool->reportSolution(snapshot(values));
+	}
+	else if (!published)
+	{
+		pool->publish(snapshot(best_values), best_falsified);
+	}
+}
+
+/// <summary>
+/// Chooses the starting assignment for a restart: a crossover of two elite members or a
+/// perturbed copy of one, or a random assignment while the pool is still empty.
+/// </summary>
+void Walk_worker::restart(Elite_pool^ pool, Random ^ rand)
+{
+	int numMembers = formula->getNumMembers();
+	values.resize(numMembers);
+
+	Elite_entry^ mom = pool->sample(rand);
+	if (mom == nullptr)
+	{
+		for (int i = 0; i < numMembers; i++)
+		{
+			values[i] = (char)rand->Next(2);
+		}
+	}
+	else
+	{
+		Elite_entry^ dad = pool->sample(rand);
+		if (dad != nullptr && dad != mom && rand->Next(2) == 1)
+		{
+			//uniform crossover of two elite members
+			for (int i = 0; i < numMembers; i++)
+			{
+				values[i] = (char)(rand->Next(2) == 1 ? mom->assignment[i] : dad->assignment[i]);
+			}
+		}
+		else
+		{
+			for (int i = 0; i < numMembers; i++)
+			{
+				values[i] = (char)mom->assignment[i];
+			}
+		}
+
+		//perturb the copy so workers do not all resume from the same point
+		int len = (int)(numMembers * PERTURBATION) + 1;
+		for (int i = 0; i < len; i++)
+		{
+			int member = rand->Next(numMembers);
+			values[member] = !values[member];
+		}
+	}
+
+	initialize();
+	best_falsified = falsified.size();
+	best_values = values;
+}
+
+/// <summary>
+/// Recomputes true-literal counts, break counts and the falsified list from values.
+/// </summary>
+void Walk_worker::initialize()
+{
+	int numClauses = clauses->size();
+	true_counts.assign(numClauses, 0);
+	true_sums.assign(numClauses, 0);
+	breaks.assign(formula->getNumMembers(), 0);
+	falsified.clear();
+	falsified_pos.assign(numClauses, -1);
+
+	for (int i = 0; i < numClauses; i++)
+	{
+		const vector<int> &clause = (*clauses)[i];
+		//a tautology has no literals here and is never falsified; an empty clause offers nothing to flip
+		if (clause.empty())
+		{
+			continue;
+		}
+		for (unsigned int j = 0; j < clause.size(); j++)
+		{
+			int member = abs(clause[j]) - 1;
+			if ((clause[j] > 0) == (values[member] != 0))
+			{
+				true_counts[i]++;
+				true_sums[i] += member;
+			}
+		}
+		if (true_counts[i] == 0)
+		{
+			falsified_pos[i] = falsified.size();
+			falsified.push_back(i);
+		}
+		else if (true_counts[i] == 1)
+		{
+			breaks[true_sums[i]]++;
+		}
+	}
+}
+
+/// <summary>
+/// Performs one WalkSAT step on a random falsified clause.
+/// </summary>
+void Walk_worker::step(Random ^ rand)
+{
+	const vector<int> &clause = (*clauses)[falsified[rand->Next((int)falsified.size())]];
+
+	//find the members of the clause that break the fewest other clauses
+	int bestBreak = -1;
+	candidates.clear();
+	for (unsigned int j = 0; j < clause.size(); j++)
+	{
+		int member = abs(clause[j]) - 1;
+		if (bestBreak < 0 || breaks[member] < bestBreak)
+		{
+			bestBreak = breaks[member];
+			candidates.clear();
+			candidates.push_back(member);
+		}
+		else if (breaks[member] == bestBreak)
+		{
+			candidates.push_back(member);
+		}
+	}
+
+	//a free move is always taken; otherwise a random member is flipped with probability NOISE
+	if (bestBreak > 0 && rand->NextDouble() < NOISE)
+	{
+		flip(abs(clause[rand->Next((int)clause.size())]) - 1);
+	}
+	else
+	{
+		flip(candidates[rand->Next((int)candidates.size())]);
+	}
+}
+
+/// <summary>
+/// Flips a member, updating true-literal counts and break counts.
+/// </summary>
+/// <param name="member">index of the member to be flipped</param>
+void Walk_worker::flip(int member)
+{
+	values[member] = !values[member];
+	int trueLiteral = values[member] ? member + 1 : -(member + 1);
+
+	const vector<int> &made = formula->getOccurrences(trueLiteral);
+	for (unsigned int i = 0; i < made.size(); i++)
+	{
+		int c = made[i];
+		if (true_counts[c] == 0)
+		{
+			int position = falsified_pos[c];
+			int last = falsified.back();
+			falsified[position] = last;
+			falsified_pos[last] = position;
+			falsified.pop_back();
+			falsified_pos[c] = -1;
+			breaks[member]++;
+		}
+		else if (true_counts[c] == 1)
+		{
+			breaks[true_sums[c]]--;
+		}
+		true_counts[c]++;
+		true_sums[c] += member;
+	}
+
+	const vector<int> &broken = formula->getOccurrences(-trueLiteral);
+	for (unsigned int i = 0; i < broken.size(); i++)
+	{
+		int c = broken[i];
+		true_counts[c]--;
+		true_sums[c] -= member;
+		if (true_counts[c] == 0)
+		{
+			falsified_pos[c] = falsified.size();
+			falsified.push_back(c);
+			breaks[member]--;
+		}
+		else if (true_counts[c] == 1)
+		{
+			breaks[true_sums[c]]++;
+		}
+	}
+}
+
+/// <summary>
+/// Copies an assignment into a managed array for publishing.
+/// </summary>
+array<Byte>^ Walk_worker::snapshot(const vector<char> &assignment)
+{
+	array<Byte>^ copy = gcnew array<Byte>(assignment.size());
+	for (unsigned int i = 0; i < assignment.size(); i++)
+	{
+		copy[i] = assignment[i];
+	}
+	return copy;
+}
+
+/***************************************************
+* Walk_worker functions END
+***************************************************/
+
+/***************************************************
+* Walk_thread functions START
+***************************************************/
+
+/// <summary>
+/// Constructor.
+/// </summary>
+Walk_thread::Walk_thread(Walk_worker *inWorker, Elite_pool^ inPool, int seed, Stopwatch ^ inTimeKeeper, int inMaxTime,
+	Walk_lockstep^ inLockstep, int inIndex)
+{
+	worker = inWorker;
+	pool = inPool;
+	rand = gcnew Random(seed);
+	timeKeeper = inTimeKeeper;
+	maxTime = inMaxTime;
+	lockstep = inLockstep;
+	index = inIndex;
+}
+
+/// <summary>
+/// Runs the worker on the calling thread.
+/// </summary>
+void Walk_thread::Run()
+{
+	worker->run(pool, rand, timeKeeper, maxTime, lockstep, index);
+}
+
+/***************************************************
+* Walk_thread functions END
+***************************************************/
+
+/***************************************************
+* Walk_lockstep functions START
+***************************************************/
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inWorkers">number of workers taking part in every round</param>
+/// <param name="inPool">elite pool shared by all workers</param>
+/// <param name="inTimeKeeper">clock started when the search began</param>
+/// <param name="inMaxTime">time budget in milliseconds</param>
+Walk_lockstep::Walk_lockstep(int inWorkers, Elite_pool^ inPool, Stopwatch ^ inTimeKeeper, int inMaxTime)
+{
+	workers = inWorkers;
+	pool = inPool;
+	timeKeeper = inTimeKeeper;
+	maxTime = inMaxTime;
+	gate = gcnew Object();
+	offers = gcnew array<array<Byte>^>(workers);
+	solutions = gcnew array<array<Byte>^>(workers);
+	offered = gcnew array<int>(workers);
+	arrived = 0;
+	round = 0;
+	finished = false;
+}
+
+/// <summary>
+/// Ends the calling worker's round and waits for the other workers to end theirs.
+/// </summary>
+/// <param name="worker">number of the calling worker</param>
+/// <param name="offer">assignment to publish, or nullptr if the worker has not improved</param>
+/// <param name="unsatisfied">clauses the offered assignment leaves unsatisfied</param>
+/// <param name="solution">satisfying assignment found by the worker, or nullptr</param>
+/// <returns>true once the search is over</returns>
+bool Walk_lockstep::endRound(int worker, array<Byte>^ offer, int unsatisfied, array<Byte>^ solution)
+{
+	Monitor::Enter(gate);
+	try
+	{
+		offers[worker] = offer;
+		offered[worker] = unsatisfied;
+		solutions[worker] = solution;
+		long long current = round;
+		if (++arrived == workers)
+		{
+			closeRound();
+		}
+		else
+		{
+			while (round == current)
+			{
+				Monitor::Wait(gate);
+			}
+		}
+		return finished;
+	}
+	finally
+	{
+		Monitor::Exit(gate);
+	}
+}
+
+/// <summary>
+/// Applies the offers and solutions of a round; called by the last worker to arrive.
+/// </summary>
+void Walk_lockstep::closeRound()
+{
+	for (int w = 0; w < workers; w++)
+	{
+		if (offers[w] != nullptr)
+		{
+			pool->publish(offers[w], offered[w]);
+			offers[w] = nullptr;
+		}
+		if (solutions[w] != nullptr && !finished)
+		{
+			pool->reportSolution(solutions[w]);
+			finished = true;
+		}
+		solutions[w] = nullptr;
+	}
+	if (timeKeeper->ElapsedMilliseconds >= maxTime)
+	{
+		finished = true;
+	}
+	arrived = 0;
+	round++;
+	Monitor::PulseAll(gate);
+}
+
+/***************************************************
+* Walk_lockstep functions END
+***************************************************/
+
+/***************************************************
+* Cooperative_search functions START
+***************************************************/
+
+/// <summary>
+/// Default constructor.
+/// </summary>
+Cooperative_search::Cooperative_search()
+{
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+Cooperative_search::Cooperative_search(SAT_puzzle inPuzzle)
+{
+	baseFormula = std::move(inPuzzle);
+}
+
+/// <summary>
+/// Runs one WalkSAT worker per processor until one satisfies the formula or time runs out.
+/// </summary>
+/// <returns>-1 if the formula was satisfied, otherwise the most clauses satisfied at once.</returns>
+int Cooperative_search::run_Cooperative()
+{
+	Stopwatch ^ timeKeeper = gcnew Stopwatch();
+	timeKeeper->Start();
+
+	//clause literals are deduplicated once and shared read-only by every worker
+	int numClauses = baseFormula.getNumClauses();
+	vector<vector<int>> clauses(numClauses);
+	for (int i = 0; i < numClauses; i++)
+	{
+		baseFormula.getDistinctLiterals(i, clauses[i]);
+	}
+
+	//workers are seeded apart, since time-seeded generators created together would all match
+	int numWorkers = Environment::ProcessorCount;
+	int clockSeed = Environment::TickCount;
+	Elite_pool^ pool = gcnew Elite_pool(POOLSIZE);
+	Walk_lockstep^ lockstep = (seed < 0) ? nullptr : gcnew Walk_lockstep(numWorkers, pool, timeKeeper, MAXTIME);
+	vector<Walk_worker*> workers(numWorkers);
+	array<Thread^>^ threads = gcnew array<Thread^>(numWorkers);
+	for (int w = 0; w < numWorkers; w++)
+	{
+		workers[w] = new Walk_worker(&baseFormula, &clauses, progress == nullptr ? nullptr : &progress[w]);
+		int workerRandom = (seed < 0) ? clockSeed + w : workerSeed(seed, w);
+		Walk_thread^ entry = gcnew Walk_thread(workers[w], pool, workerRandom, timeKeeper, MAXTIME, lockstep, w);
+		threads[w] = gcnew Thread(gcnew ThreadStart(entry, &Walk_thread::Run));
+		threads[w]->Start();
+	}
+	for (int w = 0; w < numWorkers; w++)
+	{
+		threads[w]->Join();
+		delete workers[w];
+	}
+	timeKeeper->Stop();
+
+	//leave the solution, or the best elite member, in the formula so it can be reported
+	array<Byte>^ result = pool->getSolution();
+	if (result == nullptr && pool->getBest() != nullptr)
+	{
+		result = pool->getBest()->assignment;
+	}
+	if (result != nullptr)
+	{
+		for (int i = 0; i < baseFormula.getNumMembers(); i++)
+		{
+			baseFormula.setMemberAtIndex(i, result[i] != 0);
+		}
+	}
+
+	int num_trues = baseFormula.check_trues();
+	if (baseFormula.satisfied())
+	{
+		return -1;
+	}
+	else { return num_trues; }
+}
+
+/// <summary>
+/// checks to see if the formula has been solved or not.
+/// </summary>
+/// <returns>returns true if solved, false if not</returns>
+bool Cooperative_search::formulaSolved()
+{
+	return baseFormula.satisfied();
+}
+
+/// <summary>
+/// Gets the formula holding the best assignment found by the search.
+/// </summary>
+/// <returns>the SAT_puzzle object being solved</returns>
+const SAT_puzzle& Cooperative_search::getFormula()
+{
+	return baseFormula;
+}
+
+/// <summary>
+/// Sets where the workers publish their progress for telemetry.
+/// </summary>
+/// <param name="records">one progress record per processor, owned by the caller, or nullptr for none</param>
+void Cooperative_search::setProgress(Search_progress *records)
+{
+	progress = records;
+}
+
+/// <summary>
+/// Sets the master seed.  A non-negative seed also runs the workers in lockstep, so the same
+/// seed and processor count repeat the same search.  Meeting every PUBLISHPERIOD flips makes
+/// each round as slow as its slowest worker.  A run cut off by the clock is a prefix of the
+/// repeatable one, so budgets meant for replay should be generous.
+/// </summary>
+/// <param name="inSeed">master seed for subsequent runs; a negative seed draws from the clock</param>
+void Cooperative_search::setSeed(int inSeed)
+{
+	seed = inSeed;
+}
+
+/// <summary>
+/// Derives the seed of a worker from the master seed by a SplitMix64 step, so neighbouring
+/// master seeds or workers do not get correlated streams.
+/// </summary>
+/// <param name="master">master seed</param>
+/// <param name="worker">number of the worker</param>
+/// <returns>a non-negative seed</returns>
+int Cooperative_search::workerSeed(int master, int worker)
+{
+	unsigned long long z = (unsigned long long)master + (unsigned long long)(worker + 1) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z = z ^ (z >> 31);
+	return (int)(z & 0x7FFFFFFF);
+}
+
+/***************************************************
+* Cooperative_search functions END
+***************************************************/
@@ -0,0 +1,240 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SAT_puzzle.h"
+#include "Elite_pool.h"
+#include "Telemetry.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+using namespace System::Diagnostics;
+using namespace System::Threading;
+
+ref class Walk_lockstep;
+
+/// <summary>
+/// Per-thread WalkSAT state with incrementally maintained break counts.
+/// The formula and clause lists are shared read-only between all workers.
+/// </summary>
+class Walk_worker
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inFormula">shared formula, used for its occurrence lists</param>
+	/// <param name="inClauses">shared clause literals with repeats removed, and none for a tautology</param>
+	/// <param name="inProgress">progress record of this worker, or nullptr for none</param>
+	Walk_worker(SAT_puzzle *inFormula, const vector<vector<int>> *inClauses, Search_progress *inProgress);
+
+	/// <summary>
+	/// Runs WalkSAT steps until the formula is solved by any worker or time runs out.
+	/// Improvements are published to the pool, and stagnating runs restart from elite members.
+	/// </summary>
+	/// <param name="pool">elite pool shared by all workers</param>
+	/// <param name="rand">random number source owned by this worker</param>
+	/// <param name="timeKeeper">clock started when the search began</param>
+	/// <param name="maxTime">time budget in milliseconds</param>
+	/// <param name="lockstep">rounds the workers meet at, or nullptr to run freely</param>
+	/// <param name="index">number of this worker, which orders its offers within a round</param>
+	void run(Elite_pool^ pool, Random ^ rand, Stopwatch ^ timeKeeper, int maxTime, Walk_lockstep^ lockstep, int index);
+
+private:
+
+	/// <summary>
+	/// Chooses the starting assignment for a restart: a crossover of two elite members or a
+	/// perturbed copy of one, or a random assignment while the pool is still empty.
+	/// </summary>
+	void restart(Elite_pool^ pool, Random ^ rand);
+
+	/// <summary>
+	/// Recomputes true-literal counts, break counts and the falsified list from values.
+	/// </summary>
+	void initialize();
+
+	/// <summary>
+	/// Performs one WalkSAT step on a random falsified clause.
+	/// </summary>
+	void step(Random ^ rand);
+
+	/// <summary>
+	/// Flips a member, updating true-literal counts and break counts.
+	/// </summary>
+	/// <param name="member">index of the member to be flipped</param>
+	void flip(int member);
+
+	/// <summary>
+	/// Copies an assignment into a managed array for publishing.
+	/// </summary>
+	array<Byte>^ snapshot(const vector<char> &assignment);
+
+	SAT_puzzle *formula;
+	const vector<vector<int>> *clauses;
+	Search_progress *progress;
+
+	//probability of a random walk move when every member of the clause would break another
+	double NOISE = 0.5;
+	//flips between visits to the shared pool, and flips without improvement before a restart
+	int PUBLISHPERIOD = 4096;
+	int STAGNATION = 200000;
+	//fraction of members flipped when a restart perturbs an elite assignment
+	double PERTURBATION = 0.05;
+
+	vector<char> values, best_values;
+	vector<int> true_counts, true_sums, breaks;
+	vector<int> falsified, falsified_pos, candidates;
+	unsigned int best_falsified;
+};
+
+/// <summary>
+/// Thread entry point wrapping a Walk_worker, since thread delegates must bind to managed classes.
+/// </summary>
+ref class Walk_thread
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	Walk_thread(Walk_worker *inWorker, Elite_pool^ inPool, int seed, Stopwatch ^ inTimeKeeper, int inMaxTime,
+		Walk_lockstep^ inLockstep, int inIndex);
+
+	/// <summary>
+	/// Runs the worker on the calling thread.
+	/// </summary>
+	void Run();
+
+private:
+	Walk_worker *worker;
+	Elite_pool^ pool;
+	Random ^ rand;
+	Stopwatch ^ timeKeeper;
+	int maxTime;
+	Walk_lockstep^ lockstep;
+	int index;
+};
+
+/// <summary>
+/// Rounds at which workers of a repeatable search meet.  Each worker ends a round every
+/// PUBLISHPERIOD flips; the last to arrive publishes the round's offers to the pool in worker
+/// order, keeps the solution of the lowest-numbered solver, and reads the clock once for all.
+/// Between rounds the pool is not written, so what a restart samples depends only on the seeds.
+/// </summary>
+ref class Walk_lockstep
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inWorkers">number of workers taking part in every round</param>
+	/// <param name="inPool">elite pool shared by all workers</param>
+	/// <param name="inTimeKeeper">clock started when the search began</param>
+	/// <param name="inMaxTime">time budget in milliseconds</param>
+	Walk_lockstep(int inWorkers, Elite_pool^ inPool, Stopwatch ^ inTimeKeeper, int inMaxTime);
+
+	/// <summary>
+	/// Ends the calling worker's round and waits for the other workers to end theirs.
+	/// </summary>
+	/// <param name="worker">number of the calling worker</param>
+	/// <param name="offer">assignment to publish, or nullptr if the worker has not improved</param>
+	/// <param name="unsatisfied">clauses the offered assignment leaves unsatisfied</param>
+	/// <param name="solution">satisfying assignment found by the worker, or nullptr</param>
+	/// <returns>true once the search is over</returns>
+	bool endRound(int worker, array<Byte>^ offer, int unsatisfied, array<Byte>^ solution);
+
+private:
+
+	/// <summary>
+	/// Applies the offers and solutions of a round; called by the last worker to arrive.
+	/// </summary>
+	void closeRound();
+
+	int workers;
+	Elite_pool^ pool;
+	Stopwatch ^ timeKeeper;
+	int maxTime;
+
+	//guards everything below; waited on by the workers that arrive early
+	Object^ gate;
+	array<array<Byte>^>^ offers;
+	array<array<Byte>^>^ solutions;
+	array<int>^ offered;
+	int arrived;
+	long long round;
+	bool finished;
+};
+
+/// <summary>
+/// Class containing the necessary data structures and methods to
+/// solve a SAT formula through use of cooperating WalkSAT threads.
+/// Each thread searches independently, but threads share their best assignments through a
+/// lock-free elite pool and restart from those instead of from random assignments.
+/// </summary>
+class Cooperative_search
+{
+public:
+
+	/// <summary>
+	/// Default constructor.
+	/// </summary>
+	Cooperative_search();
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+	Cooperative_search(SAT_puzzle inPuzzle);
+
+	/// <summary>
+	/// Runs one WalkSAT worker per processor until one satisfies the formula or time runs out.
+	/// </summary>
+	/// <returns>-1 if the formula was satisfied, otherwise the most clauses satisfied at once.</returns>
+	int run_Cooperative();
+
+	/// <summary>
+	/// checks to see if the formula has been solved or not.
+	/// </summary>
+	/// <returns>returns true if solved, false if not</returns>
+	bool formulaSolved();
+
+	/// <summary>
+	/// Gets the formula holding the best assignment found by the search.
+	/// </summary>
+	/// <returns>the SAT_puzzle object being solved</returns>
+	const SAT_puzzle& getFormula();
+
+	/// <summary>
+	/// Sets where the workers publish their progress for telemetry.
+	/// </summary>
+	/// <param name="records">one progress record per processor, owned by the caller, or nullptr for none</param>
+	void setProgress(Search_progress *records);
+
+	/// <summary>
+	/// Sets the master seed.  A non-negative seed also runs the workers in lockstep, so the same
+	/// seed and processor count repeat the same search.  Meeting every PUBLISHPERIOD flips makes
+	/// each round as slow as its slowest worker.  A run cut off by the clock is a prefix of the
+	/// repeatable one, so budgets meant for replay should be generous.
+	/// </summary>
+	/// <param name="inSeed">master seed for subsequent runs; a negative seed draws from the clock</param>
+	void setSeed(int inSeed);
+
+private:
+
+	/// <summary>
+	/// Derives the seed of a worker from the master seed by a SplitMix64 step, so neighbouring
+	/// master seeds or workers do not get correlated streams.
+	/// </summary>
+	/// <param name="master">master seed</param>
+	/// <param name="worker">number of the worker</param>
+	/// <returns>a non-negative seed</returns>
+	static int workerSeed(int master, int worker);
+
+	SAT_puzzle baseFormula;
+	int MAXTIME = 10000;
+	Search_progress *progress = nullptr;
+	int seed = -1;
+	int POOLSIZE = 8;
+};
@@ -0,0 +1,514 @@
+#include "stdafx.h"
+#include "Cube_conquer.h"
+
+/***************************************************
+* Cube_splitter functions START
+***************************************************/
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inSolver">solver whose propagation is used for lookahead</param>
+Cube_splitter::Cube_splitter(DPLL *inSolver)
+{
+	solver = inSolver;
+}
+
+/// <summary>
+/// Splits the formula into at most 2^depth cubes.
+/// </summary>
+/// <param name="depth">maximum number of branching members per cube</param>
+/// <returns>the cubes; an empty list means propagation refuted the formula</returns>
+vector<vector<int>> Cube_splitter::split(int depth)
+{
+	cubes.clear();
+	vector<int> cube;
+	solver->backtrack(0);
+	splitNode(depth, cube);
+	solver->backtrack(0);
+	return cubes;
+}
+
+/// <summary>
+/// Splits the node reached by the literals in cube.
+/// </summary>
+void Cube_splitter::splitNode(int depth, vector<int> &cube)
+{
+	int nodeLevel = solver->decisionLevel();
+	unsigned int nodeSize = cube.size();
+
+	int branch = 0;
+	if (depth > 0)
+	{
+		//evaluate the most frequent free members both ways; a literal that fails by itself
+		// forces its negation, which is added to the cube before the scan continues
+		vector<int> candidates = solver->unassignedMembers(CANDIDATES);
+		vector<long long> scores(candidates.size(), -1);
+		for (unsigned int i = 0; i < candidates.size(); i++)
+		{
+			int member = candidates[i];
+			if (solver->value(member) >= 0)
+			{
+				continue;
+			}
+			int positive = lookahead(member);
+			int negative = lookahead(-member);
+			if (positive < 0 && negative < 0)
+			{
+				solver->backtrack(nodeLevel);
+				cube.resize(nodeSize);
+				return;
+			}
+			if (positive < 0 || negative < 0)
+			{
+				int forced = (positive < 0) ? -member : member;
+				cube.push_back(forced);
+				if (!solver->assume(forced))
+				{
+					solver->backtrack(nodeLevel);
+					cube.resize(nodeSize);
+					return;
+				}
+				continue;
+			}
+			//favour members that simplify both branches, not just one
+			scores[i] = (long long)(positive + 1) * (negative + 1);
+		}
+
+		//the branch is picked only once the scan is done, as a literal forced late in it may
+		// assign a candidate scored earlier
+		long long bestScore = -1;
+		for (unsigned int i = 0; i < candidates.size(); i++)
+		{
+			if (scores[i] > bestScore && solver->value(candidates[i]) < 0)
+			{
+				bestScore = scores[i];
+				branch = candidates[i];
+			}
+		}
+	}
+
+	if (branch == 0)
+	{
+		cubes.push_back(cube);
+	}
+	else
+	{
+		int branchLevel = solver->decisionLevel();
+		for (int side = 0; side < 2; side++)
+		{
+			int literal = (side == 0) ? branch : -branch;
+			cube.push_back(literal);
+			if (solver->assume(literal))
+			{
+				splitNode(depth - 1, cube);
+			}
+			solver->backtrack(branchLevel);
+			cube.pop_back();
+		}
+	}
+
+	solver->backtrack(nodeLevel);
+	cube.resize(nodeSize);
+}
+
+/// <summary>
+/// Measures how many members become assigned when literal is set.
+/// </summary>
+/// <returns>the number of new assignments, or -1 if the literal fails</returns>
+int Cube_splitter::lookahead(int literal)
+{
+	int level = solver->decisionLevel();
+	int before = solver->numAssigned();
+	bool consistent = solver->assume(literal);
+	int assigned = solver->numAssigned() - before;
+	solver->backtrack(level);
+	return consistent ? assigned : -1;
+}
+
+/***************************************************
+* Cube_splitter functions END
+***************************************************/
+
+/***************************************************
+* Cube_queue functions START
+***************************************************/
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inCount">number of cubes</param>
+/// <param name="inMaxTime">time budget for the whole run in milliseconds</param>
+Cube_queue::Cube_queue(int inCount, int inMaxTime)
+{
+	count = inCount;
+	next = -1;
+	unsatisfiable = 0;
+	unknown = 0;
+	stopped = 0;
+	solution = nullptr;
+	maxTime = inMaxTime;
+	timeKeeper = gcnew Stopwatch();
+	timeKeeper->Start();
+}
+
+/// <summary>
+/// Takes the next unsolved cube.
+/// </summary>
+/// <returns>the cube index, or -1 once every cube is taken or the run has stopped</returns>
+int Cube_queue::take()
+{
+	if (isStopped())
+	{
+		return -1;
+	}
+	int index = Interlocked::Increment(next);
+	return index < count ? index : -1;
+}
+
+/// <summary>
+/// Gets the time left in the run.
+/// </summary>
+/// <returns>milliseconds remaining</returns>
+int Cube_queue::remainingTime()
+{
+	return maxTime - (int)timeKeeper->ElapsedMilliseconds;
+}
+
+/// <summary>
+/// Records a cube refuted by a worker.
+/// </summary>
+void Cube_queue::recordUnsatisfiable()
+{
+	Interlocked::Increment(unsatisfiable);
+}
+
+/// <summary>
+/// Records a cube whose worker ran out of time or exited.
+/// </summary>
+void Cube_queue::recordUnknown()
+{
+	Interlocked::Increment(unknown);
+}
+
+/// <summary>
+/// Records the first satisfying reply and stops the run.
+/// </summary>
+/// <param name="reply">the worker's reply line, including the model</param>
+void Cube_queue::recordSolution(String^ reply)
+{
+	Interlocked::CompareExchange<String^>(solution, reply, nullptr);
+	Interlocked::Exchange(stopped, 1);
+}
+
+/// <summary>
+/// checks to see if a solution has been found.
+/// </summary>
+/// <returns>true once the run has stopped</returns>
+bool Cube_queue::isStopped()
+{
+	return Thread::VolatileRead(stopped) != 0;
+}
+
+/// <summary>
+/// Gets the number of cubes refuted so far.
+/// </summary>
+/// <returns></returns>
+int Cube_queue::getUnsatisfiable()
+{
+	return Thread::VolatileRead(unsatisfiable);
+}
+
+/// <summary>
+/// Gets the satisfying reply, if there was one.
+/// </summary>
+/// <returns>the reply line, or nullptr</returns>
+String^ Cube_queue::getSolution()
+{
+	return solution;
+}
+
+/***************************************************
+* Cube_queue functions END
+***************************************************/
+
+/***************************************************
+* Cube_client functions START
+***************************************************/
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inWorker">worker process with redirected standard input and output</param>
+/// <param name="inQueue">queue shared by all clients</param>
+Cube_client::Cube_client(Process^ inWorker, Cube_queue^ inQueue)
+{
+	worker = inWorker;
+	queue = inQueue;
+}
+
+/// <summary>
+/// Sends cubes to the worker until the queue is empty or the run stops.
+/// </summary>
+void Cube_client::Run()
+{
+	int index = queue->take();
+	while (index >= 0)
+	{
+		int budget = queue->remainingTime();
+		String^ reply = nullptr;
+		if (budget > 0)
+		{
+			//a killed or crashed worker shows up as a failed write or a null reply
+			try
+			{
+				worker->StandardInput->WriteLine(index.ToString() + " " + budget.ToString());
+				worker->StandardInput->Flush();
+				reply = worker->StandardOutput->ReadLine();
+			}
+			catch (Exception^ pipe_error)
+			{
+				reply = nullptr;
+			}
+		}
+
+		if (reply != nullptr && reply->StartsWith("SAT "))
+		{
+			queue->recordSolution(reply);
+		}
+		else if (reply != nullptr && reply->StartsWith("UNSAT "))
+		{
+			queue->recordUnsatisfiable();
+		}
+		else
+		{
+			queue->recordUnknown();
+			if (reply == nullptr)
+			{
+				break;
+			}
+		}
+		index = queue->take();
+	}
+
+	try
+	{
+		worker->StandardInput->WriteLine("quit");
+		worker->StandardInput->Flush();
+	}
+	catch (Exception^ pipe_error)
+	{
+	}
+}
+
+/***************************************************
+* Cube_client functions END
+***************************************************/
+
+/***************************************************
+* Cube_conquer functions START
+***************************************************/
+
+/// <summary>
+/// Default constructor.
+/// </summary>
+Cube_conquer::Cube_conquer()
+{
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+Cube_conquer::Cube_conquer(SAT_puzzle inPuzzle)
+{
+	baseFormula = std::move(inPuzzle);
+}
+
+/// <summary>
+/// Splits the formula, solves the cubes in worker processes and combines the verdicts.
+/// </summary>
+/// <returns>-1 if satisfied, DPLL::UNSATISFIABLE if every cube was refuted, otherwise the clauses satisfied by the starting assignment.</returns>
+int Cube_conquer::run_CubeConquer()
+{
+	DPLL splitSolver(baseFormula);
+	Cube_splitter splitter(&splitSolver);
+	vector<vector<int>> cubes = splitter.split(DEPTH);
+	if (cubes.empty())
+	{
+		return DPLL::UNSATISFIABLE;
+	}
+	Console::WriteLine(((int)cubes.size()).ToString() + " cubes generated.");
+
+	//the workers read the formula as it currently stands (after any reordering) and the cubes
+	// from temporary files, one cube per line in the iCNF "a ... 0" form
+	String^ cnfFile = Path::GetTempFileName();
+	String^ cubeFile = Path::GetTempFileName();
+	baseFormula.writeToFile(cnfFile);
+	StreamWriter^ cube_out = gcnew StreamWriter(cubeFile);
+	for (unsigned int i = 0; i < cubes.size(); i++)
+	{
+		cube_out->Write("a");
+		for (unsigned int j = 0; j < cubes[i].size(); j++)
+		{
+			cube_out->Write(" " + cubes[i][j].ToString());
+		}
+		cube_out->WriteLine(" 0");
+	}
+	cube_out->Close();
+
+	Cube_queue^ queue = gcnew Cube_queue(cubes.size(), MAXTIME);
+	int numWorkers = Math::Min(Environment::ProcessorCount, (int)cubes.size());
+	array<Process^>^ workers = gcnew array<Process^>(numWorkers);
+	array<Thread^>^ clients = gcnew array<Thread^>(numWorkers);
+	for (int w = 0; w < numWorkers; w++)
+	{
+		ProcessStartInfo^ info = gcnew ProcessStartInfo(Process::GetCurrentProcess()->MainModule->FileName,
+			"--cube-worker \"" + cnfFile + "\" \"" + cubeFile + "\"");
+		info->UseShellExecute = false;
+		info->RedirectStandardInput = true;
+		info->RedirectStandardOutput = true;
+		info->CreateNoWindow = true;
+		workers[w] = Process::Start(info);
+		clients[w] = gcnew Thread(gcnew ThreadStart(gcnew Cube_client(workers[w], queue), &Cube_client::Run));
+		clients[w]->Start();
+	}
+
+	//once a cube is satisfied or time is up, the remaining workers are killed, which also
+	// releases any client blocked reading from them
+	bool running = true;
+	while (running)
+	{
+		running = false;
+		for (int w = 0; w < numWorkers; w++)
+		{
+			if (!clients[w]->Join(50))
+			{
+				running = true;
+			}
+		}
+		if (running && (queue->isStopped() || queue->remainingTime() <= 0))
+		{
+			for (int w = 0; w < numWorkers; w++)
+			{
+				try
+				{
+					if (!workers[w]->HasExited)
+					{
+						workers[w]->Kill();
+					}
+				}
+				catch (Exception^ kill_error)
+				{
+				}
+			}
+		}
+	}
+	File::Delete(cnfFile);
+	File::Delete(cubeFile);
+
+	String^ solution = queue->getSolution();
+	if (solution != nullptr)
+	{
+		//reply format: SAT index literal literal ...
+		array<String^>^ token = solution->Split(' ');
+		for (int i = 2; i < token->Length; i++)
+		{
+			int literal = int::Parse(token[i]);
+			if (literal != 0)
+			{
+				baseFormula.setMemberAtIndex(Math::Abs(literal) - 1, literal > 0);
+			}
+		}
+		baseFormula.check_trues();
+		if (baseFormula.satisfied())
+		{
+			return -1;
+		}
+	}
+	if (queue->getUnsatisfiable() == (int)cubes.size())
+	{
+		return DPLL::UNSATISFIABLE;
+	}
+	return baseFormula.check_trues();
+}
+
+/// <summary>
+/// Gets the formula holding the model found by the search.
+/// </summary>
+/// <returns>the SAT_puzzle object being solved</returns>
+const SAT_puzzle& Cube_conquer::getFormula()
+{
+	return baseFormula;
+}
+
+/// <summary>
+/// Entry point of a worker process.  Loads the formula and cubes once, then answers
+/// requests of the form "index budget" read from standard input with
+/// "SAT index literals...", "UNSAT index" or "UNKNOWN index".
+/// </summary>
+/// <param name="cnfFile">formula file written by the parent</param>
+/// <param name="cubeFile">cube file written by the parent</param>
+/// <returns>process exit code</returns>
+int Cube_conquer::runWorker(String^ cnfFile, String^ cubeFile)
+{
+	SAT_puzzle formula(cnfFile);
+	DPLL solver(formula);
+
+	vector<vector<int>> cubes;
+	StreamReader^ cube_in = gcnew StreamReader(cubeFile);
+	String^ line_in = cube_in->ReadLine();
+	while (line_in != nullptr)
+	{
+		array<String^>^ token = line_in->Split(gcnew array<Char>{' '}, StringSplitOptions::RemoveEmptyEntries);
+		vector<int> cube;
+		for (int i = 1; i < token->Length; i++)
+		{
+			int literal = int::Parse(token[i]);
+			if (literal != 0)
+			{
+				cube.push_back(literal);
+			}
+		}
+		cubes.push_back(cube);
+		line_in = cube_in->ReadLine();
+	}
+	cube_in->Close();
+
+	//the watched clause database is kept between cubes; only the assumptions change
+	String^ request = Console::ReadLine();
+	while (request != nullptr && request != "quit")
+	{
+		array<String^>^ token = request->Split(' ');
+		int index = int::Parse(token[0]);
+		solver.setMaxTime(int::Parse(token[1]));
+		int result = solver.run_DPLL(cubes[index]);
+
+		if (result == -1)
+		{
+			const vector<bool> &model = solver.getFormula().getMemberList();
+			Text::StringBuilder^ reply = gcnew Text::StringBuilder("SAT " + index.ToString());
+			for (unsigned int i = 0; i < model.size(); i++)
+			{
+				int literal = model[i] ? (int)i + 1 : -((int)i + 1);
+				reply->Append(" " + literal.ToString());
+			}
+			Console::WriteLine(reply->ToString());
+		}
+		else if (result == DPLL::UNSATISFIABLE)
+		{
+			Console::WriteLine("UNSAT " + index.ToString());
+		}
+		else
+		{
+			Console::WriteLine("UNKNOWN " + index.ToString());
+		}
+		Console::Out->Flush();
+		request = Console::ReadLine();
+	}
+	return 0;
+}
+
+/***************************************************
+* Cube_conquer functions END
+***************************************************/
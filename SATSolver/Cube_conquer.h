@@ -0,0 +1,196 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SAT_puzzle.h"
+#include "DPLL.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+using namespace System::Diagnostics;
+using namespace System::Threading;
+
+/// <summary>
+/// Splits a formula into cubes (partial assignments) by lookahead.  At each node the most
+/// frequent unassigned members are propagated both ways, and the member whose two branches
+/// assign the most is chosen.  Branches refuted by propagation are dropped on the spot.
+/// </summary>
+class Cube_splitter
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inSolver">solver whose propagation is used for lookahead</param>
+	Cube_splitter(DPLL *inSolver);
+
+	/// <summary>
+	/// Splits the formula into at most 2^depth cubes.
+	/// </summary>
+	/// <param name="depth">maximum number of branching members per cube</param>
+	/// <returns>the cubes; an empty list means propagation refuted the formula</returns>
+	vector<vector<int>> split(int depth);
+
+private:
+
+	/// <summary>
+	/// Splits the node reached by the literals in cube.
+	/// </summary>
+	void splitNode(int depth, vector<int> &cube);
+
+	/// <summary>
+	/// Measures how many members become assigned when literal is set.
+	/// </summary>
+	/// <returns>the number of new assignments, or -1 if the literal fails</returns>
+	int lookahead(int literal);
+
+	DPLL *solver;
+	vector<vector<int>> cubes;
+	//number of members evaluated by lookahead at each node
+	int CANDIDATES = 16;
+};
+
+/// <summary>
+/// Queue of cubes shared by the threads that drive the worker processes.
+/// </summary>
+ref class Cube_queue
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inCount">number of cubes</param>
+	/// <param name="inMaxTime">time budget for the whole run in milliseconds</param>
+	Cube_queue(int inCount, int inMaxTime);
+
+	/// <summary>
+	/// Takes the next unsolved cube.
+	/// </summary>
+	/// <returns>the cube index, or -1 once every cube is taken or the run has stopped</returns>
+	int take();
+
+	/// <summary>
+	/// Gets the time left in the run.
+	/// </summary>
+	/// <returns>milliseconds remaining</returns>
+	int remainingTime();
+
+	/// <summary>
+	/// Records a cube refuted by a worker.
+	/// </summary>
+	void recordUnsatisfiable();
+
+	/// <summary>
+	/// Records a cube whose worker ran out of time or exited.
+	/// </summary>
+	void recordUnknown();
+
+	/// <summary>
+	/// Records the first satisfying reply and stops the run.
+	/// </summary>
+	/// <param name="reply">the worker's reply line, including the model</param>
+	void recordSolution(String^ reply);
+
+	/// <summary>
+	/// checks to see if a solution has been found.
+	/// </summary>
+	/// <returns>true once the run has stopped</returns>
+	bool isStopped();
+
+	/// <summary>
+	/// Gets the number of cubes refuted so far.
+	/// </summary>
+	/// <returns></returns>
+	int getUnsatisfiable();
+
+	/// <summary>
+	/// Gets the satisfying reply, if there was one.
+	/// </summary>
+	/// <returns>the reply line, or nullptr</returns>
+	String^ getSolution();
+
+private:
+	int count, next, unsatisfiable, unknown, stopped;
+	String^ solution;
+	Stopwatch ^ timeKeeper;
+	int maxTime;
+};
+
+/// <summary>
+/// Feeds cubes to one worker process over its standard input and reads the verdicts back
+/// from its standard output.
+/// </summary>
+ref class Cube_client
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inWorker">worker process with redirected standard input and output</param>
+	/// <param name="inQueue">queue shared by all clients</param>
+	Cube_client(Process^ inWorker, Cube_queue^ inQueue);
+
+	/// <summary>
+	/// Sends cubes to the worker until the queue is empty or the run stops.
+	/// </summary>
+	void Run();
+
+private:
+	Process^ worker;
+	Cube_queue^ queue;
+};
+
+/// <summary>
+/// Class containing the necessary data structures and methods to
+/// solve a SAT formula through use of cube-and-conquer.
+/// The formula is split into cubes by lookahead, and a pool of local worker processes
+/// solves the cubes with DPLL.  The first satisfiable cube gives a model, and a refutation
+/// of every cube proves the formula unsatisfiable.
+/// </summary>
+class Cube_conquer
+{
+public:
+
+	/// <summary>
+	/// Default constructor.
+	/// </summary>
+	Cube_conquer();
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+	Cube_conquer(SAT_puzzle inPuzzle);
+
+	/// <summary>
+	/// Splits the formula, solves the cubes in worker processes and combines the verdicts.
+	/// </summary>
+	/// <returns>-1 if satisfied, DPLL::UNSATISFIABLE if every cube was refuted, otherwise the clauses satisfied by the starting assignment.</returns>
+	int run_CubeConquer();
+
+	/// <summary>
+	/// Gets the formula holding the model found by the search.
+	/// </summary>
+	/// <returns>the SAT_puzzle object being solved</returns>
+	const SAT_puzzle& getFormula();
+
+	/// <summary>
+	/// Entry point of a worker process.  Loads the formula and cubes once, then answers
+	/// requests of the form "index budget" read from standard input with
+	/// "SAT index literals...", "UNSAT index" or "UNKNOWN index".
+	/// </summary>
+	/// <param name="cnfFile">formula file written by the parent</param>
+	/// <param name="cubeFile">cube file written by the parent</param>
+	/// <returns>process exit code</returns>
+	static int runWorker(String^ cnfFile, String^ cubeFile);
+
+private:
+
+	SAT_puzzle baseFormula;
+	//hard instances are the point of this mode, so it gets a longer budget than the others
+	int MAXTIME = 600000;
+	int DEPTH = 10;
+};
@@ -0,0 +1,715 @@
+#include "stdafx.h"
+#include <algorithm>
+#include "DPLL.h"
+
+/// <summary>
+/// Orders members by decreasing number of occurrences, breaking ties by index.
+/// </summary>
+struct Occurrence_greater
+{
+	const vector<int> *counts;
+
+	bool operator()(int a, int b) const
+	{
+		return (*counts)[a] > (*counts)[b] || ((*counts)[a] == (*counts)[b] && a < b);
+	}
+};
+
+/***************************************************
+* public functions START
+***************************************************/
+
+/// <summary>
+/// Default constructor.
+/// </summary>
+DPLL::DPLL()
+{
+	qhead = 0;
+	order_head = 0;
+	ok = true;
+	logging = false;
+	next_id = 0;
+	last_lemma = 0;
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+DPLL::DPLL(SAT_puzzle inPuzzle)
+{
+	baseFormula = std::move(inPuzzle);
+	logging = false;
+	load();
+}
+
+/// <summary>
+/// Constructor that logs a proof of unsatisfiability.
+/// Lemmas use the member numbering of inPuzzle, so it should not have been renumbered.
+/// </summary>
+/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+/// <param name="inProof">writer receiving a DRAT or LRAT lemma for each conflict</param>
+DPLL::DPLL(SAT_puzzle inPuzzle, Proof_writer^ inProof)
+{
+	baseFormula = std::move(inPuzzle);
+	proof = inProof;
+	logging = true;
+	load();
+}
+
+/// <summary>
+/// Runs the DPLL algorithm
+/// </summary>
+/// <returns>-1 if satisfied, UNSATISFIABLE if proven unsatisfiable, otherwise the clauses satisfied when time ran out.</returns>
+int DPLL::run_DPLL()
+{
+	vector<int> assumptions;
+	return run_DPLL(assumptions);
+}
+
+/// <summary>
+/// Runs the DPLL algorithm with some literals fixed to true.
+/// </summary>
+/// <param name="assumptions">literals, numbered as in the file, that must hold in any solution</param>
+/// <returns>-1 if satisfied, UNSATISFIABLE if no solution extends the assumptions, otherwise the clauses satisfied when time ran out.</returns>
+int DPLL::run_DPLL(const vector<int> &assumptions)
+{
+	int result = search(assumptions);
+
+	//copy the reached assignment into the formula; unassigned members are left false
+	for (int i = 0; i < baseFormula.getNumMembers(); i++)
+	{
+		baseFormula.setMemberAtIndex(i, values[i] == 1);
+	}
+	int num_trues = baseFormula.check_trues();
+	if (result == -1)
+	{
+		//the next run, e.g. after more clauses are added, starts from this solution's phases
+		for (int i = 0; i < baseFormula.getNumMembers(); i++)
+		{
+			polarity[i] = values[i] == 1;
+		}
+		return -1;
+	}
+	else if (result == UNSATISFIABLE)
+	{
+		return UNSATISFIABLE;
+	}
+	else { return num_trues; }
+}
+
+/// <summary>
+/// checks to see if the formula has been solved or not.
+/// </summary>
+/// <returns>returns true if solved, false if not</returns>
+bool DPLL::formulaSolved()
+{
+	return baseFormula.satisfied();
+}
+
+/// <summary>
+/// Gets the formula holding the assignment reached by the search.
+/// </summary>
+/// <returns>the SAT_puzzle object being solved</returns>
+const SAT_puzzle& DPLL::getFormula()
+{
+	return baseFormula;
+}
+
+/// <summary>
+/// Sets the time budget for subsequent runs.
+/// </summary>
+/// <param name="maxTime">time budget in milliseconds</param>
+void DPLL::setMaxTime(int maxTime)
+{
+	MAXTIME = maxTime;
+}
+
+/// <summary>
+/// Sets a flag that ends a run early, as if time had run out, once another thread makes it nonzero.
+/// </summary>
+/// <param name="flag">flag owned by the caller, or nullptr for none</param>
+void DPLL::setStopFlag(const volatile int *flag)
+{
+	stop = flag;
+}
+
+/// <summary>
+/// Adds a clause between runs.  Everything learned at level 0 is kept, so a sequence of
+/// related runs does not repeat the propagation done by earlier ones.
+/// </summary>
+/// <param name="literals">literals of the clause, numbered as in the file, without the terminating 0</param>
+void DPLL::addClause(const vector<int> &literals)
+{
+	backtrack(0);
+	baseFormula.addClause(literals);
+	if ((int)values.size() < baseFormula.getNumMembers())
+	{
+		growMembers(baseFormula.getNumMembers());
+	}
+	if (!ok)
+	{
+		return;
+	}
+
+	//level 0 is never undone, so literals false there can be left out of the stored clause
+	vector<int> clause;
+	for (unsigned int i = 0; i < literals.size(); i++)
+	{
+		int literal = literals[i];
+		if (value(literal) == 1 || find(clause.begin(), clause.end(), -literal) != clause.end())
+		{
+			return;
+		}
+		if (value(literal) < 0 && find(clause.begin(), clause.end(), literal) == clause.end())
+		{
+			clause.push_back(literal);
+		}
+	}
+
+	if (clause.empty())
+	{
+		ok = false;
+	}
+	else if (clause.size() == 1)
+	{
+		enqueue(clause[0], -1);
+		if (propagate() >= 0)
+		{
+			ok = false;
+		}
+	}
+	else
+	{
+		watches[slot(clause[0])].push_back(clauses.size());
+		watches[slot(clause[1])].push_back(clauses.size());
+		clauses.push_back(clause);
+		clause_ids.push_back(baseFormula.getNumClauses());
+	}
+}
+
+/// <summary>
+/// Adds members that no clause mentions yet between runs, so they can be assumed.
+/// </summary>
+/// <param name="numMembers">new number of members, ignored if not above the current one</param>
+void DPLL::addMembers(int numMembers)
+{
+	backtrack(0);
+	baseFormula.addMembers(numMembers);
+	if ((int)values.size() < baseFormula.getNumMembers())
+	{
+		growMembers(baseFormula.getNumMembers());
+	}
+}
+
+/// <summary>
+/// Opens a new decision level, sets literal to true and propagates.
+/// </summary>
+/// <param name="literal">literal to be set, numbered as in the file</param>
+/// <returns>false if propagation reached a conflict</returns>
+bool DPLL::assume(int literal)
+{
+	//the level is opened even when the literal is already decided, so the caller can always
+	// undo the call with backtrack(decisionLevel() - 1)
+	int v = value(literal);
+	trail_lim.push_back(trail.size());
+	level_flipped.push_back(false);
+	if (v == 0)
+	{
+		return false;
+	}
+	if (v < 0)
+	{
+		enqueue(literal, -1);
+	}
+	return propagate() < 0;
+}
+
+/// <summary>
+/// Undoes every assignment made above the given decision level.
+/// </summary>
+/// <param name="level">decision level to return to</param>
+void DPLL::backtrack(int level)
+{
+	if (decisionLevel() <= level)
+	{
+		return;
+	}
+	unsigned int start = trail_lim[level];
+	for (unsigned int i = start; i < trail.size(); i++)
+	{
+		int member = abs(trail[i]) - 1;
+		values[member] = -1;
+		reasons[member] = -1;
+		if ((unsigned int)rank[member] < order_head)
+		{
+			order_head = rank[member];
+		}
+	}
+	trail.resize(start);
+	trail_lim.resize(level);
+	level_flipped.resize(level);
+	qhead = trail.size();
+}
+
+/// <summary>
+/// Gets the current decision level; 0 holds only facts implied by the formula itself.
+/// </summary>
+/// <returns></returns>
+int DPLL::decisionLevel()
+{
+	return trail_lim.size();
+}
+
+/// <summary>
+/// Gets the number of members currently assigned.
+/// </summary>
+/// <returns></returns>
+int DPLL::numAssigned()
+{
+	return trail.size();
+}
+
+/// <summary>
+/// Gets the value of a literal under the current partial assignment.
+/// </summary>
+/// <param name="literal">literal, numbered as in the file</param>
+/// <returns>1 if true, 0 if false, -1 if unassigned</returns>
+int DPLL::value(int literal)
+{
+	signed char v = values[abs(literal) - 1];
+	if (v < 0)
+	{
+		return -1;
+	}
+	return (literal > 0) ? v : 1 - v;
+}
+
+/// <summary>
+/// Gets up to limit unassigned members, most frequently occurring first.
+/// </summary>
+/// <param name="limit">maximum number of members to return</param>
+/// <returns>member numbers as used in the file</returns>
+vector<int> DPLL::unassignedMembers(int limit)
+{
+	vector<int> members;
+	for (unsigned int i = order_head; i < order.size() && (int)members.size() < limit; i++)
+	{
+		if (values[order[i]] < 0)
+		{
+			members.push_back(order[i] + 1);
+		}
+	}
+	return members;
+}
+
+/// <summary>
+/// Sets where the search publishes its progress for telemetry.
+/// </summary>
+/// <param name="record">progress record owned by the caller, or nullptr for none</param>
+void DPLL::setProgress(Search_progress *record)
+{
+	progress = record;
+}
+
+/***************************************************
+* public functions END
+***************************************************/
+
+/***************************************************
+* private functions START
+***************************************************/
+
+/// <summary>
+/// Builds the watched clause database from baseFormula and propagates unit clauses.
+/// </summary>
+void DPLL::load()
+{
+	int numMembers = baseFormula.getNumMembers();
+	int numClauses = baseFormula.getNumClauses();
+	const vector<vector<int>> &puzzle_ints = baseFormula.getPuzzleInts();
+
+	values.assign(numMembers, -1);
+	reasons.assign(numMembers, -1);
+	hint_ids.assign(numMembers, 0);
+	clause_ids.clear();
+	next_id = numClauses;
+	last_lemma = 0;
+	watches.assign(2 * numMembers, vector<int>());
+	trail.clear();
+	trail_lim.clear();
+	level_flipped.clear();
+	clauses.clear();
+	qhead = 0;
+	order_head = 0;
+	ok = true;
+
+	vector<int> units;
+	vector<long long> unit_ids;
+	for (int i = 0; i < numClauses; i++)
+	{
+		vector<int> clause;
+		bool tautology = false;
+		for (unsigned int j = 0; j < puzzle_ints[i].size() && puzzle_ints[i][j] != 0; j++)
+		{
+			int literal = puzzle_ints[i][j];
+			if (find(clause.begin(), clause.end(), -literal) != clause.end())
+			{
+				tautology = true;
+			}
+			if (find(clause.begin(), clause.end(), literal) == clause.end())
+			{
+				clause.push_back(literal);
+			}
+		}
+
+		if (tautology)
+		{
+			continue;
+		}
+		if (clause.empty())
+		{
+			if (ok && logging)
+			{
+				logConflict(i + 1);
+			}
+			ok = false;
+		}
+		else if (clause.size() == 1)
+		{
+			units.push_back(clause[0]);
+			unit_ids.push_back(i + 1);
+		}
+		else
+		{
+			watches[slot(clause[0])].push_back(clauses.size());
+			watches[slot(clause[1])].push_back(clauses.size());
+			clauses.push_back(clause);
+			clause_ids.push_back(i + 1);
+		}
+	}
+
+	//branch on the members that occur most often, with the more frequent polarity first
+	vector<int> counts(numMembers);
+	polarity.assign(numMembers, 0);
+	order.resize(numMembers);
+	rank.resize(numMembers);
+	for (int i = 0; i < numMembers; i++)
+	{
+		int positive = baseFormula.getOccurrences(i + 1).size();
+		int negative = baseFormula.getOccurrences(-(i + 1)).size();
+		counts[i] = positive + negative;
+		polarity[i] = positive >= negative;
+		order[i] = i;
+	}
+	Occurrence_greater by_occurrence;
+	by_occurrence.counts = &counts;
+	sort(order.begin(), order.end(), by_occurrence);
+	for (int i = 0; i < numMembers; i++)
+	{
+		rank[order[i]] = i;
+	}
+
+	//unit clauses are facts at level 0
+	for (unsigned int i = 0; i < units.size() && ok; i++)
+	{
+		if (value(units[i]) == 0)
+		{
+			if (logging)
+			{
+				logConflict(unit_ids[i]);
+			}
+			ok = false;
+		}
+		else if (value(units[i]) < 0)
+		{
+			enqueue(units[i], -1);
+			hint_ids[abs(units[i]) - 1] = unit_ids[i];
+		}
+	}
+	if (ok)
+	{
+		int conflict = propagate();
+		if (conflict >= 0)
+		{
+			if (logging)
+			{
+				logConflict(clause_ids[conflict]);
+			}
+			ok = false;
+		}
+	}
+}
+
+/// <summary>
+/// Extends the search state to cover members added to the formula since it was loaded.
+/// </summary>
+/// <param name="numMembers">new number of members</param>
+void DPLL::growMembers(int numMembers)
+{
+	//new members are branched on after the existing ones, negative first
+	for (int i = values.size(); i < numMembers; i++)
+	{
+		rank.push_back(order.size());
+		order.push_back(i);
+	}
+	values.resize(numMembers, -1);
+	reasons.resize(numMembers, -1);
+	hint_ids.resize(numMembers, 0);
+	polarity.resize(numMembers, 0);
+	watches.resize(2 * numMembers);
+}
+
+/// <summary>
+/// Runs the search from the current state until the formula is solved, refuted or time runs out.
+/// </summary>
+int DPLL::search(const vector<int> &assumptions)
+{
+	Stopwatch ^ timeKeeper = gcnew Stopwatch();
+	timeKeeper->Start();
+
+	backtrack(0);
+	if (!ok)
+	{
+		return UNSATISFIABLE;
+	}
+
+	//a refutation under assumptions says nothing about the formula alone, so it is not logged
+	logging = ((Proof_writer^)proof != nullptr) && assumptions.empty();
+
+	//each assumption gets a level of its own that is never flipped, so backtracking past them
+	// means there is no solution under the assumptions
+	for (unsigned int i = 0; i < assumptions.size(); i++)
+	{
+		int v = value(assumptions[i]);
+		if (v == 0)
+		{
+			return UNSATISFIABLE;
+		}
+		if (v < 0)
+		{
+			newLevel(assumptions[i], true);
+			if (propagate() >= 0)
+			{
+				return UNSATISFIABLE;
+			}
+		}
+	}
+	int root = decisionLevel();
+
+	long long decisions = 0;
+	while (true)
+	{
+		int conflict = propagate();
+		if (conflict >= 0)
+		{
+			if (logging)
+			{
+				logConflict(clause_ids[conflict]);
+			}
+
+			//chronological backtracking: undo levels whose second branch has already failed,
+			// then try the second branch of the most recent remaining decision
+			while (decisionLevel() > root && level_flipped[decisionLevel() - 1])
+			{
+				backtrack(decisionLevel() - 1);
+			}
+			if (decisionLevel() <= root)
+			{
+				//without assumptions this refutes the formula itself
+				if (root == 0)
+				{
+					ok = false;
+				}
+				return UNSATISFIABLE;
+			}
+			int decision = trail[trail_lim[decisionLevel() - 1]];
+			backtrack(decisionLevel() - 1);
+			newLevel(-decision, true);
+			//the lemma just logged is what forces the second branch
+			hint_ids[abs(decision) - 1] = last_lemma;
+			continue;
+		}
+
+		int literal = pickBranch();
+		if (literal == 0)
+		{
+			return -1;
+		}
+
+		//the clock and the stop flag are only read, and progress published, every 1024 decisions
+		if ((++decisions & 1023) == 0)
+		{
+			if (progress != nullptr)
+			{
+				progress->steps = (unsigned int)decisions;
+			}
+			if (timeKeeper->ElapsedMilliseconds >= MAXTIME || (stop != nullptr && *stop != 0))
+			{
+				return 0;
+			}
+		}
+		newLevel(literal, false);
+	}
+}
+
+/// <summary>
+/// Opens a new decision level containing only the given literal.
+/// </summary>
+/// <param name="literal">decision literal</param>
+/// <param name="flipped">true if the opposite literal has already been refuted at this level</param>
+void DPLL::newLevel(int literal, bool flipped)
+{
+	trail_lim.push_back(trail.size());
+	level_flipped.push_back(flipped);
+	enqueue(literal, -1);
+}
+
+/// <summary>
+/// Assigns a literal true and queues it for propagation.
+/// </summary>
+/// <param name="literal">literal to be set</param>
+/// <param name="reason">clause that implied it, or -1 for decisions</param>
+void DPLL::enqueue(int literal, int reason)
+{
+	int member = abs(literal) - 1;
+	values[member] = (literal > 0) ? 1 : 0;
+	reasons[member] = reason;
+	hint_ids[member] = (reason >= 0) ? clause_ids[reason] : 0;
+	trail.push_back(literal);
+}
+
+/// <summary>
+/// Propagates every queued assignment through the watched literals.
+/// </summary>
+/// <returns>the index of a falsified clause, or -1 if there is no conflict</returns>
+int DPLL::propagate()
+{
+	while (qhead < trail.size())
+	{
+		int falseLiteral = -trail[qhead++];
+		vector<int> &watchList = watches[slot(falseLiteral)];
+		unsigned int i = 0, j = 0;
+		while (i < watchList.size())
+		{
+			int c = watchList[i++];
+			vector<int> &clause = clauses[c];
+
+			//keep the false literal in the second watched position
+			if (clause[0] == falseLiteral)
+			{
+				clause[0] = clause[1];
+				clause[1] = falseLiteral;
+			}
+			if (value(clause[0]) == 1)
+			{
+				watchList[j++] = c;
+				continue;
+			}
+
+			//look for a replacement watch that is not false
+			bool moved = false;
+			for (unsigned int k = 2; k < clause.size(); k++)
+			{
+				if (value(clause[k]) != 0)
+				{
+					clause[1] = clause[k];
+					clause[k] = falseLiteral;
+					watches[slot(clause[1])].push_back(c);
+					moved = true;
+					break;
+				}
+			}
+			if (moved)
+			{
+				continue;
+			}
+
+			//the clause is unit or falsified
+			watchList[j++] = c;
+			if (value(clause[0]) == 0)
+			{
+				while (i < watchList.size())
+				{
+					watchList[j++] = watchList[i++];
+				}
+				watchList.resize(j);
+				qhead = trail.size();
+				return c;
+			}
+			enqueue(clause[0], c);
+		}
+		watchList.resize(j);
+	}
+	return -1;
+}
+
+/// <summary>
+/// Chooses the next decision literal.
+/// </summary>
+/// <returns>a literal, or 0 if every member is assigned</returns>
+int DPLL::pickBranch()
+{
+	while (order_head < order.size() && values[order[order_head]] >= 0)
+	{
+		order_head++;
+	}
+	if (order_head >= order.size())
+	{
+		return 0;
+	}
+	int member = order[order_head];
+	return polarity[member] ? member + 1 : -(member + 1);
+}
+
+/// <summary>
+/// Maps a literal onto its position in the watch lists.
+/// </summary>
+int DPLL::slot(int literal)
+{
+	return literal > 0 ? 2 * (literal - 1) : 2 * (-literal - 1) + 1;
+}
+
+/// <summary>
+/// Logs the lemma refuting the current decisions, after propagation reached a conflict.
+/// </summary>
+/// <param name="conflictId">id of the falsified clause, used as the last LRAT hint</param>
+void DPLL::logConflict(long long conflictId)
+{
+	//Decisions on their second branch are left out: each is implied by the lemma logged when its
+	// first branch failed, given the open decisions below it.
+	vector<int> lemma;
+	for (int level = 0; level < decisionLevel(); level++)
+	{
+		if (!level_flipped[level])
+		{
+			lemma.push_back(-trail[trail_lim[level]]);
+		}
+	}
+
+	Proof_writer^ writer = proof;
+	last_lemma = ++next_id;
+	if (writer->isLRAT())
+	{
+		//replaying the trail in order makes each hint unit in turn, until the conflict is reached
+		vector<long long> hints;
+		for (unsigned int i = 0; i < trail.size(); i++)
+		{
+			long long id = hint_ids[abs(trail[i]) - 1];
+			if (id != 0)
+			{
+				hints.push_back(id);
+			}
+		}
+		hints.push_back(conflictId);
+		writer->addLemma(last_lemma, lemma, hints);
+	}
+	else
+	{
+		writer->addLemma(lemma);
+	}
+}
+
+/***************************************************
+* private functions END
+***************************************************/
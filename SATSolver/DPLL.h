@@ -0,0 +1,226 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <vcclr.h>
+#include "SAT_puzzle.h"
+#include "Telemetry.h"
+#include "Proof_writer.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+using namespace System::Diagnostics;
+
+/// <summary>
+/// Class containing the necessary data structures and methods to
+/// solve a SAT formula through use of the DPLL algorithm.
+/// Unlike the local search solvers this search is complete: it can prove a formula
+/// unsatisfiable.  Unit propagation uses two watched literals per clause, and the search
+/// can run under assumption literals, which are held fixed for the whole search.
+/// When given a proof writer, every conflict found without assumptions is logged as the
+/// negation of the decisions still open on their first branch; that lemma follows by unit
+/// propagation from the earlier ones, and the last lemma of a refutation is the empty clause.
+/// </summary>
+class DPLL
+{
+public:
+
+	/// <summary>
+	/// Returned by run_DPLL when the formula (under the given assumptions) has no solution.
+	/// </summary>
+	static const int UNSATISFIABLE = -3;
+
+	/// <summary>
+	/// Default constructor.
+	/// </summary>
+	DPLL();
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+	DPLL(SAT_puzzle inPuzzle);
+
+	/// <summary>
+	/// Constructor that logs a proof of unsatisfiability.
+	/// Lemmas use the member numbering of inPuzzle, so it should not have been renumbered.
+	/// </summary>
+	/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+	/// <param name="inProof">writer receiving a DRAT or LRAT lemma for each conflict</param>
+	DPLL(SAT_puzzle inPuzzle, Proof_writer^ inProof);
+
+	/// <summary>
+	/// Runs the DPLL algorithm
+	/// </summary>
+	/// <returns>-1 if satisfied, UNSATISFIABLE if proven unsatisfiable, otherwise the clauses satisfied when time ran out.</returns>
+	int run_DPLL();
+
+	/// <summary>
+	/// Runs the DPLL algorithm with some literals fixed to true.
+	/// </summary>
+	/// <param name="assumptions">literals, numbered as in the file, that must hold in any solution</param>
+	/// <returns>-1 if satisfied, UNSATISFIABLE if no solution extends the assumptions, otherwise the clauses satisfied when time ran out.</returns>
+	int run_DPLL(const vector<int> &assumptions);
+
+	/// <summary>
+	/// checks to see if the formula has been solved or not.
+	/// </summary>
+	/// <returns>returns true if solved, false if not</returns>
+	bool formulaSolved();
+
+	/// <summary>
+	/// Gets the formula holding the assignment reached by the search.
+	/// </summary>
+	/// <returns>the SAT_puzzle object being solved</returns>
+	const SAT_puzzle& getFormula();
+
+	/// <summary>
+	/// Sets the time budget for subsequent runs.
+	/// </summary>
+	/// <param name="maxTime">time budget in milliseconds</param>
+	void setMaxTime(int maxTime);
+
+	/// <summary>
+	/// Sets a flag that ends a run early, as if time had run out, once another thread makes it nonzero.
+	/// </summary>
+	/// <param name="flag">flag owned by the caller, or nullptr for none</param>
+	void setStopFlag(const volatile int *flag);
+
+	/// <summary>
+	/// Adds a clause between runs.  Everything learned at level 0 is kept, so a sequence of
+	/// related runs does not repeat the propagation done by earlier ones.
+	/// </summary>
+	/// <param name="literals">literals of the clause, numbered as in the file, without the terminating 0</param>
+	void addClause(const vector<int> &literals);
+
+	/// <summary>
+	/// Adds members that no clause mentions yet between runs, so they can be assumed.
+	/// </summary>
+	/// <param name="numMembers">new number of members, ignored if not above the current one</param>
+	void addMembers(int numMembers);
+
+	////////////////////////////////////////////////////////////
+	//Propagation primitives, used directly by lookahead
+
+	/// <summary>
+	/// Opens a new decision level, sets literal to true and propagates.
+	/// </summary>
+	/// <param name="literal">literal to be set, numbered as in the file</param>
+	/// <returns>false if propagation reached a conflict</returns>
+	bool assume(int literal);
+
+	/// <summary>
+	/// Undoes every assignment made above the given decision level.
+	/// </summary>
+	/// <param name="level">decision level to return to</param>
+	void backtrack(int level);
+
+	/// <summary>
+	/// Gets the current decision level; 0 holds only facts implied by the formula itself.
+	/// </summary>
+	/// <returns></returns>
+	int decisionLevel();
+
+	/// <summary>
+	/// Gets the number of members currently assigned.
+	/// </summary>
+	/// <returns></returns>
+	int numAssigned();
+
+	/// <summary>
+	/// Gets the value of a literal under the current partial assignment.
+	/// </summary>
+	/// <param name="literal">literal, numbered as in the file</param>
+	/// <returns>1 if true, 0 if false, -1 if unassigned</returns>
+	int value(int literal);
+
+	/// <summary>
+	/// Gets up to limit unassigned members, most frequently occurring first.
+	/// </summary>
+	/// <param name="limit">maximum number of members to return</param>
+	/// <returns>member numbers as used in the file</returns>
+	vector<int> unassignedMembers(int limit);
+
+	/// <summary>
+	/// Sets where the search publishes its progress for telemetry.
+	/// </summary>
+	/// <param name="record">progress record owned by the caller, or nullptr for none</param>
+	void setProgress(Search_progress *record);
+
+private:
+
+	/// <summary>
+	/// Builds the watched clause database from baseFormula and propagates unit clauses.
+	/// </summary>
+	void load();
+
+	/// <summary>
+	/// Extends the search state to cover members added to the formula since it was loaded.
+	/// </summary>
+	/// <param name="numMembers">new number of members</param>
+	void growMembers(int numMembers);
+
+	/// <summary>
+	/// Runs the search from the current state until the formula is solved, refuted or time runs out.
+	/// </summary>
+	int search(const vector<int> &assumptions);
+
+	/// <summary>
+	/// Opens a new decision level containing only the given literal.
+	/// </summary>
+	/// <param name="literal">decision literal</param>
+	/// <param name="flipped">true if the opposite literal has already been refuted at this level</param>
+	void newLevel(int literal, bool flipped);
+
+	/// <summary>
+	/// Assigns a literal true and queues it for propagation.
+	/// </summary>
+	/// <param name="literal">literal to be set</param>
+	/// <param name="reason">clause that implied it, or -1 for decisions</param>
+	void enqueue(int literal, int reason);
+
+	/// <summary>
+	/// Propagates every queued assignment through the watched literals.
+	/// </summary>
+	/// <returns>the index of a falsified clause, or -1 if there is no conflict</returns>
+	int propagate();
+
+	/// <summary>
+	/// Chooses the next decision literal.
+	/// </summary>
+	/// <returns>a literal, or 0 if every member is assigned</returns>
+	int pickBranch();
+
+	/// <summary>
+	/// Maps a literal onto its position in the watch lists.
+	/// </summary>
+	int slot(int literal);
+
+	/// <summary>
+	/// Logs the lemma refuting the current decisions, after propagation reached a conflict.
+	/// </summary>
+	/// <param name="conflictId">id of the falsified clause, used as the last LRAT hint</param>
+	void logConflict(long long conflictId);
+
+	SAT_puzzle baseFormula;
+	int MAXTIME = 10000;
+	Search_progress *progress = nullptr;
+	const volatile int *stop = nullptr;
+
+	vector<vector<int>> clauses; //clause literals; the first two of each clause are watched
+	vector<vector<int>> watches; //clauses watching each literal, stored at slot(literal)
+	vector<signed char> values; //1 true, 0 false, -1 unassigned, per member
+	vector<int> reasons; //clause that implied each member, or -1
+	vector<int> trail, trail_lim; //assigned literals in order, and where each level starts
+	vector<char> level_flipped; //whether each level's decision is already the second branch
+	vector<int> order, rank; //members by decreasing occurrence count, and each member's position
+	vector<char> polarity; //preferred value of each member
+	unsigned int qhead, order_head;
+	bool ok; //false once the formula itself has been refuted
+
+	gcroot<Proof_writer^> proof;
+	bool logging; //true while conflicts are being written to proof
+	vector<long long> clause_ids; //proof id (1-based position in the file) of each watched clause
+	vector<long long> hint_ids; //id of the clause or lemma that implied each member, 0 for decisions
+	long long next_id, last_lemma;
+};
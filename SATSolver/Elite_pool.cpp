@@ -0,0 +1,147 @@
+#include "stdafx.h"
+#include "Elite_pool.h"
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inAssignment">member values, one byte per member; the pool takes ownership.</param>
+/// <param name="inUnsatisfied">number of clauses the assignment leaves unsatisfied</param>
+Elite_entry::Elite_entry(array<Byte>^ inAssignment, int inUnsatisfied)
+{
+	assignment = inAssignment;
+	unsatisfied = inUnsatisfied;
+
+	//FNV-1a over the member values
+	unsigned long long hash = 14695981039346656037ULL;
+	for (int i = 0; i < assignment->Length; i++)
+	{
+		hash = (hash ^ assignment[i]) * 1099511628211ULL;
+	}
+	fingerprint = (long long)hash;
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="size">number of elite slots</param>
+Elite_pool::Elite_pool(int size)
+{
+	slots = gcnew array<Elite_entry^>(size);
+	solution = nullptr;
+	solved = 0;
+}
+
+/// <summary>
+/// Offers an assignment to the pool.  It replaces the worst entry if it is better than it.
+/// </summary>
+/// <param name="assignment">member values, one byte per member; the pool takes ownership.</param>
+/// <param name="unsatisfied">number of clauses the assignment leaves unsatisfied</param>
+/// <returns>true if the assignment was added</returns>
+bool Elite_pool::publish(array<Byte>^ assignment, int unsatisfied)
+{
+	Elite_entry^ entry = gcnew Elite_entry(assignment, unsatisfied);
+
+	//Another thread may replace the chosen slot first; the scan is then repeated a bounded
+	// number of times rather than waiting.
+	for (int attempt = 0; attempt < slots->Length; attempt++)
+	{
+		int worst = -1;
+		Elite_entry^ worstEntry = nullptr;
+		for (int i = 0; i < slots->Length; i++)
+		{
+			Elite_entry^ current = slots[i];
+			if (current == nullptr)
+			{
+				worst = i;
+				worstEntry = nullptr;
+				break;
+			}
+			if (current->fingerprint == entry->fingerprint && current->unsatisfied == unsatisfied)
+			{
+				return false;
+			}
+			if (worstEntry == nullptr || current->unsatisfied > worstEntry->unsatisfied)
+			{
+				worst = i;
+				worstEntry = current;
+			}
+		}
+
+		if (worstEntry != nullptr && worstEntry->unsatisfied <= unsatisfied)
+		{
+			return false;
+		}
+		if (Interlocked::CompareExchange<Elite_entry^>(slots[worst], entry, worstEntry) == worstEntry)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/// <summary>
+/// Picks a random entry from the pool.
+/// </summary>
+/// <param name="rand">random number source of the calling thread</param>
+/// <returns>an entry, or nullptr if nothing has been published yet</returns>
+Elite_entry^ Elite_pool::sample(Random ^ rand)
+{
+	int start = rand->Next(slots->Length);
+	for (int i = 0; i < slots->Length; i++)
+	{
+		Elite_entry^ current = slots[(start + i) % slots->Length];
+		if (current != nullptr)
+		{
+			return current;
+		}
+	}
+	return nullptr;
+}
+
+/// <summary>
+/// Records a satisfying assignment and tells all threads to stop.  Only the first report is kept.
+/// </summary>
+/// <param name="assignment">the satisfying member values</param>
+void Elite_pool::reportSolution(array<Byte>^ assignment)
+{
+	if (Interlocked::CompareExchange<array<Byte>^>(solution, assignment, nullptr) == nullptr)
+	{
+		Interlocked::Exchange(solved, 1);
+	}
+}
+
+/// <summary>
+/// checks to see if any thread has satisfied the formula.
+/// </summary>
+/// <returns>true once a solution has been reported</returns>
+bool Elite_pool::isSolved()
+{
+	return Thread::VolatileRead(solved) != 0;
+}
+
+/// <summary>
+/// Gets the satisfying assignment, if one was reported.
+/// </summary>
+/// <returns>member values, or nullptr</returns>
+array<Byte>^ Elite_pool::getSolution()
+{
+	return solution;
+}
+
+/// <summary>
+/// Gets the entry with the fewest unsatisfied clauses.
+/// </summary>
+/// <returns>the best entry, or nullptr if the pool is empty</returns>
+Elite_entry^ Elite_pool::getBest()
+{
+	Elite_entry^ best = nullptr;
+	for (int i = 0; i < slots->Length; i++)
+	{
+		Elite_entry^ current = slots[i];
+		if (current != nullptr && (best == nullptr || current->unsatisfied < best->unsatisfied))
+		{
+			best = current;
+		}
+	}
+	return best;
+}
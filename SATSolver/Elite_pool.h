@@ -0,0 +1,85 @@
+#pragma once
+using namespace System;
+using namespace System::Threading;
+
+/// <summary>
+/// An immutable snapshot of an assignment published to the elite pool.
+/// Entries are never modified after construction, so readers need no locking.
+/// </summary>
+ref class Elite_entry
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inAssignment">member values, one byte per member; the pool takes ownership.</param>
+	/// <param name="inUnsatisfied">number of clauses the assignment leaves unsatisfied</param>
+	Elite_entry(array<Byte>^ inAssignment, int inUnsatisfied);
+
+	array<Byte>^ assignment;
+	int unsatisfied;
+	//cheap fingerprint used to keep identical assignments out of the pool
+	long long fingerprint;
+};
+
+/// <summary>
+/// Fixed-size pool of the best assignments found by cooperating search threads.
+/// Slots are replaced with Interlocked::CompareExchange, so publishing and sampling never take
+/// a lock.  Threads only touch the pool every few thousand flips, keeping it off the flip path.
+/// </summary>
+ref class Elite_pool
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="size">number of elite slots</param>
+	Elite_pool(int size);
+
+	/// <summary>
+	/// Offers an assignment to the pool.  It replaces the worst entry if it is better than it.
+	/// </summary>
+	/// <param name="assignment">member values, one byte per member; the pool takes ownership.</param>
+	/// <param name="unsatisfied">number of clauses the assignment leaves unsatisfied</param>
+	/// <returns>true if the assignment was added</returns>
+	bool publish(array<Byte>^ assignment, int unsatisfied);
+
+	/// <summary>
+	/// Picks a random entry from the pool.
+	/// </summary>
+	/// <param name="rand">random number source of the calling thread</param>
+	/// <returns>an entry, or nullptr if nothing has been published yet</returns>
+	Elite_entry^ sample(Random ^ rand);
+
+	/// <summary>
+	/// Records a satisfying assignment and tells all threads to stop.  Only the first report is kept.
+	/// </summary>
+	/// <param name="assignment">the satisfying member values</param>
+	void reportSolution(array<Byte>^ assignment);
+
+	/// <summary>
+	/// checks to see if any thread has satisfied the formula.
+	/// </summary>
+	/// <returns>true once a solution has been reported</returns>
+	bool isSolved();
+
+	/// <summary>
+	/// Gets the satisfying assignment, if one was reported.
+	/// </summary>
+	/// <returns>member values, or nullptr</returns>
+	array<Byte>^ getSolution();
+
+	/// <summary>
+	/// Gets the entry with the fewest unsatisfied clauses.
+	/// </summary>
+	/// <returns>the best entry, or nullptr if the pool is empty</returns>
+	Elite_entry^ getBest();
+
+private:
+
+	array<Elite_entry^>^ slots;
+	array<Byte>^ solution;
+	int solved;
+};
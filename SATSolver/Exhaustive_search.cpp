@@ -0,0 +1,301 @@
+#include "stdafx.h"
+#include "Exhaustive_search.h"
+#include "DPLL.h"
+
+// Bit k of a word is the assignment in which the i-th lowest member has the value of bit i of k
+static const unsigned long long LOW_PATTERNS[6] =
+{
+	0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+	0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+};
+
+/***************************************************
+* Exhaustive_search functions START
+***************************************************/
+
+/// <summary>
+/// Default constructor.
+/// </summary>
+Exhaustive_search::Exhaustive_search()
+{
+	stopped = 0;
+	timedOut = 0;
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inPuzzle">SAT_puzzle object to be solved; at most MAX_MEMBERS members.</param>
+Exhaustive_search::Exhaustive_search(SAT_puzzle inPuzzle)
+{
+	baseFormula = std::move(inPuzzle);
+	stopped = 0;
+	timedOut = 0;
+}
+
+/// <summary>
+/// Determines whether a formula is small enough to be dispatched to this search instead of
+/// the one asked for.  Weighted formulas are left to MaxSAT.
+/// </summary>
+/// <param name="formula">formula to be solved</param>
+/// <returns></returns>
+bool Exhaustive_search::suits(SAT_puzzle &formula)
+{
+	return formula.getNumMembers() <= DISPATCH_MEMBERS && !formula.isWeighted();
+}
+
+/// <summary>
+/// Tries assignments until one satisfies the formula, every one has failed, or time runs out.
+/// </summary>
+/// <returns>-1 if satisfied, DPLL::UNSATISFIABLE if no assignment satisfies it, otherwise the clauses satisfied when time ran out.</returns>
+int Exhaustive_search::run_Exhaustive()
+{
+	if (baseFormula.getNumMembers() > MAX_MEMBERS)
+	{
+		throw gcnew ArgumentException("exhaustive search takes at most " + MAX_MEMBERS.ToString() + " members");
+	}
+	Stopwatch ^ timeKeeper = gcnew Stopwatch();
+	timeKeeper->Start();
+	load();
+
+	int numTasks = 1 << taskBits;
+	int numWorkers = Math::Min(Environment::ProcessorCount, numTasks);
+	//a search this small is over before threads would have started, so it stays on the calling thread
+	if (((unsigned long long)lowWords.size() << highBits) <= SERIAL_WORK)
+	{
+		numWorkers = 1;
+	}
+	found.assign(numWorkers, -1);
+	stopped = 0;
+	timedOut = 0;
+	if (numWorkers == 1)
+	{
+		searchTasks(0, 1, timeKeeper);
+	}
+	else
+	{
+		array<Thread^>^ threads = gcnew array<Thread^>(numWorkers);
+		for (int w = 0; w < numWorkers; w++)
+		{
+			Exhaustive_thread^ entry = gcnew Exhaustive_thread(this, w, numWorkers, timeKeeper);
+			threads[w] = gcnew Thread(gcnew ThreadStart(entry, &Exhaustive_thread::Run));
+			threads[w]->Start();
+		}
+		for (int w = 0; w < numWorkers; w++)
+		{
+			threads[w]->Join();
+		}
+	}
+
+	for (int w = 0; w < numWorkers; w++)
+	{
+		if (found[w] >= 0)
+		{
+			for (int i = 0; i < baseFormula.getNumMembers(); i++)
+			{
+				baseFormula.setMemberAtIndex(i, ((found[w] >> i) & 1) != 0);
+			}
+			baseFormula.check_trues();
+			return -1;
+		}
+	}
+	if (timedOut != 0)
+	{
+		return baseFormula.check_trues();
+	}
+	return DPLL::UNSATISFIABLE;
+}
+
+/// <summary>
+/// Searches the tasks dealt to one thread: every stride-th one, starting at first.
+/// </summary>
+/// <param name="first">index of the thread's first task</param>
+/// <param name="stride">number of threads</param>
+/// <param name="timeKeeper">clock started when the search began</param>
+void Exhaustive_search::searchTasks(int first, int stride, Stopwatch ^ timeKeeper)
+{
+	int numClauses = (int)lowWords.size();
+	int shift = highBits - taskBits;
+	unsigned long long taskWords = 1ULL << shift;
+	long long checked = 0;
+
+	for (int task = first; task < (1 << taskBits) && stopped == 0; task += stride)
+	{
+		unsigned long long prefix = (unsigned long long)task << shift;
+
+		//clauses over the prefix alone decide the whole task at once
+		bool refuted = false;
+		for (unsigned int i = 0; i < prefixClauses.size() && !refuted; i++)
+		{
+			int c = prefixClauses[i];
+			refuted = ((prefix & positiveHigh[c]) | (~prefix & negativeHigh[c])) == 0;
+		}
+		if (refuted)
+		{
+			continue;
+		}
+
+		for (unsigned long long index = prefix; index < prefix + taskWords; index++)
+		{
+			//a clause satisfied by the fixed members holds for the whole word; any other
+			// narrows the word to the assignments its lowest members satisfy
+			unsigned long long word = validBits;
+			for (int c = 0; c < numClauses && word != 0; c++)
+			{
+				if (((index & positiveHigh[c]) | (~index & negativeHigh[c])) == 0)
+				{
+					word &= lowWords[c];
+				}
+			}
+			if (word != 0)
+			{
+				int bit = 0;
+				while (((word >> bit) & 1) == 0)
+				{
+					bit++;
+				}
+				found[first] = (long long)((index << 6) | bit);
+				stopped = 1;
+				return;
+			}
+
+			if ((++checked % CHECKPERIOD) == 0)
+			{
+				if (stopped != 0)
+				{
+					return;
+				}
+				if (timeKeeper->ElapsedMilliseconds >= MAXTIME)
+				{
+					timedOut = 1;
+					stopped = 1;
+					return;
+				}
+			}
+		}
+	}
+}
+
+/// <summary>
+/// checks to see if the formula has been solved or not.
+/// </summary>
+/// <returns>returns true if solved, false if not</returns>
+bool Exhaustive_search::formulaSolved()
+{
+	return baseFormula.satisfied();
+}
+
+/// <summary>
+/// Gets the formula holding the satisfying assignment, if one was found.
+/// </summary>
+/// <returns>the SAT_puzzle object being solved</returns>
+const SAT_puzzle& Exhaustive_search::getFormula()
+{
+	return baseFormula;
+}
+
+/// <summary>
+/// Sets the time budget for subsequent runs.
+/// </summary>
+/// <param name="maxTime">time budget in milliseconds</param>
+void Exhaustive_search::setMaxTime(int maxTime)
+{
+	MAXTIME = maxTime;
+}
+
+/// <summary>
+/// Splits the clauses into word patterns over the six lowest members and masks over the rest.
+/// </summary>
+void Exhaustive_search::load()
+{
+	int numMembers = baseFormula.getNumMembers();
+	int numClauses = baseFormula.getNumClauses();
+	highBits = numMembers > 6 ? numMembers - 6 : 0;
+	taskBits = highBits < MAX_TASK_BITS ? highBits : MAX_TASK_BITS;
+	validBits = numMembers >= 6 ? ~0ULL : (1ULL << (1 << numMembers)) - 1;
+	unsigned long long prefixMask = ((1ULL << taskBits) - 1) << (highBits - taskBits);
+
+	//short clauses empty a word soonest, so they are tested first
+	vector<vector<int>> byLength;
+	for (int i = 0; i < numClauses; i++)
+	{
+		const vector<int> &clause = baseFormula.getClause(i);
+		unsigned int length = 0;
+		while (length < clause.size() && clause[length] != 0)
+		{
+			length++;
+		}
+		if (length >= byLength.size())
+		{
+			byLength.resize(length + 1);
+		}
+		byLength[length].push_back(i);
+	}
+
+	lowWords.clear();
+	positiveHigh.clear();
+	negativeHigh.clear();
+	prefixClauses.clear();
+	for (unsigned int length = 0; length < byLength.size(); length++)
+	{
+		for (unsigned int k = 0; k < byLength[length].size(); k++)
+		{
+			const vector<int> &clause = baseFormula.getClause(byLength[length][k]);
+			unsigned long long low = 0, positive = 0, negative = 0;
+			for (unsigned int j = 0; j < length; j++)
+			{
+				int member = abs(clause[j]) - 1;
+				if (member < 6)
+				{
+					low |= clause[j] > 0 ? LOW_PATTERNS[member] : ~LOW_PATTERNS[member];
+				}
+				else if (clause[j] > 0)
+				{
+					positive |= 1ULL << (member - 6);
+				}
+				else
+				{
+					negative |= 1ULL << (member - 6);
+				}
+			}
+			if (low == 0 && ((positive | negative) & ~prefixMask) == 0)
+			{
+				prefixClauses.push_back((int)lowWords.size());
+			}
+			lowWords.push_back(low);
+			positiveHigh.push_back(positive);
+			negativeHigh.push_back(negative);
+		}
+	}
+}
+
+/***************************************************
+* Exhaustive_search functions END
+***************************************************/
+
+/***************************************************
+* Exhaustive_thread functions START
+***************************************************/
+
+/// <summary>
+/// Constructor.
+/// </summary>
+Exhaustive_thread::Exhaustive_thread(Exhaustive_search *inSearch, int inFirst, int inStride, Stopwatch ^ inTimeKeeper)
+{
+	search = inSearch;
+	first = inFirst;
+	stride = inStride;
+	timeKeeper = inTimeKeeper;
+}
+
+/// <summary>
+/// Searches this thread's share of the tasks on the calling thread.
+/// </summary>
+void Exhaustive_thread::Run()
+{
+	search->searchTasks(first, stride, timeKeeper);
+}
+
+/***************************************************
+* Exhaustive_thread functions END
+***************************************************/
@@ -0,0 +1,136 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SAT_puzzle.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+using namespace System::Diagnostics;
+using namespace System::Threading;
+
+/// <summary>
+/// Class containing the necessary data structures and methods to
+/// solve a small SAT formula by trying every assignment.  Assignments are evaluated 64 at a
+/// time, bit-sliced: the six lowest members vary across the bits of a word and the others are
+/// fixed for the whole word, so a clause costs one mask test and at most one AND per word.
+/// The words are split by prefix (the highest members) into tasks that are dealt out to one
+/// thread per processor, unless the search is small enough to run on the calling thread; a
+/// prefix that already falsifies a clause is skipped whole.  The search
+/// is exact: running out of assignments proves the formula unsatisfiable.
+/// </summary>
+class Exhaustive_search
+{
+public:
+
+	/// <summary>
+	/// Largest formula the search accepts.
+	/// </summary>
+	static const int MAX_MEMBERS = 40;
+
+	/// <summary>
+	/// Largest formula handed to the search automatically; up to here it takes milliseconds.
+	/// </summary>
+	static const int DISPATCH_MEMBERS = 24;
+
+	/// <summary>
+	/// Default constructor.
+	/// </summary>
+	Exhaustive_search();
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inPuzzle">SAT_puzzle object to be solved; at most MAX_MEMBERS members.</param>
+	Exhaustive_search(SAT_puzzle inPuzzle);
+
+	/// <summary>
+	/// Determines whether a formula is small enough to be dispatched to this search instead of
+	/// the one asked for.  Weighted formulas are left to MaxSAT.
+	/// </summary>
+	/// <param name="formula">formula to be solved</param>
+	/// <returns></returns>
+	static bool suits(SAT_puzzle &formula);
+
+	/// <summary>
+	/// Tries assignments until one satisfies the formula, every one has failed, or time runs out.
+	/// </summary>
+	/// <returns>-1 if satisfied, DPLL::UNSATISFIABLE if no assignment satisfies it, otherwise the clauses satisfied when time ran out.</returns>
+	int run_Exhaustive();
+
+	/// <summary>
+	/// Searches the tasks dealt to one thread: every stride-th one, starting at first.
+	/// </summary>
+	/// <param name="first">index of the thread's first task</param>
+	/// <param name="stride">number of threads</param>
+	/// <param name="timeKeeper">clock started when the search began</param>
+	void searchTasks(int first, int stride, Stopwatch ^ timeKeeper);
+
+	/// <summary>
+	/// checks to see if the formula has been solved or not.
+	/// </summary>
+	/// <returns>returns true if solved, false if not</returns>
+	bool formulaSolved();
+
+	/// <summary>
+	/// Gets the formula holding the satisfying assignment, if one was found.
+	/// </summary>
+	/// <returns>the SAT_puzzle object being solved</returns>
+	const SAT_puzzle& getFormula();
+
+	/// <summary>
+	/// Sets the time budget for subsequent runs.
+	/// </summary>
+	/// <param name="maxTime">time budget in milliseconds</param>
+	void setMaxTime(int maxTime);
+
+private:
+
+	/// <summary>
+	/// Splits the clauses into word patterns over the six lowest members and masks over the rest.
+	/// </summary>
+	void load();
+
+	SAT_puzzle baseFormula;
+	int MAXTIME = 10000;
+	//words between reads of the clock and the stop flag
+	int CHECKPERIOD = 4096;
+	//most prefix bits used to split the words into tasks
+	int MAX_TASK_BITS = 10;
+	//clause-word tests up to which the search runs on the calling thread, about a millisecond of work
+	unsigned long long SERIAL_WORK = 1ULL << 20;
+
+	int highBits, taskBits; //members above the sixth, and how many of the highest of them form a task prefix
+	unsigned long long validBits; //bits of a word that stand for real assignments
+	vector<unsigned long long> lowWords; //assignments satisfying each clause through its six lowest members
+	vector<unsigned long long> positiveHigh, negativeHigh; //higher members in each clause, as bits of a word index
+	vector<int> prefixClauses; //clauses whose members all lie in the task prefix
+
+	volatile int stopped; //set once a thread finds a solution or time runs out
+	volatile int timedOut;
+	vector<long long> found; //satisfying assignment found by each thread, or -1
+};
+
+/// <summary>
+/// Thread entry point wrapping Exhaustive_search::searchTasks, since thread delegates must
+/// bind to managed classes.
+/// </summary>
+ref class Exhaustive_thread
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	Exhaustive_thread(Exhaustive_search *inSearch, int inFirst, int inStride, Stopwatch ^ inTimeKeeper);
+
+	/// <summary>
+	/// Searches this thread's share of the tasks on the calling thread.
+	/// </summary>
+	void Run();
+
+private:
+	Exhaustive_search *search;
+	int first, stride;
+	Stopwatch ^ timeKeeper;
+};
@@ -0,0 +1,217 @@
+#include "stdafx.h"
+#include "Flip_scores.h"
+
+/***************************************************
+* public functions START
+***************************************************/
+
+/// <summary>
+/// Default constructor.
+/// </summary>
+Flip_scores::Flip_scores()
+{
+	formula = nullptr;
+	offset = 0;
+	top = 0;
+}
+
+/// <summary>
+/// Computes every score from the formula's clauses and current assignment.  The formula must
+/// stay in place while the scores are used, and must be loaded again if its members are changed
+/// other than one at a time, each change followed by flip().
+/// </summary>
+/// <param name="inFormula">formula whose assignment is to be scored</param>
+void Flip_scores::load(const SAT_puzzle &inFormula)
+{
+	formula = &inFormula;
+	int numMembers = formula->getNumMembers();
+	int numClauses = formula->getNumClauses();
+	const vector<bool> &members = formula->getMemberList();
+
+	scores.assign(numMembers, 0);
+	true_sums.assign(numClauses, 0);
+	for (int i = 0; i < numClauses; i++)
+	{
+		//a tautology is never falsified, and is in no occurrence list, so it takes no part
+		if (!formula->getDistinctLiterals(i, literals))
+		{
+			continue;
+		}
+		for (unsigned int j = 0; j < literals.size(); j++)
+		{
+			int member = abs(literals[j]) - 1;
+			if ((literals[j] > 0) == members[member])
+			{
+				true_sums[i] += member;
+			}
+		}
+
+		//a falsified clause is made by each of its members; a clause with one true member is broken by it
+		int count = formula->getTrueCount(i);
+		if (count == 0)
+		{
+			for (unsigned int j = 0; j < literals.size(); j++)
+			{
+				scores[abs(literals[j]) - 1]++;
+			}
+		}
+		else if (count == 1)
+		{
+			scores[true_sums[i]]--;
+		}
+	}
+
+	//no score can exceed the number of clauses the member occurs in
+	offset = 0;
+	for (int i = 0; i < numMembers; i++)
+	{
+		int occurs = formula->getOccurrences(i + 1).size() + formula->getOccurrences(-(i + 1)).size();
+		if (occurs > offset)
+		{
+			offset = occurs;
+		}
+	}
+	buckets.assign(2 * offset + 1, vector<int>());
+	bucket_pos.assign(numMembers, 0);
+	top = 0;
+	for (int i = 0; i < numMembers; i++)
+	{
+		vector<int> &bucket = buckets[scores[i] + offset];
+		bucket_pos[i] = bucket.size();
+		bucket.push_back(i);
+		if (scores[i] + offset > top)
+		{
+			top = scores[i] + offset;
+		}
+	}
+}
+
+/// <summary>
+/// Updates the scores of every member sharing a clause with a member the formula has just flipped.
+/// </summary>
+/// <param name="member">index of the member that was flipped</param>
+void Flip_scores::flip(int member)
+{
+	//the formula has already updated its true literal counts, so each count includes this flip
+	int trueLiteral = formula->getMemberList()[member] ? member + 1 : -(member + 1);
+
+	//clauses where the member's literal has just become true
+	const vector<int> &made = formula->getOccurrences(trueLiteral);
+	for (unsigned int i = 0; i < made.size(); i++)
+	{
+		int c = made[i];
+		int count = formula->getTrueCount(c);
+		if (count == 1)
+		{
+			//no longer falsified: nobody makes it any more, and the flipped member now breaks it
+			formula->getDistinctLiterals(c, literals);
+			for (unsigned int j = 0; j < literals.size(); j++)
+			{
+				adjust(abs(literals[j]) - 1, -1);
+			}
+			adjust(member, -1);
+		}
+		else if (count == 2)
+		{
+			//the previously critical member can now be flipped without breaking the clause
+			adjust(true_sums[c], 1);
+		}
+		true_sums[c] += member;
+	}
+
+	//clauses where the member's literal has just become false
+	const vector<int> &broken = formula->getOccurrences(-trueLiteral);
+	for (unsigned int i = 0; i < broken.size(); i++)
+	{
+		int c = broken[i];
+		int count = formula->getTrueCount(c);
+		true_sums[c] -= member;
+		if (count == 0)
+		{
+			adjust(member, 1);
+			formula->getDistinctLiterals(c, literals);
+			for (unsigned int j = 0; j < literals.size(); j++)
+			{
+				adjust(abs(literals[j]) - 1, 1);
+			}
+		}
+		else if (count == 1)
+		{
+			//the remaining true member has become critical
+			adjust(true_sums[c], -1);
+		}
+	}
+}
+
+/// <summary>
+/// Gets the change in satisfied clauses that flipping a member would cause.
+/// </summary>
+/// <param name="member">index of the member</param>
+/// <returns></returns>
+int Flip_scores::getScore(int member)
+{
+	return scores[member];
+}
+
+/// <summary>
+/// Gets the highest score of any member.
+/// </summary>
+/// <returns></returns>
+int Flip_scores::bestScore()
+{
+	while (top > 0 && buckets[top].empty())
+	{
+		top--;
+	}
+	return top - offset;
+}
+
+/// <summary>
+/// Picks a member with the highest score, breaking ties randomly.
+/// </summary>
+/// <param name="rand">random number source for tie-breaking</param>
+/// <returns>the index of the chosen member, or -1 if there are no members</returns>
+int Flip_scores::pickBest(Random ^ rand)
+{
+	bestScore();
+	if (buckets.empty() || buckets[top].empty())
+	{
+		return -1;
+	}
+	const vector<int> &bucket = buckets[top];
+	return bucket[rand->Next((int)bucket.size())];
+}
+
+/***************************************************
+* public functions END
+***************************************************/
+
+/***************************************************
+* private functions START
+***************************************************/
+
+/// <summary>
+/// Changes a member's score and moves it to the matching bucket.
+/// </summary>
+void Flip_scores::adjust(int member, int delta)
+{
+	//the last member of the old bucket takes this member's place
+	vector<int> &from = buckets[scores[member] + offset];
+	int moved = from.back();
+	from[bucket_pos[member]] = moved;
+	bucket_pos[moved] = bucket_pos[member];
+	from.pop_back();
+
+	scores[member] += delta;
+	int index = scores[member] + offset;
+	bucket_pos[member] = buckets[index].size();
+	buckets[index].push_back(member);
+	if (index > top)
+	{
+		top = index;
+	}
+}
+
+/***************************************************
+* private functions END
+***************************************************/
@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+#include "SAT_puzzle.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+
+/// <summary>
+/// Keeps the score of flipping every member (clauses it would satisfy minus clauses it would
+/// break) up to date as members are flipped, with the members filed in buckets by score.
+/// A flip costs O(occurrences of the member), and finding a member with the highest score
+/// costs O(1) amortized: the highest non-empty bucket can only fall by as much as scores rose.
+/// The clauses, occurrence lists, assignment and true literal counts are read from the formula
+/// itself, so only one integer per clause is added to it.
+/// </summary>
+class Flip_scores
+{
+public:
+
+	/// <summary>
+	/// Default constructor.
+	/// </summary>
+	Flip_scores();
+
+	/// <summary>
+	/// Computes every score from the formula's clauses and current assignment.  The formula must
+	/// stay in place while the scores are used, and must be loaded again if its members are changed
+	/// other than one at a time, each change followed by flip().
+	/// </summary>
+	/// <param name="inFormula">formula whose assignment is to be scored</param>
+	void load(const SAT_puzzle &inFormula);
+
+	/// <summary>
+	/// Updates the scores of every member sharing a clause with a member the formula has just flipped.
+	/// </summary>
+	/// <param name="member">index of the member that was flipped</param>
+	void flip(int member);
+
+	/// <summary>
+	/// Gets the change in satisfied clauses that flipping a member would cause.
+	/// </summary>
+	/// <param name="member">index of the member</param>
+	/// <returns></returns>
+	int getScore(int member);
+
+	/// <summary>
+	/// Gets the highest score of any member.
+	/// </summary>
+	/// <returns></returns>
+	int bestScore();
+
+	/// <summary>
+	/// Picks a member with the highest score, breaking ties randomly.
+	/// </summary>
+	/// <param name="rand">random number source for tie-breaking</param>
+	/// <returns>the index of the chosen member, or -1 if there are no members</returns>
+	int pickBest(Random ^ rand);
+
+private:
+
+	/// <summary>
+	/// Changes a member's score and moves it to the matching bucket.
+	/// </summary>
+	void adjust(int member, int delta);
+
+	const SAT_puzzle *formula;
+	vector<int> true_sums; //sum of the members with true literals, which names the only one when the count is 1
+	vector<int> literals; //scratch space for the literals of one clause
+	vector<int> scores;
+	vector<vector<int>> buckets; //members with score s are in buckets[s + offset]
+	vector<int> bucket_pos; //position of each member within its bucket
+	int offset, top; //top: index of the highest bucket that may be non-empty
+};
@@ -0,0 +1,180 @@
+#include "stdafx.h"
+#include <cmath>
+#include "Formula_features.h"
+
+const char *Formula_features::NAMES[COUNT] =
+{
+	"log_members", "log_clauses", "ratio",
+	"len1", "len2", "len3", "len4plus", "mean_length",
+	"degree_mean", "degree_cv", "degree_max",
+	"horn", "positive", "weighted",
+	"vg_degree_mean", "vg_degree_cv"
+};
+
+/***************************************************
+* public functions START
+***************************************************/
+
+/// <summary>
+/// Computes the features of a formula.
+/// </summary>
+/// <param name="formula">formula to be described</param>
+Formula_features::Formula_features(SAT_puzzle &formula)
+{
+	int numMembers = formula.getNumMembers();
+	int numClauses = formula.getNumClauses();
+	for (int i = 0; i < COUNT; i++)
+	{
+		values[i] = 0.0;
+	}
+	values[LOG_MEMBERS] = log10(1.0 + numMembers);
+	values[LOG_CLAUSES] = log10(1.0 + numClauses);
+	values[RATIO] = numMembers > 0 ? (double)numClauses / numMembers : 0.0;
+	values[WEIGHTED] = formula.isWeighted() ? 1.0 : 0.0;
+
+	//clause lengths, Horn clauses (at most one positive literal) and literal signs
+	long long literals = 0, positives = 0;
+	int horn = 0;
+	int lengths[4] = { 0, 0, 0, 0 };
+	for (int i = 0; i < numClauses; i++)
+	{
+		const vector<int> &clause = formula.getClause(i);
+		int length = 0, clausePositives = 0;
+		while (length < (int)clause.size() && clause[length] != 0)
+		{
+			if (clause[length] > 0)
+			{
+				clausePositives++;
+			}
+			length++;
+		}
+		literals += length;
+		positives += clausePositives;
+		if (clausePositives <= 1)
+		{
+			horn++;
+		}
+		if (length >= 1)
+		{
+			lengths[length < 4 ? length - 1 : 3]++;
+		}
+	}
+	if (numClauses > 0)
+	{
+		values[LEN1] = (double)lengths[0] / numClauses;
+		values[LEN2] = (double)lengths[1] / numClauses;
+		values[LEN3] = (double)lengths[2] / numClauses;
+		values[LEN4PLUS] = (double)lengths[3] / numClauses;
+		values[MEAN_LENGTH] = (double)literals / numClauses;
+		values[HORN] = (double)horn / numClauses;
+	}
+	if (literals > 0)
+	{
+		values[POSITIVE] = (double)positives / literals;
+	}
+
+	//member degrees in the variable-clause graph
+	double sum = 0.0, squares = 0.0, most = 0.0;
+	for (int i = 0; i < numMembers; i++)
+	{
+		double degree = (double)(formula.getOccurrences(i + 1).size() + formula.getOccurrences(-(i + 1)).size());
+		sum += degree;
+		squares += degree * degree;
+		if (degree > most)
+		{
+			most = degree;
+		}
+	}
+	if (numMembers > 0)
+	{
+		double mean = sum / numMembers;
+		double variance = squares / numMembers - mean * mean;
+		values[DEGREE_MEAN] = mean;
+		values[DEGREE_CV] = mean > 0 ? sqrt(variance > 0 ? variance : 0.0) / mean : 0.0;
+		values[DEGREE_MAX] = most;
+	}
+
+	//Degrees in the variable graph (members joined when they share a clause) are counted for a
+	// sample of members.  A fixed seed keeps the features of a formula reproducible.
+	if (numMembers > 0)
+	{
+		Random ^ rand = gcnew Random(numMembers ^ numClauses);
+		vector<int> seen(numMembers, -1);
+		int samples = numMembers < SAMPLE_SIZE ? numMembers : SAMPLE_SIZE;
+		sum = 0.0;
+		squares = 0.0;
+		for (int s = 0; s < samples; s++)
+		{
+			int member = (samples == numMembers) ? s : rand->Next(numMembers);
+			int neighbours = 0, visited = 0;
+			for (int sign = 1; sign >= -1; sign -= 2)
+			{
+				const vector<int> &clauses = formula.getOccurrences(sign * (member + 1));
+				for (unsigned int c = 0; c < clauses.size() && visited < SAMPLE_CLAUSES; c++, visited++)
+				{
+					const vector<int> &clause = formula.getClause(clauses[c]);
+					for (unsigned int j = 0; j < clause.size() && clause[j] != 0; j++)
+					{
+						int other = abs(clause[j]) - 1;
+						if (other != member && seen[other] != s)
+						{
+							seen[other] = s;
+							neighbours++;
+						}
+					}
+				}
+			}
+			sum += neighbours;
+			squares += (double)neighbours * neighbours;
+		}
+		double mean = sum / samples;
+		double variance = squares / samples - mean * mean;
+		values[VG_DEGREE_MEAN] = mean;
+		values[VG_DEGREE_CV] = mean > 0 ? sqrt(variance > 0 ? variance : 0.0) / mean : 0.0;
+	}
+}
+
+/// <summary>
+/// Gets the value of one feature.
+/// </summary>
+/// <param name="feature">index of the feature</param>
+/// <returns></returns>
+double Formula_features::get(int feature) const
+{
+	return values[feature];
+}
+
+/// <summary>
+/// Looks up a feature by the name used in model files.
+/// </summary>
+/// <param name="name">feature name</param>
+/// <returns>index of the feature, or -1 if there is no such feature</returns>
+int Formula_features::find(String^ name)
+{
+	for (int i = 0; i < COUNT; i++)
+	{
+		if (name->Equals(gcnew String(NAMES[i])))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+/// <summary>
+/// Lists every feature as name=value, for display.
+/// </summary>
+/// <returns></returns>
+String^ Formula_features::describe() const
+{
+	String^ line = "";
+	for (int i = 0; i < COUNT; i++)
+	{
+		line += (i > 0 ? " " : "") + gcnew String(NAMES[i]) + "=" + values[i].ToString("G4");
+	}
+	return line;
+}
+
+/***************************************************
+* public functions END
+***************************************************/
@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include "SAT_puzzle.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+
+/// <summary>
+/// Cheap structural features of a formula, used to pick a solver for it.
+/// Everything is computed in one pass over the clauses and occurrence lists, apart from the
+/// variable graph features, which are estimated from a fixed-size sample of members.
+/// </summary>
+class Formula_features
+{
+public:
+
+	/// <summary>
+	/// Indices of the features; NAMES gives the name of each as used in model files.
+	/// </summary>
+	enum Feature
+	{
+		LOG_MEMBERS, LOG_CLAUSES, RATIO,
+		LEN1, LEN2, LEN3, LEN4PLUS, MEAN_LENGTH,
+		DEGREE_MEAN, DEGREE_CV, DEGREE_MAX,
+		HORN, POSITIVE, WEIGHTED,
+		VG_DEGREE_MEAN, VG_DEGREE_CV,
+		COUNT
+	};
+
+	/// <summary>
+	/// Computes the features of a formula.
+	/// </summary>
+	/// <param name="formula">formula to be described</param>
+	Formula_features(SAT_puzzle &formula);
+
+	/// <summary>
+	/// Gets the value of one feature.
+	/// </summary>
+	/// <param name="feature">index of the feature</param>
+	/// <returns></returns>
+	double get(int feature) const;
+
+	/// <summary>
+	/// Looks up a feature by the name used in model files.
+	/// </summary>
+	/// <param name="name">feature name</param>
+	/// <returns>index of the feature, or -1 if there is no such feature</returns>
+	static int find(String^ name);
+
+	/// <summary>
+	/// Lists every feature as name=value, for display.
+	/// </summary>
+	/// <returns></returns>
+	String^ describe() const;
+
+private:
+
+	static const char *NAMES[COUNT];
+
+	//members whose variable graph neighbourhood is counted, and clauses visited per member at most
+	static const int SAMPLE_SIZE = 256;
+	static const int SAMPLE_CLAUSES = 1024;
+
+	double values[COUNT];
+};
@@ -0,0 +1,203 @@
+#include "stdafx.h"
+#include <algorithm>
+#include "Formula_reorder.h"
+
+/// <summary>
+/// Orders members by ascending degree in the interaction graph, breaking ties by index.
+/// </summary>
+struct Degree_less
+{
+	const vector<vector<int>> *adjacency;
+
+	bool operator()(int a, int b) const
+	{
+		size_t degree_a = (*adjacency)[a].size(), degree_b = (*adjacency)[b].size();
+		return degree_a < degree_b || (degree_a == degree_b && a < b);
+	}
+};
+
+/***************************************************
+* public functions START
+***************************************************/
+
+/// <summary>
+/// Constructor.
+/// </summary>
+Formula_reorder::Formula_reorder()
+{
+}
+
+/// <summary>
+/// Computes a locality-preserving ordering and applies it to the puzzle.
+/// </summary>
+/// <param name="puzzle">SAT_puzzle object to be renumbered.</param>
+void Formula_reorder::reorder(SAT_puzzle &puzzle)
+{
+	buildGraph(puzzle);
+	vector<int> new_member_index = memberOrder();
+	vector<int> clause_order = clauseOrder(puzzle, new_member_index);
+	adjacency.clear();
+
+	puzzle.applyOrdering(new_member_index, clause_order);
+}
+
+/***************************************************
+* public functions END
+***************************************************/
+
+/***************************************************
+* private functions START
+***************************************************/
+
+/// <summary>
+/// Builds the variable-interaction graph: members are adjacent when they share a clause.
+/// </summary>
+/// <param name="puzzle">SAT_puzzle object the graph is built from.</param>
+void Formula_reorder::buildGraph(SAT_puzzle &puzzle)
+{
+	const vector<vector<int>> &puzzle_ints = puzzle.getPuzzleInts();
+	adjacency.assign(puzzle.getNumMembers(), vector<int>());
+
+	vector<int> members;
+	for (int i = 0; i < puzzle.getNumClauses(); i++)
+	{
+		members.clear();
+		for (unsigned int j = 0; j < puzzle_ints[i].size() && puzzle_ints[i][j] != 0; j++)
+		{
+			members.push_back(abs(puzzle_ints[i][j]) - 1);
+		}
+
+		//Short clauses connect every pair of members; long ones only link neighbours in the clause
+		// so a single wide clause cannot make the graph quadratic.
+		if (members.size() <= (unsigned int)MAXCLIQUE)
+		{
+			for (unsigned int a = 0; a < members.size(); a++)
+			{
+				for (unsigned int b = a + 1; b < members.size(); b++)
+				{
+					adjacency[members[a]].push_back(members[b]);
+					adjacency[members[b]].push_back(members[a]);
+				}
+			}
+		}
+		else
+		{
+			for (unsigned int a = 1; a < members.size(); a++)
+			{
+				adjacency[members[a - 1]].push_back(members[a]);
+				adjacency[members[a]].push_back(members[a - 1]);
+			}
+		}
+	}
+
+	//remove duplicate edges and self loops (a member appearing twice in a clause)
+	for (unsigned int i = 0; i < adjacency.size(); i++)
+	{
+		sort(adjacency[i].begin(), adjacency[i].end());
+		adjacency[i].erase(unique(adjacency[i].begin(), adjacency[i].end()), adjacency[i].end());
+		adjacency[i].erase(remove(adjacency[i].begin(), adjacency[i].end(), (int)i), adjacency[i].end());
+	}
+}
+
+/// <summary>
+/// Orders the members by reverse Cuthill-McKee, one breadth-first search per connected component.
+/// </summary>
+/// <returns>new index of each member</returns>
+vector<int> Formula_reorder::memberOrder()
+{
+	int num_members = adjacency.size();
+	Degree_less by_degree;
+	by_degree.adjacency = &adjacency;
+
+	//each component's search starts from its lowest-degree member, which tends to lie on its periphery
+	vector<int> start_candidates(num_members);
+	for (int i = 0; i < num_members; i++)
+	{
+		start_candidates[i] = i;
+	}
+	sort(start_candidates.begin(), start_candidates.end(), by_degree);
+
+	vector<bool> visited(num_members, false);
+	vector<int> order;
+	order.reserve(num_members);
+	vector<int> neighbours;
+	for (int s = 0; s < num_members; s++)
+	{
+		int start = start_candidates[s];
+		if (visited[start])
+		{
+			continue;
+		}
+		visited[start] = true;
+		unsigned int head = order.size();
+		order.push_back(start);
+
+		//order itself serves as the breadth-first queue
+		while (head < order.size())
+		{
+			int current = order[head++];
+			neighbours.clear();
+			for (unsigned int j = 0; j < adjacency[current].size(); j++)
+			{
+				int next = adjacency[current][j];
+				if (!visited[next])
+				{
+					visited[next] = true;
+					neighbours.push_back(next);
+				}
+			}
+			sort(neighbours.begin(), neighbours.end(), by_degree);
+			order.insert(order.end(), neighbours.begin(), neighbours.end());
+		}
+	}
+
+	//reversing the Cuthill-McKee order gives the reverse Cuthill-McKee numbering
+	vector<int> new_member_index(num_members);
+	for (int i = 0; i < num_members; i++)
+	{
+		new_member_index[order[num_members - 1 - i]] = i;
+	}
+	return new_member_index;
+}
+
+/// <summary>
+/// Orders the clauses by the lowest new index among their members, keeping file order among equals.
+/// </summary>
+/// <param name="puzzle">SAT_puzzle object whose clauses are ordered.</param>
+/// <param name="new_member_index">new index of each member</param>
+/// <returns>current index of the clause to be placed at each new position</returns>
+vector<int> Formula_reorder::clauseOrder(SAT_puzzle &puzzle, const vector<int> &new_member_index)
+{
+	const vector<vector<int>> &puzzle_ints = puzzle.getPuzzleInts();
+	int num_clauses = puzzle.getNumClauses();
+	int num_members = puzzle.getNumMembers();
+
+	//counting sort on each clause's lowest new member index keeps this linear and stable
+	vector<int> keys(num_clauses);
+	vector<int> bucket_start(num_members + 2, 0);
+	for (int i = 0; i < num_clauses; i++)
+	{
+		int key = num_members;
+		for (unsigned int j = 0; j < puzzle_ints[i].size() && puzzle_ints[i][j] != 0; j++)
+		{
+			key = min(key, new_member_index[abs(puzzle_ints[i][j]) - 1]);
+		}
+		keys[i] = key;
+		bucket_start[key + 1]++;
+	}
+	for (int k = 1; k < num_members + 2; k++)
+	{
+		bucket_start[k] += bucket_start[k - 1];
+	}
+
+	vector<int> clause_order(num_clauses);
+	for (int i = 0; i < num_clauses; i++)
+	{
+		clause_order[bucket_start[keys[i]]++] = i;
+	}
+	return clause_order;
+}
+
+/***************************************************
+* private functions END
+***************************************************/
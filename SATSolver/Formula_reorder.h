@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include "SAT_puzzle.h"
+using namespace std;
+
+/// <summary>
+/// Renumbers the members and clauses of a loaded formula so that variables which share
+/// clauses, and the clauses that use them, sit close together in memory.
+/// Members are ordered by reverse Cuthill-McKee over the variable-interaction graph, and
+/// clauses are then sorted by the lowest new index among their members.
+/// </summary>
+class Formula_reorder
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	Formula_reorder();
+
+	/// <summary>
+	/// Computes a locality-preserving ordering and applies it to the puzzle.
+	/// </summary>
+	/// <param name="puzzle">SAT_puzzle object to be renumbered.</param>
+	void reorder(SAT_puzzle &puzzle);
+
+private:
+
+	/// <summary>
+	/// Builds the variable-interaction graph: members are adjacent when they share a clause.
+	/// </summary>
+	/// <param name="puzzle">SAT_puzzle object the graph is built from.</param>
+	void buildGraph(SAT_puzzle &puzzle);
+
+	/// <summary>
+	/// Orders the members by reverse Cuthill-McKee, one breadth-first search per connected component.
+	/// </summary>
+	/// <returns>new index of each member</returns>
+	vector<int> memberOrder();
+
+	/// <summary>
+	/// Orders the clauses by the lowest new index among their members, keeping file order among equals.
+	/// </summary>
+	/// <param name="puzzle">SAT_puzzle object whose clauses are ordered.</param>
+	/// <param name="new_member_index">new index of each member</param>
+	/// <returns>current index of the clause to be placed at each new position</returns>
+	vector<int> clauseOrder(SAT_puzzle &puzzle, const vector<int> &new_member_index);
+
+	//Clauses longer than this are linked as a chain instead of a clique to keep the graph linear in size
+	int MAXCLIQUE = 8;
+	vector<vector<int>> adjacency;
+};
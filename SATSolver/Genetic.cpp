@@ -14,14 +14,15 @@
 
 #include "stdafx.h"
 #include "Genetic.h"
+#include "Checkpoint.h"
 
 /// <summary>
 /// Constructor
 /// </summary>
 Genetic::Genetic()
 {
-	population.resize(20);
-	children.resize(40);
+	words = 0;
+	current = 0;
 }
 
 /// <summary>
@@ -30,98 +31,185 @@ Genetic::Genetic()
 /// <param name="in_puzzle">SAT formula to be solved</param>
 int Genetic::runGenetic(SAT_puzzle inPuzzle)
 {
-	Random ^ rand = gcnew Random();
+	Random ^ rand = nullptr;
+	Stopwatch ^ timeKeeper = gcnew Stopwatch();
+	timeKeeper->Start();
+	String ^ path = checkpointPath;
+	long long lastSaved = 0;
+	int firstGeneration = 0;
 	vector<vector<int>> fitnessList;
-	fitnessList.resize(20);
-	for (int i = 0; i < 20; i++)
+	fitnessList.resize(POPULATION);
+	for (int i = 0; i < POPULATION; i++)
 	{
 		fitnessList[i].resize(2);
 	}
 	int bestFitness = 0;
-	//generate starting population
-	for (int i = 0; i < 20; i++)
+
+	//everything a generation touches is allocated here, before the first one
+	baseFormula = std::move(inPuzzle);
+	evaluator = Batch_eval(baseFormula);
+	words = evaluator.getWordsPerAssignment();
+	int numClauses = baseFormula.getNumClauses();
+	for (int a = 0; a < 2; a++)
+	{
+		arenas[a].assign(OFFSPRING * words, 0);
+		fitness[a].assign(OFFSPRING, 0);
+	}
+	current = 0;
+	population.resize(POPULATION);
+	for (int i = 0; i < POPULATION; i++)
+	{
+		population[i] = i;
+	}
+
+	//resume an interrupted run when a checkpoint for this formula exists
+	BinaryReader ^ saved = (path == nullptr) ? nullptr : Checkpoint::open(path, Checkpoint::GENETIC, &baseFormula);
+	vector<bool> members;
+	if (saved != nullptr)
 	{
-		population[i] = SAT_puzzle(inPuzzle);
-		for (int j = 0; j < population[i].getNumMembers(); j++)
+		firstGeneration = saved->ReadInt32();
+		bestFitness = saved->ReadInt32();
+		for (int i = 0; i < POPULATION; i++)
 		{
-			if (rand->Next(2) == 1)
+			fitnessList[i][0] = saved->ReadInt32();
+			fitnessList[i][1] = saved->ReadInt32();
+			members = Checkpoint::readAssignment(saved);
+			unsigned long long *packed = individual(current, i);
+			for (int j = 0; j < (int)members.size(); j++)
 			{
-				population[i].setTrueAtIndex(j);
+				packed[j / 64] |= (unsigned long long)(members[j] ? 1 : 0) << (j % 64);
 			}
-			else
+		}
+		rand = Checkpoint::readRandom(saved);
+		saved->Close();
+		Console::WriteLine("Resumed from checkpoint at generation " + firstGeneration.ToString() + ".");
+	}
+	else
+	{
+		rand = (seed < 0) ? gcnew Random() : gcnew Random(seed);
+		Initial_assignment start(baseFormula);
+		SAT_puzzle scratch(baseFormula);
+		//generate starting population
+		for (int i = 0; i < POPULATION; i++)
+		{
+			Initial_assignment::Strategy strategy = Initial_assignment::RANDOM;
+			if (initialization != Initial_assignment::RANDOM && i == 0)
 			{
-				population[i].setFalseAtIndex(j);
+				strategy = initialization;
 			}
+			else if (initialization != Initial_assignment::RANDOM && i <= 10)
+			{
+				strategy = Initial_assignment::BIASED;
+			}
+			start.assign(scratch, strategy, rand);
+			unsigned long long *packed = individual(current, i);
+			for (int j = 0; j < scratch.getNumMembers(); j++)
+			{
+				packed[j / 64] |= (unsigned long long)(scratch.getMemberList()[j] ? 1 : 0) << (j % 64);
+			}
+			fitnessList[i][0] = scratch.check_trues();
+			fitnessList[i][1] = i;
 		}
-		fitnessList[i][0] = population[i].check_trues();
-		fitnessList[i][1] = i;
 	}
+	evaluator.evaluate(&arenas[current][0], POPULATION, &fitness[current][0], nullptr);
 
 	//run for 200 generations
-	for (int generation = 0; generation < 200; generation++)
+	for (int generation = firstGeneration; generation < 200; generation++)
 	{
+		//snapshots are taken between generations, where the whole state is the population
+		if (path != nullptr && timeKeeper->ElapsedMilliseconds - lastSaved >= Checkpoint::INTERVAL)
+		{
+			saveCheckpoint(rand, generation, bestFitness, fitnessList);
+			lastSaved = timeKeeper->ElapsedMilliseconds;
+		}
+
 		//check for a solution
-		for (int i = 0; i < 20; i++)
+		int winner = -1;
+		for (int i = 0; i < POPULATION; i++)
 		{
-			if (population[i].check_trues() > bestFitness)
+			int score = fitness[current][population[i]];
+			if (score > bestFitness)
 			{
-				bestFitness = population[i].check_trues();
+				bestFitness = score;
 			}
-			if (population[i].satisfied())
+			if (score == numClauses && winner < 0)
 			{
-				return -1;
+				winner = i;
 			}
 		}
+		if (progress != nullptr)
+		{
+			progress->publish((long long)generation * OFFSPRING, -1, numClauses - bestFitness);
+			progress->generation = generation;
+			progress->fitness = bestFitness;
+		}
+		if (winner >= 0)
+		{
+			break;
+		}
 
-
-		int fitness = 0;
 		int leastFit = 0;
-		for (int i = 0; i < 20; i++)
+		for (int i = 0; i < POPULATION; i++)
 		{
 			fitnessList[i][0] = -i;
 			if (fitnessList[i][0] < fitnessList[leastFit][0])
 				leastFit = i;
 		}
-		//make children from parents
-		for (int i = 0; i < 40; i++)
+		//make children from parents, then score them all in one batch
+		for (int i = 0; i < OFFSPRING; i++)
 		{
-			int d = rand->Next(20);
-			int m = rand->Next(20);
+			int d = rand->Next(POPULATION);
+			int m = rand->Next(POPULATION);
 			while (m == d)
 			{
-				m = rand->Next(20);
+				m = rand->Next(POPULATION);
 			}
-			children[i] = makeChild(population[d], population[m]);
-			fitness = children[i].check_trues();
+			makeChild(d, m, i, rand);
+		}
+		evaluator.evaluate(&arenas[1 - current][0], OFFSPRING, &fitness[1 - current][0], nullptr);
 
+		for (int i = 0; i < OFFSPRING; i++)
+		{
 			//check to see if the child will join the new population by comparing 
 			// its fitness to that of others
-			for (int j = 0; j < 20; j++)
+			for (int j = 0; j < POPULATION; j++)
 			{
-				if (fitness > fitnessList[j][0])
+				if (fitness[1 - current][i] > fitnessList[j][0])
 				{
 					fitnessList[leastFit][1] = i;
-					fitnessList[leastFit][0] = fitness;
+					fitnessList[leastFit][0] = fitness[1 - current][i];
 				}
 			}
 		}
 
-		for (int i = 0; i < 20; i++)
+		//the chosen children become the population where they are
+		current = 1 - current;
+		for (int i = 0; i < POPULATION; i++)
 		{
-			population[i] = children[fitnessList[i][1]];
+			population[i] = fitnessList[i][1];
 		}
-		mutate(population[rand->Next(20)]);
-		mutate(population[rand->Next(20)]);
+		mutate(rand->Next(POPULATION), rand);
+		mutate(rand->Next(POPULATION), rand);
 	}
+	if (path != nullptr)
+		Checkpoint::remove(path);
 	//check for a solution
-	for (int i = 0; i < 20; i++)
+	for (int i = 0; i < POPULATION; i++)
 	{
-		if (population[i].check_trues() > bestFitness)
+		int score = fitness[current][population[i]];
+		if (score > bestFitness)
 		{
-			bestFitness = population[i].check_trues();
+			bestFitness = score;
 		}
-		if (population[i].satisfied())
+		if (score == numClauses)
 		{
+			solution = baseFormula;
+			members = unpack(i);
+			for (int j = 0; j < solution.getNumMembers(); j++)
+			{
+				solution.setMemberAtIndex(j, members[j]);
+			}
+			solution.check_trues();
 			return -1;
 		}
 	}
@@ -129,43 +217,130 @@ int Genetic::runGenetic(SAT_puzzle inPuzzle)
 }
 
 /// <summary>
-/// Create a child SAT_puzzle object
+/// Gets the population member that satisfied the formula in the last run.
 /// </summary>
-/// <param name="dad">Parent node 1</param>
-/// <param name="mom">Parent node 2</param>
-/// <returns>child node, combining parent node values randomly</returns>
-SAT_puzzle Genetic::makeChild(SAT_puzzle dad, SAT_puzzle mom)
+/// <returns>the satisfying SAT_puzzle object</returns>
+const SAT_puzzle& Genetic::getSolution()
 {
-	Random ^ rand = gcnew Random();
-	vector<bool> dad_members = dad.getMemberList();
-	vector<bool> mom_members = mom.getMemberList();
-	SAT_puzzle kid = SAT_puzzle(mom);
+	return solution;
+}
 
-	for (int i = 0; i < kid.getNumMembers(); i++)
+/// <summary>
+/// Sets a checkpoint file.  A checkpoint left in it by an interrupted run on the same formula
+/// is resumed, and the population is saved to it every Checkpoint::INTERVAL milliseconds.
+/// </summary>
+/// <param name="path">checkpoint file</param>
+void Genetic::setCheckpoint(String^ path)
+{
+	checkpointPath = path;
+}
+
+/// <summary>
+/// Sets how the starting population is built.  The default is a fair coin flip per member.
+/// With any other strategy the first individual uses it, the next half of the population is
+/// biased towards the Jeroslow-Wang polarities, and the rest stay random to keep the
+/// population diverse.
+/// </summary>
+/// <param name="strategy"></param>
+void Genetic::setInitialization(Initial_assignment::Strategy strategy)
+{
+	initialization = strategy;
+}
+
+/// <summary>
+/// Sets where the search publishes its progress for telemetry.
+/// </summary>
+/// <param name="record">progress record owned by the caller, or nullptr for none</param>
+void Genetic::setProgress(Search_progress *record)
+{
+	progress = record;
+}
+
+/// <summary>
+/// Sets the seed of the random number source, making runs repeatable.
+/// </summary>
+/// <param name="inSeed">seed for subsequent runs; a negative seed draws from the clock</param>
+void Genetic::setSeed(int inSeed)
+{
+	seed = inSeed;
+}
+
+/// <summary>
+/// Breeds a child into the offspring arena, taking each member from one parent or the other at random.
+/// </summary>
+/// <param name="dad">population index of parent 1</param>
+/// <param name="mom">population index of parent 2</param>
+/// <param name="child">slot of the child in the offspring arena</param>
+/// <param name="rand">random number source of the run</param>
+void Genetic::makeChild(int dad, int mom, int child, Random ^ rand)
+{
+	const unsigned long long *dad_members = individual(current, population[dad]);
+	const unsigned long long *mom_members = individual(current, population[mom]);
+	unsigned long long *kid = individual(1 - current, child);
+
+	//a random mask picks the parent of 64 members at once
+	for (int w = 0; w < words; w++)
 	{
-		if (rand->Next(2) == 1)
-		{
-			kid.setMemberAtIndex(i, mom_members[i]);
-		}
-		else
-		{
-			kid.setMemberAtIndex(i, dad_members[i]);
-		}
+		unsigned long long mask = ((unsigned long long)(unsigned int)rand->Next() << 33)
+			^ ((unsigned long long)(unsigned int)rand->Next() << 11) ^ (unsigned long long)(unsigned int)rand->Next();
+		kid[w] = (mom_members[w] & mask) | (dad_members[w] & ~mask);
 	}
-
-	return kid;
 }
 
 /// <summary>
-/// Alters 10% of the values of the target object.
+/// Alters 10% of the values of a population member and rescores it.
 /// </summary>
-/// <param name="target"></param>
-void Genetic::mutate(SAT_puzzle target)
+/// <param name="target">population index of the member</param>
+/// <param name="rand">random number source of the run</param>
+void Genetic::mutate(int target, Random ^ rand)
 {
-	Random ^ rand = gcnew Random();
-	int len = target.getNumMembers() / 10;
+	unsigned long long *packed = individual(current, population[target]);
+	int numMembers = baseFormula.getNumMembers();
+	int len = numMembers / 10;
 	for (int i = 0; i < len; i++)
 	{
-		target.negateAtIndex(rand->Next(target.getNumMembers()));
+		int member = rand->Next(numMembers);
+		packed[member / 64] ^= 1ULL << (member % 64);
+	}
+	evaluator.evaluate(packed, 1, &fitness[current][population[target]], nullptr);
+}
+
+/// <summary>
+/// Gets the packed assignment in a slot of an arena.
+/// </summary>
+unsigned long long *Genetic::individual(int arena, int slot)
+{
+	return &arenas[arena][slot * words];
+}
+
+/// <summary>
+/// Unpacks the assignment of a population member.
+/// </summary>
+vector<bool> Genetic::unpack(int member)
+{
+	const unsigned long long *packed = individual(current, population[member]);
+	vector<bool> members(baseFormula.getNumMembers());
+	for (int j = 0; j < (int)members.size(); j++)
+	{
+		members[j] = ((packed[j / 64] >> (j % 64)) & 1) != 0;
+	}
+	return members;
+}
+
+/// <summary>
+/// Saves the generation reached, the population, the selection table and the random number source.
+/// </summary>
+void Genetic::saveCheckpoint(Random ^ rand, int generation, int bestFitness, vector<vector<int>> &fitnessList)
+{
+	BinaryWriter ^ writer = Checkpoint::create(checkpointPath, Checkpoint::GENETIC, &baseFormula);
+	writer->Write(generation);
+	writer->Write(bestFitness);
+	for (int i = 0; i < POPULATION; i++)
+	{
+		writer->Write(fitnessList[i][0]);
+		writer->Write(fitnessList[i][1]);
+		Checkpoint::writeAssignment(writer, unpack(i));
 	}
+	Checkpoint::writeRandom(writer, rand);
+	Checkpoint::commit(writer, checkpointPath);
 }
\ No newline at end of file
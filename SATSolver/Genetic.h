@@ -15,14 +15,24 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <vcclr.h>
 #include "SAT_puzzle.h"
+#include "Telemetry.h"
+#include "Initial_assignment.h"
+#include "Batch_eval.h"
+#using <System.dll>
 using namespace std;
 using namespace System;
 using namespace System::IO;
+using namespace System::Diagnostics;
 
 /// <summary>
 /// Class containing the necessary data structures and methods to
-/// solve a SAT formula through use of the DPLL algorithm.
+/// solve a SAT formula through use of a genetic algorithm.
+/// Individuals are packed assignments held in two arenas allocated once per run.  Children are
+/// bred into one arena while the population lives in the other; selection only records which
+/// children form the next population, and the arenas then swap roles, so a generation copies no
+/// individuals and allocates nothing.
 /// </summary>
 class Genetic
 {
@@ -39,26 +49,87 @@ public:
 	/// <param name="in_puzzle">SAT formula to be solved</param>
 	int runGenetic(SAT_puzzle inPuzzle);
 
+	/// <summary>
+	/// Gets the population member that satisfied the formula in the last run.
+	/// </summary>
+	/// <returns>the satisfying SAT_puzzle object</returns>
+	const SAT_puzzle& getSolution();
+
+	/// <summary>
+	/// Sets a checkpoint file.  A checkpoint left in it by an interrupted run on the same formula
+	/// is resumed, and the population is saved to it every Checkpoint::INTERVAL milliseconds.
+	/// </summary>
+	/// <param name="path">checkpoint file</param>
+	void setCheckpoint(String^ path);
+
+	/// <summary>
+	/// Sets how the starting population is built.  The default is a fair coin flip per member.
+	/// With any other strategy the first individual uses it, the next half of the population is
+	/// biased towards the Jeroslow-Wang polarities, and the rest stay random to keep the
+	/// population diverse.
+	/// </summary>
+	/// <param name="strategy"></param>
+	void setInitialization(Initial_assignment::Strategy strategy);
+
+	/// <summary>
+	/// Sets where the search publishes its progress for telemetry.
+	/// </summary>
+	/// <param name="record">progress record owned by the caller, or nullptr for none</param>
+	void setProgress(Search_progress *record);
+
+	/// <summary>
+	/// Sets the seed of the random number source, making runs repeatable.
+	/// </summary>
+	/// <param name="inSeed">seed for subsequent runs; a negative seed draws from the clock</param>
+	void setSeed(int inSeed);
+
 private:
 	/// <summary>
-	/// Create a child SAT_puzzle object
+	/// Breeds a child into the offspring arena, taking each member from one parent or the other at random.
+	/// </summary>
+	/// <param name="dad">population index of parent 1</param>
+	/// <param name="mom">population index of parent 2</param>
+	/// <param name="child">slot of the child in the offspring arena</param>
+	/// <param name="rand">random number source of the run</param>
+	void makeChild(int dad, int mom, int child, Random ^ rand);
+
+	/// <summary>
+	/// Alters 10% of the values of a population member and rescores it.
+	/// </summary>
+	/// <param name="target">population index of the member</param>
+	/// <param name="rand">random number source of the run</param>
+	void mutate(int target, Random ^ rand);
+
+	/// <summary>
+	/// Gets the packed assignment in a slot of an arena.
+	/// </summary>
+	unsigned long long *individual(int arena, int slot);
+
+	/// <summary>
+	/// Unpacks the assignment of a population member.
 	/// </summary>
-	/// <param name="dad">Parent node 1</param>
-	/// <param name="mom">Parent node 2</param>
-	/// <returns>child node, combining parent node values randomly</returns>
-	SAT_puzzle makeChild(SAT_puzzle dad, SAT_puzzle mom);
+	vector<bool> unpack(int member);
 
 	/// <summary>
-	/// Alters 10% of the values of the target object.
+	/// Saves the generation reached, the population, the selection table and the random number source.
 	/// </summary>
-	/// <param name="target"></param>
-	void mutate(SAT_puzzle target);
+	void saveCheckpoint(Random ^ rand, int generation, int bestFitness, vector<vector<int>> &fitnessList);
 
 
-	SAT_puzzle baseFormula;
+	SAT_puzzle baseFormula, solution;
 
 	int MAXTIME = 10000;
-	vector<bool> flaggedMembers;
-	vector<SAT_puzzle> population, children;
+	Search_progress *progress = nullptr;
+	int seed = -1;
+	gcroot<String^> checkpointPath;
+	Initial_assignment::Strategy initialization = Initial_assignment::RANDOM;
+	int POPULATION = 20, OFFSPRING = 40;
+
+	Batch_eval evaluator; //scores the clauses of baseFormula
+	int words; //64-bit words per packed assignment
+	vector<unsigned long long> arenas[2]; //OFFSPRING packed assignments each
+	vector<int> fitness[2]; //satisfied clauses of each arena slot
+	int current; //arena holding the population
+	vector<int> population; //arena slot of each population member
 };
 
@@ -18,7 +18,7 @@ Hill_climb::Hill_climb()
 /// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
 Hill_climb::Hill_climb(SAT_puzzle inPuzzle)
 {
-	baseFormula = inPuzzle;
+	baseFormula = std::move(inPuzzle);
 
 	baseFormula.check_trues();
 	bool t = baseFormula.satisfied();
@@ -34,25 +34,18 @@ int Hill_climb::run_HillClimb()
 	Stopwatch ^ timeKeeper = gcnew Stopwatch();
 	timeKeeper->Start();
 
-	Random ^ randomizer = gcnew Random();
-	for (int i = 0; i < baseFormula.getNumMembers(); i++)
-	{
-		if (randomizer->Next(2) == 1)
-		{
-			baseFormula.setTrueAtIndex(i);
-		}
-		else
-		{
-			baseFormula.setFalseAtIndex(i);
-		}
-	}
+	Random ^ randomizer = (seed < 0) ? gcnew Random() : gcnew Random(seed);
+	Initial_assignment start(baseFormula);
+	start.assign(baseFormula, initialization, randomizer);
 
+	scores.load(baseFormula);
 	int index = 1;
+	long long steps = 0;
 
 	while (index >= 0)
 	{
 		//check for an index to improve the current solution fitness
-		index = bestStep();
+		index = bestStep(randomizer);
 		int blah2 = 0;
 
 		//If an index is found, which improves the current solution fitness when the variable
@@ -61,7 +54,14 @@ int Hill_climb::run_HillClimb()
 		if (index >= 0)
 		{
 			baseFormula.negateAtIndex(index);
+			scores.flip(index);
 			int num_trues = baseFormula.check_trues();
+			//every step improves, so the current count is also the best
+			if ((++steps & 255) == 0 && progress != nullptr)
+			{
+				int unsatisfied = baseFormula.getNumClauses() - num_trues;
+				progress->publish(steps, unsatisfied, unsatisfied);
+			}
 			int blah = 0;
 			if (baseFormula.satisfied())
 			{
@@ -104,6 +104,42 @@ int Hill_climb::checkPuzzle()
 	return baseFormula.check_trues();
 }
 
+/// <summary>
+/// Gets the formula in its current state, including the assignment reached by the search.
+/// </summary>
+/// <returns>the SAT_puzzle object being solved</returns>
+const SAT_puzzle& Hill_climb::getFormula()
+{
+	return baseFormula;
+}
+
+/// <summary>
+/// Sets how the starting assignment is built.  The default is a fair coin flip per member.
+/// </summary>
+/// <param name="strategy"></param>
+void Hill_climb::setInitialization(Initial_assignment::Strategy strategy)
+{
+	initialization = strategy;
+}
+
+/// <summary>
+/// Sets where the search publishes its progress for telemetry.
+/// </summary>
+/// <param name="record">progress record owned by the caller, or nullptr for none</param>
+void Hill_climb::setProgress(Search_progress *record)
+{
+	progress = record;
+}
+
+/// <summary>
+/// Sets the seed of the random number source, making runs repeatable.
+/// </summary>
+/// <param name="inSeed">seed for subsequent runs; a negative seed draws from the clock</param>
+void Hill_climb::setSeed(int inSeed)
+{
+	seed = inSeed;
+}
+
 /***************************************************
 * public functions END
 ***************************************************/
@@ -113,35 +149,18 @@ int Hill_climb::checkPuzzle()
 ***************************************************/
 
 /// <summary>
-/// Searches for the best index to flip to improve solution fitness.
+/// Searches for the best index to flip to improve solution fitness, breaking ties randomly.
 /// </summary>
-/// <returns>the index of the best variable to flip</returns>
-int Hill_climb::bestStep()
+/// <param name="rand">random number source for tie-breaking</param>
+/// <returns>the index of the best variable to flip, or -1 if no flip improves the fitness</returns>
+int Hill_climb::bestStep(Random ^ rand)
 {
-	int index = -1;
-	int currentSatisfied = baseFormula.check_trues();
-
-	vector<int> satisfiedClauses;
-	satisfiedClauses.resize(baseFormula.getNumMembers());
-	for (unsigned int i = -0; i < satisfiedClauses.capacity(); i++)
-	{
-		satisfiedClauses[i] = 0;
-	}
-
-	//determine which variable satisfies the greatest number of clauses when it is flipped
-	for (unsigned int i = 0; i < satisfiedClauses.capacity(); i++)
+	//the scores are kept up to date by every flip, so the best one is read off the top bucket
+	if (scores.bestScore() <= 0)
 	{
-		baseFormula.negateAtIndex(i);
-		satisfiedClauses[i] = baseFormula.check_trues();
-		baseFormula.negateAtIndex(i);
-
-		if (satisfiedClauses[i] > currentSatisfied)
-		{
-			index = i;
-			currentSatisfied = satisfiedClauses[i];
-		}
+		return -1;
 	}
-	return index;
+	return scores.pickBest(rand);
 }
 
 /***************************************************
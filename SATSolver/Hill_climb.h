@@ -2,6 +2,9 @@
 #include <string>
 #include <vector>
 #include "SAT_puzzle.h"
+#include "Telemetry.h"
+#include "Flip_scores.h"
+#include "Initial_assignment.h"
 #using <System.dll>
 using namespace std;
 using namespace System;
@@ -45,15 +48,44 @@ public:
 	/// <returns>an integer equal to the number of satisfied clauses</returns>
 	int checkPuzzle();
 
+	/// <summary>
+	/// Gets the formula in its current state, including the assignment reached by the search.
+	/// </summary>
+	/// <returns>the SAT_puzzle object being solved</returns>
+	const SAT_puzzle& getFormula();
+
+	/// <summary>
+	/// Sets how the starting assignment is built.  The default is a fair coin flip per member.
+	/// </summary>
+	/// <param name="strategy"></param>
+	void setInitialization(Initial_assignment::Strategy strategy);
+
+	/// <summary>
+	/// Sets where the search publishes its progress for telemetry.
+	/// </summary>
+	/// <param name="record">progress record owned by the caller, or nullptr for none</param>
+	void setProgress(Search_progress *record);
+
+	/// <summary>
+	/// Sets the seed of the random number source, making runs repeatable.
+	/// </summary>
+	/// <param name="inSeed">seed for subsequent runs; a negative seed draws from the clock</param>
+	void setSeed(int inSeed);
+
 private:
 
 	/// <summary>
-	/// Searches for the best index to flip to improve solution fitness.
+	/// Searches for the best index to flip to improve solution fitness, breaking ties randomly.
 	/// </summary>
-	/// <returns>the index of the best variable to flip</returns>
-	int bestStep();
+	/// <param name="rand">random number source for tie-breaking</param>
+	/// <returns>the index of the best variable to flip, or -1 if no flip improves the fitness</returns>
+	int bestStep(Random ^ rand);
 
 	SAT_puzzle baseFormula;
+	Flip_scores scores; //score of flipping each member, for the current assignment
 	int MAXTIME = 10000;
+	Search_progress *progress = nullptr;
+	int seed = -1;
+	Initial_assignment::Strategy initialization = Initial_assignment::RANDOM;
 };
 
@@ -0,0 +1,113 @@
+#include "stdafx.h"
+#include "Incremental_solver.h"
+
+/***************************************************
+* public functions START
+***************************************************/
+
+/// <summary>
+/// Default constructor; starts with an empty formula.
+/// </summary>
+Incremental_solver::Incremental_solver()
+{
+	numMembers = 0;
+	//library callers set their own limit; by default a solve runs until it is decided
+	solver.setMaxTime(Int32::MaxValue);
+}
+
+/// <summary>
+/// Adds a literal to the clause being built, or ends the clause when literal is 0.
+/// </summary>
+/// <param name="literal">literal numbered as in a cnf file, or 0</param>
+void Incremental_solver::add(int literal)
+{
+	if (literal != 0)
+	{
+		pending.push_back(literal);
+		return;
+	}
+	addClause(pending);
+	pending.clear();
+}
+
+/// <summary>
+/// Adds a whole clause.
+/// </summary>
+/// <param name="literals">literals of the clause, without the terminating 0</param>
+void Incremental_solver::addClause(const vector<int> &literals)
+{
+	for (unsigned int i = 0; i < literals.size(); i++)
+	{
+		if (abs(literals[i]) > numMembers)
+		{
+			numMembers = abs(literals[i]);
+		}
+	}
+	solver.addClause(literals);
+	evaluator.addClause(literals);
+}
+
+/// <summary>
+/// Fixes a literal to true for the next call to solve only.
+/// </summary>
+/// <param name="literal">literal numbered as in a cnf file</param>
+void Incremental_solver::assume(int literal)
+{
+	//a member no clause mentions yet is added without a clause, so clause numbering stays the caller's
+	if (abs(literal) > numMembers)
+	{
+		numMembers = abs(literal);
+		solver.addMembers(numMembers);
+		evaluator.addMembers(numMembers);
+	}
+	assumptions.push_back(literal);
+}
+
+/// <summary>
+/// Solves the formula under the current assumptions, which are then cleared.
+/// </summary>
+/// <returns>-1 if satisfied, DPLL::UNSATISFIABLE if no solution extends the assumptions, otherwise the clauses satisfied when time ran out.</returns>
+int Incremental_solver::solve()
+{
+	int result = solver.run_DPLL(assumptions);
+	assumptions.clear();
+	return result;
+}
+
+/// <summary>
+/// Gets the value of a literal in the model found by the last solve.
+/// Only meaningful while no clause has been added since a satisfiable solve.
+/// </summary>
+/// <param name="literal">literal numbered as in a cnf file</param>
+/// <returns>1 if true, 0 if false or the member is unknown to the formula</returns>
+int Incremental_solver::value(int literal)
+{
+	if (literal == 0 || abs(literal) > numMembers)
+	{
+		return 0;
+	}
+	return solver.value(literal) == 1 ? 1 : 0;
+}
+
+/// <summary>
+/// Sets the time budget for subsequent solves.
+/// </summary>
+/// <param name="maxTime">time budget in milliseconds</param>
+void Incremental_solver::setMaxTime(int maxTime)
+{
+	solver.setMaxTime(maxTime);
+}
+
+/// <summary>
+/// Gets the evaluator holding the same clauses, for scoring assignments without solving.
+/// Members first named by an assumption are included, without any clause of their own.
+/// </summary>
+/// <returns></returns>
+Batch_eval &Incremental_solver::getEvaluator()
+{
+	return evaluator;
+}
+
+/***************************************************
+* public functions END
+***************************************************/
@@ -0,0 +1,77 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SAT_puzzle.h"
+#include "DPLL.h"
+#include "Batch_eval.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+
+/// <summary>
+/// In-process interface to the complete solver for programs that build formulas themselves.
+/// Clauses are added directly rather than through a file, and the solver is kept between calls:
+/// facts derived from earlier clauses and the phases of the last model carry over, so a series
+/// of related queries under different assumptions reuses the work done so far.
+/// </summary>
+class Incremental_solver
+{
+public:
+
+	/// <summary>
+	/// Default constructor; starts with an empty formula.
+	/// </summary>
+	Incremental_solver();
+
+	/// <summary>
+	/// Adds a literal to the clause being built, or ends the clause when literal is 0.
+	/// </summary>
+	/// <param name="literal">literal numbered as in a cnf file, or 0</param>
+	void add(int literal);
+
+	/// <summary>
+	/// Adds a whole clause.
+	/// </summary>
+	/// <param name="literals">literals of the clause, without the terminating 0</param>
+	void addClause(const vector<int> &literals);
+
+	/// <summary>
+	/// Fixes a literal to true for the next call to solve only.
+	/// </summary>
+	/// <param name="literal">literal numbered as in a cnf file</param>
+	void assume(int literal);
+
+	/// <summary>
+	/// Solves the formula under the current assumptions, which are then cleared.
+	/// </summary>
+	/// <returns>-1 if satisfied, DPLL::UNSATISFIABLE if no solution extends the assumptions, otherwise the clauses satisfied when time ran out.</returns>
+	int solve();
+
+	/// <summary>
+	/// Gets the value of a literal in the model found by the last solve.
+	/// Only meaningful while no clause has been added since a satisfiable solve.
+	/// </summary>
+	/// <param name="literal">literal numbered as in a cnf file</param>
+	/// <returns>1 if true, 0 if false or the member is unknown to the formula</returns>
+	int value(int literal);
+
+	/// <summary>
+	/// Sets the time budget for subsequent solves.
+	/// </summary>
+	/// <param name="maxTime">time budget in milliseconds</param>
+	void setMaxTime(int maxTime);
+
+	/// <summary>
+	/// Gets the evaluator holding the same clauses, for scoring assignments without solving.
+	/// Members first named by an assumption are included, without any clause of their own.
+	/// </summary>
+	/// <returns></returns>
+	Batch_eval &getEvaluator();
+
+private:
+	DPLL solver;
+	Batch_eval evaluator;
+	vector<int> pending; //clause being built by add
+	vector<int> assumptions;
+	int numMembers;
+};
@@ -0,0 +1,233 @@
+#include "stdafx.h"
+#include <cmath>
+#include "Initial_assignment.h"
+
+const double Initial_assignment::BIAS = 0.75;
+
+/***************************************************
+* public functions START
+***************************************************/
+
+/// <summary>
+/// Computes the literal weights and the decision order of a formula.
+/// </summary>
+/// <param name="formula">formula whose assignments are to be built</param>
+Initial_assignment::Initial_assignment(SAT_puzzle &formula)
+{
+	numMembers = formula.getNumMembers();
+	int numClauses = formula.getNumClauses();
+
+	//occurrence lists hold each clause once per literal, so they give the distinct length
+	clauseLengths.assign(numClauses, 0);
+	for (int i = 0; i < numMembers; i++)
+	{
+		const vector<int> &positive = formula.getOccurrences(i + 1);
+		const vector<int> &negative = formula.getOccurrences(-(i + 1));
+		for (unsigned int c = 0; c < positive.size(); c++)
+		{
+			clauseLengths[positive[c]]++;
+		}
+		for (unsigned int c = 0; c < negative.size(); c++)
+		{
+			clauseLengths[negative[c]]++;
+		}
+	}
+	clauseWeights.assign(numClauses, 0.0);
+	for (int i = 0; i < numClauses; i++)
+	{
+		clauseWeights[i] = ldexp(1.0, -clauseLengths[i]);
+	}
+
+	literalWeights.assign(2 * numMembers, 0.0);
+	int mostOccurrences = 0;
+	for (int i = 0; i < numMembers; i++)
+	{
+		const vector<int> &positive = formula.getOccurrences(i + 1);
+		const vector<int> &negative = formula.getOccurrences(-(i + 1));
+		for (unsigned int c = 0; c < positive.size(); c++)
+		{
+			literalWeights[2 * i] += clauseWeights[positive[c]];
+		}
+		for (unsigned int c = 0; c < negative.size(); c++)
+		{
+			literalWeights[2 * i + 1] += clauseWeights[negative[c]];
+		}
+		int occurrences = (int)(positive.size() + negative.size());
+		if (occurrences > mostOccurrences)
+		{
+			mostOccurrences = occurrences;
+		}
+	}
+
+	//counting sort keeps the decision order linear
+	vector<int> starts(mostOccurrences + 2, 0);
+	for (int i = 0; i < numMembers; i++)
+	{
+		starts[mostOccurrences - (int)(formula.getOccurrences(i + 1).size() + formula.getOccurrences(-(i + 1)).size()) + 1]++;
+	}
+	for (int i = 1; i <= mostOccurrences + 1; i++)
+	{
+		starts[i] += starts[i - 1];
+	}
+	order.assign(numMembers, 0);
+	for (int i = 0; i < numMembers; i++)
+	{
+		order[starts[mostOccurrences - (int)(formula.getOccurrences(i + 1).size() + formula.getOccurrences(-(i + 1)).size())]++] = i;
+	}
+}
+
+/// <summary>
+/// Sets every member of a formula by the given strategy.
+/// </summary>
+/// <param name="target">the formula given to the constructor, or a copy of it</param>
+/// <param name="strategy">how the members are set</param>
+/// <param name="rand">random number source, used for coin flips and ties</param>
+void Initial_assignment::assign(SAT_puzzle &target, Strategy strategy, Random ^ rand)
+{
+	if (strategy == PROPAGATION)
+	{
+		propagate(target, rand);
+		return;
+	}
+	for (int i = 0; i < numMembers; i++)
+	{
+		bool value;
+		switch (strategy)
+		{
+		case JEROSLOW_WANG:
+			value = heavier(literalWeights, i, rand);
+			break;
+		case BIASED:
+			value = heavier(literalWeights, i, rand) == (rand->NextDouble() < BIAS);
+			break;
+		default:
+			value = rand->Next(2) == 1;
+			break;
+		}
+		if (value)
+		{
+			target.setTrueAtIndex(i);
+		}
+		else
+		{
+			target.setFalseAtIndex(i);
+		}
+	}
+}
+
+/***************************************************
+* public functions END
+***************************************************/
+
+/***************************************************
+* private functions START
+***************************************************/
+
+/// <summary>
+/// Gets the polarity with the larger weight, breaking ties randomly.
+/// </summary>
+bool Initial_assignment::heavier(const vector<double> &weights, int member, Random ^ rand)
+{
+	if (weights[2 * member] != weights[2 * member + 1])
+	{
+		return weights[2 * member] > weights[2 * member + 1];
+	}
+	return rand->Next(2) == 1;
+}
+
+/// <summary>
+/// Greedy construction with unit propagation.  Each clause is satisfied at most once and becomes
+/// unit at most once, so the work is linear in the size of the formula.
+/// </summary>
+void Initial_assignment::propagate(SAT_puzzle &target, Random ^ rand)
+{
+	vector<double> weights = literalWeights; //weights of the clauses not yet satisfied
+	vector<int> open = clauseLengths; //unassigned literals of each clause
+	vector<bool> satisfied(open.size(), false);
+	vector<signed char> values(numMembers, -1);
+	vector<int> pending;
+
+	//unit clauses of the formula are propagated before the first decision
+	for (unsigned int i = 0; i < open.size(); i++)
+	{
+		if (open[i] == 1)
+		{
+			pending.push_back(target.getClause(i)[0]);
+		}
+	}
+
+	int next = 0;
+	while (true)
+	{
+		while (!pending.empty())
+		{
+			int literal = pending.back();
+			pending.pop_back();
+			int index = abs(literal) - 1;
+			//a unit literal whose member has since been set is either satisfied or a conflict
+			if (values[index] >= 0)
+			{
+				continue;
+			}
+			values[index] = literal > 0 ? 1 : 0;
+
+			const vector<int> &made = target.getOccurrences(literal);
+			for (unsigned int c = 0; c < made.size(); c++)
+			{
+				if (!satisfied[made[c]])
+				{
+					satisfied[made[c]] = true;
+					const vector<int> &clause = target.getClause(made[c]);
+					for (unsigned int j = 0; j < clause.size() && clause[j] != 0; j++)
+					{
+						int slot = 2 * (abs(clause[j]) - 1) + (clause[j] > 0 ? 0 : 1);
+						weights[slot] -= clauseWeights[made[c]];
+					}
+				}
+			}
+
+			const vector<int> &broken = target.getOccurrences(-literal);
+			for (unsigned int c = 0; c < broken.size(); c++)
+			{
+				if (!satisfied[broken[c]] && --open[broken[c]] == 1)
+				{
+					const vector<int> &clause = target.getClause(broken[c]);
+					for (unsigned int j = 0; j < clause.size() && clause[j] != 0; j++)
+					{
+						if (values[abs(clause[j]) - 1] < 0)
+						{
+							pending.push_back(clause[j]);
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		while (next < numMembers && values[order[next]] >= 0)
+		{
+			next++;
+		}
+		if (next == numMembers)
+		{
+			break;
+		}
+		pending.push_back(heavier(weights, order[next], rand) ? order[next] + 1 : -(order[next] + 1));
+	}
+
+	for (int i = 0; i < numMembers; i++)
+	{
+		if (values[i] == 1)
+		{
+			target.setTrueAtIndex(i);
+		}
+		else
+		{
+			target.setFalseAtIndex(i);
+		}
+	}
+}
+
+/***************************************************
+* private functions END
+***************************************************/
@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include "SAT_puzzle.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+
+/// <summary>
+/// Builds the starting assignment of a local search.  The literal weights and the member order
+/// are computed once per formula, so a population can be started without repeating that work;
+/// every strategy is a linear pass over the clauses and occurrence lists.
+/// </summary>
+class Initial_assignment
+{
+public:
+
+	/// <summary>
+	/// RANDOM flips a fair coin per member.
+	/// JEROSLOW_WANG sets each member to the polarity whose clauses weigh more, a clause of length
+	///  k weighing 2^-k.
+	/// PROPAGATION decides members in order of occurrence count, taking the heavier polarity over
+	///  the clauses not yet satisfied, and unit propagates after each decision.  Conflicts are
+	///  left for the search to repair.
+	/// BIASED takes the Jeroslow-Wang polarity with probability BIAS and the other one otherwise.
+	/// </summary>
+	enum Strategy { RANDOM, JEROSLOW_WANG, PROPAGATION, BIASED };
+
+	/// <summary>
+	/// Computes the literal weights and the decision order of a formula.
+	/// </summary>
+	/// <param name="formula">formula whose assignments are to be built</param>
+	Initial_assignment(SAT_puzzle &formula);
+
+	/// <summary>
+	/// Sets every member of a formula by the given strategy.
+	/// </summary>
+	/// <param name="target">the formula given to the constructor, or a copy of it</param>
+	/// <param name="strategy">how the members are set</param>
+	/// <param name="rand">random number source, used for coin flips and ties</param>
+	void assign(SAT_puzzle &target, Strategy strategy, Random ^ rand);
+
+private:
+
+	static const double BIAS;
+
+	/// <summary>
+	/// Gets the polarity with the larger weight, breaking ties randomly.
+	/// </summary>
+	bool heavier(const vector<double> &weights, int member, Random ^ rand);
+
+	/// <summary>
+	/// Greedy construction with unit propagation.  Each clause is satisfied at most once and becomes
+	/// unit at most once, so the work is linear in the size of the formula.
+	/// </summary>
+	void propagate(SAT_puzzle &target, Random ^ rand);
+
+	int numMembers;
+	vector<double> literalWeights; //Jeroslow-Wang weight, at 2 * member for the member and 2 * member + 1 for its negation
+	vector<double> clauseWeights;
+	vector<int> clauseLengths; //distinct literals per clause
+	vector<int> order; //members by descending occurrence count
+};
@@ -0,0 +1,400 @@
+#include "stdafx.h"
+#include "MaxSAT_search.h"
+#include "DPLL.h"
+
+/***************************************************
+* public functions START
+***************************************************/
+
+/// <summary>
+/// Default constructor.
+/// </summary>
+MaxSAT_search::MaxSAT_search()
+{
+	soft_cost = 0;
+	best_cost = -1;
+	reported_cost = -1;
+	empty_hard = false;
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+MaxSAT_search::MaxSAT_search(SAT_puzzle inPuzzle)
+{
+	baseFormula = std::move(inPuzzle);
+	soft_cost = 0;
+	best_cost = -1;
+	reported_cost = -1;
+	empty_hard = false;
+}
+
+/// <summary>
+/// Runs the search until every clause is satisfied or time runs out.
+/// </summary>
+/// <returns>-1 if every clause was satisfied, DPLL::UNSATISFIABLE if a hard clause is empty,
+/// otherwise the number of clauses satisfied by the best assignment.</returns>
+int MaxSAT_search::run_MaxSAT()
+{
+	Random ^ rand = (seed < 0) ? gcnew Random() : gcnew Random(seed);
+	Stopwatch ^ timeKeeper = gcnew Stopwatch();
+	timeKeeper->Start();
+
+	int numMembers = baseFormula.getNumMembers();
+	values.resize(numMembers);
+	for (int i = 0; i < numMembers; i++)
+	{
+		values[i] = (char)rand->Next(2);
+	}
+	initialize();
+	if (empty_hard)
+	{
+		timeKeeper->Stop();
+		return DPLL::UNSATISFIABLE;
+	}
+
+	vector<char> bestValues = values;
+	best_cost = -1;
+	reported_cost = -1;
+	long long steps = 0, lastReport = -REPORTINTERVAL;
+	//every hard clause weighs the same, so the least falsified hard weight is the fewest falsified hard clauses
+	size_t leastHard = falsified_hard.size();
+
+	while (true)
+	{
+		//an assignment satisfying every hard clause is a candidate answer; until one is seen, the
+		// assignment closest to one is kept instead, so a run cut off early still reports its progress
+		if (falsified_hard.empty() && (best_cost < 0 || soft_cost < best_cost))
+		{
+			best_cost = soft_cost;
+			bestValues = values;
+		}
+		else if (best_cost < 0 && falsified_hard.size() < leastHard)
+		{
+			leastHard = falsified_hard.size();
+			bestValues = values;
+		}
+		if (falsified_hard.empty() && falsified_soft.empty())
+		{
+			break;
+		}
+
+		//the clock is only read, and progress published and reported, every 256 steps to keep them
+		// off the flip path
+		if ((++steps & 255) == 0)
+		{
+			long long elapsed = timeKeeper->ElapsedMilliseconds;
+			if (elapsed >= MAXTIME)
+			{
+				break;
+			}
+			if (elapsed - lastReport >= REPORTINTERVAL && best_cost != reported_cost)
+			{
+				reportCost();
+				lastReport = elapsed;
+			}
+			//soft costs are reported on the o lines, so only the falsified count is published
+			if (progress != nullptr)
+			{
+				progress->publish(steps, (int)(falsified_hard.size() + falsified_soft.size()), -1);
+			}
+		}
+		flip(pickMember(rand));
+	}
+	timeKeeper->Stop();
+	reportCost();
+
+	//leave the best assignment in the formula so it can be reported
+	for (int i = 0; i < numMembers; i++)
+	{
+		baseFormula.setMemberAtIndex(i, bestValues[i] != 0);
+	}
+	int num_trues = baseFormula.check_trues();
+	if (baseFormula.satisfied())
+	{
+		return -1;
+	}
+	else { return num_trues; }
+}
+
+/// <summary>
+/// Gets the cost of the best assignment found.
+/// </summary>
+/// <returns>the total weight of falsified soft clauses, or -1 if no assignment satisfied every hard clause</returns>
+long long MaxSAT_search::getBestCost()
+{
+	return best_cost;
+}
+
+/// <summary>
+/// Gets the formula holding the best assignment found by the search.
+/// </summary>
+/// <returns>the SAT_puzzle object being solved</returns>
+const SAT_puzzle& MaxSAT_search::getFormula()
+{
+	return baseFormula;
+}
+
+/// <summary>
+/// Sets the time budget for subsequent runs.
+/// </summary>
+/// <param name="maxTime">time budget in milliseconds</param>
+void MaxSAT_search::setMaxTime(int maxTime)
+{
+	MAXTIME = maxTime;
+}
+
+/// <summary>
+/// Sets the seed of the random number source, making runs repeatable.
+/// </summary>
+/// <param name="inSeed">seed for subsequent runs; a negative seed draws from the clock</param>
+void MaxSAT_search::setSeed(int inSeed)
+{
+	seed = inSeed;
+}
+
+/// <summary>
+/// Sets where the search publishes its progress for telemetry.
+/// </summary>
+/// <param name="record">progress record owned by the caller, or nullptr for none</param>
+void MaxSAT_search::setProgress(Search_progress *record)
+{
+	progress = record;
+}
+
+/// <summary>
+/// Sets where improved costs are reported as "o" lines.  By default they are not reported.
+/// </summary>
+/// <param name="writer">writer used by the calling thread, or nullptr for none</param>
+void MaxSAT_search::setReport(TextWriter^ writer)
+{
+	report = writer;
+}
+
+/***************************************************
+* public functions END
+***************************************************/
+
+/***************************************************
+* private functions START
+***************************************************/
+
+/// <summary>
+/// Builds the clause lists, true-literal counts and weighted break values for the current assignment.
+/// </summary>
+void MaxSAT_search::initialize()
+{
+	int numClauses = baseFormula.getNumClauses();
+
+	//a hard clause is weighted as all soft clauses together plus one, so breaking one is never
+	// preferred to breaking soft clauses; this also keeps sums clear of overflow for large tops
+	long long softTotal = 0;
+	hard.assign(numClauses, 0);
+	for (int i = 0; i < numClauses; i++)
+	{
+		if (baseFormula.isHardClause(i))
+		{
+			hard[i] = 1;
+		}
+		else
+		{
+			softTotal += baseFormula.getClauseWeight(i);
+		}
+	}
+	weights.resize(numClauses);
+	for (int i = 0; i < numClauses; i++)
+	{
+		weights[i] = hard[i] ? softTotal + 1 : baseFormula.getClauseWeight(i);
+	}
+
+	clauses.assign(numClauses, vector<int>());
+	true_counts.assign(numClauses, 0);
+	true_sums.assign(numClauses, 0);
+	breaks.assign(baseFormula.getNumMembers(), 0);
+	falsified_hard.clear();
+	falsified_soft.clear();
+	falsified_pos.assign(numClauses, -1);
+	soft_cost = 0;
+	empty_hard = false;
+
+	for (int i = 0; i < numClauses; i++)
+	{
+		//a tautology is satisfied whatever is flipped, and is in no occurrence list, so it is left out
+		// rather than charging its true member a break
+		if (!baseFormula.getDistinctLiterals(i, clauses[i]))
+		{
+			continue;
+		}
+		for (unsigned int j = 0; j < clauses[i].size(); j++)
+		{
+			int literal = clauses[i][j];
+			int member = (literal > 0) ? literal - 1 : (-literal) - 1;
+			if ((literal > 0) == (values[member] != 0))
+			{
+				true_counts[i]++;
+				true_sums[i] += member;
+			}
+		}
+
+		//An empty clause is falsified by every assignment: a soft one is a fixed part of the cost and
+		// a hard one leaves nothing feasible.  Neither joins the falsified lists, which must only hold
+		// clauses with a member to flip.
+		if (clauses[i].empty())
+		{
+			if (hard[i])
+			{
+				empty_hard = true;
+			}
+			else
+			{
+				soft_cost += weights[i];
+			}
+		}
+		else if (true_counts[i] == 0)
+		{
+			addFalsified(i);
+		}
+		else if (true_counts[i] == 1)
+		{
+			breaks[true_sums[i]] += weights[i];
+		}
+	}
+}
+
+/// <summary>
+/// Flips a member, updating true-literal counts, weighted breaks, the soft cost and the number of
+/// falsified hard clauses.
+/// </summary>
+/// <param name="member">index of the member to be flipped</param>
+void MaxSAT_search::flip(int member)
+{
+	values[member] = !values[member];
+	int trueLiteral = values[member] ? member + 1 : -(member + 1);
+
+	const vector<int> &made = baseFormula.getOccurrences(trueLiteral);
+	for (unsigned int i = 0; i < made.size(); i++)
+	{
+		int c = made[i];
+		if (true_counts[c] == 0)
+		{
+			removeFalsified(c);
+			breaks[member] += weights[c];
+		}
+		else if (true_counts[c] == 1)
+		{
+			breaks[true_sums[c]] -= weights[c];
+		}
+		true_counts[c]++;
+		true_sums[c] += member;
+	}
+
+	const vector<int> &broken = baseFormula.getOccurrences(-trueLiteral);
+	for (unsigned int i = 0; i < broken.size(); i++)
+	{
+		int c = broken[i];
+		true_counts[c]--;
+		true_sums[c] -= member;
+		if (true_counts[c] == 0)
+		{
+			addFalsified(c);
+			breaks[member] -= weights[c];
+		}
+		else if (true_counts[c] == 1)
+		{
+			breaks[true_sums[c]] += weights[c];
+		}
+	}
+}
+
+/// <summary>
+/// Chooses the member to flip: from a falsified hard clause if there is one, otherwise from a
+/// falsified soft clause, taking the lowest weighted break or, with probability NOISE, a random member.
+/// </summary>
+/// <param name="rand">random number source</param>
+/// <returns>the index of the chosen member</returns>
+int MaxSAT_search::pickMember(Random ^ rand)
+{
+	int c;
+	if (!falsified_hard.empty())
+	{
+		c = falsified_hard[rand->Next((int)falsified_hard.size())];
+	}
+	else
+	{
+		c = falsified_soft[rand->Next((int)falsified_soft.size())];
+	}
+	const vector<int> &clause = clauses[c];
+
+	if (rand->NextDouble() < NOISE)
+	{
+		return abs(clause[rand->Next((int)clause.size())]) - 1;
+	}
+
+	long long bestBreak = -1;
+	candidates.clear();
+	for (unsigned int j = 0; j < clause.size(); j++)
+	{
+		int member = abs(clause[j]) - 1;
+		if (bestBreak < 0 || breaks[member] < bestBreak)
+		{
+			bestBreak = breaks[member];
+			candidates.clear();
+			candidates.push_back(member);
+		}
+		else if (breaks[member] == bestBreak)
+		{
+			candidates.push_back(member);
+		}
+	}
+	return candidates[rand->Next((int)candidates.size())];
+}
+
+/// <summary>
+/// Writes the best cost as an "o" line, if it has changed since the last one written.
+/// </summary>
+void MaxSAT_search::reportCost()
+{
+	TextWriter^ writer = report;
+	if (writer != nullptr && best_cost >= 0 && best_cost != reported_cost)
+	{
+		writer->WriteLine("o " + best_cost.ToString());
+		reported_cost = best_cost;
+	}
+}
+
+/// <summary>
+/// Adds a clause to the falsified list it belongs to.
+/// </summary>
+void MaxSAT_search::addFalsified(int clause)
+{
+	vector<int> &list = hard[clause] ? falsified_hard : falsified_soft;
+	falsified_pos[clause] = list.size();
+	list.push_back(clause);
+	if (!hard[clause])
+	{
+		soft_cost += weights[clause];
+	}
+}
+
+/// <summary>
+/// Removes a clause from its falsified list in constant time.
+/// </summary>
+void MaxSAT_search::removeFalsified(int clause)
+{
+	vector<int> &list = hard[clause] ? falsified_hard : falsified_soft;
+	int position = falsified_pos[clause];
+	int last = list.back();
+	list[position] = last;
+	falsified_pos[last] = position;
+	list.pop_back();
+	falsified_pos[clause] = -1;
+	if (!hard[clause])
+	{
+		soft_cost -= weights[clause];
+	}
+}
+
+/***************************************************
+* private functions END
+***************************************************/
@@ -0,0 +1,137 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <vcclr.h>
+#include "SAT_puzzle.h"
+#include "Telemetry.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+using namespace System::Diagnostics;
+
+/// <summary>
+/// Class containing the necessary data structures and methods to
+/// approximately solve a weighted MaxSAT formula through use of weighted WalkSAT.
+/// The search is anytime: the cost of falsified soft clauses and the number of falsified
+/// hard clauses are maintained inside the flip loop, and every assignment that satisfies all
+/// hard clauses with a lower cost than any before it is kept; until one is found, the assignment
+/// falsifying the fewest hard clauses is kept in its place.  Improvements are reported as
+/// "o <cost>" lines to a writer chosen by the caller, at most one every REPORTINTERVAL
+/// milliseconds and never from inside the flip loop; the final best cost is always reported.
+/// Plain cnf formulas are treated as having every clause soft with weight 1.
+/// </summary>
+class MaxSAT_search
+{
+public:
+
+	/// <summary>
+	/// Default constructor.
+	/// </summary>
+	MaxSAT_search();
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
+	MaxSAT_search(SAT_puzzle inPuzzle);
+
+	/// <summary>
+	/// Runs the search until every clause is satisfied or time runs out.
+	/// </summary>
+	/// <returns>-1 if every clause was satisfied, DPLL::UNSATISFIABLE if a hard clause is empty,
+	/// otherwise the number of clauses satisfied by the best assignment.</returns>
+	int run_MaxSAT();
+
+	/// <summary>
+	/// Gets the cost of the best assignment found.
+	/// </summary>
+	/// <returns>the total weight of falsified soft clauses, or -1 if no assignment satisfied every hard clause</returns>
+	long long getBestCost();
+
+	/// <summary>
+	/// Gets the formula holding the best assignment found by the search.
+	/// </summary>
+	/// <returns>the SAT_puzzle object being solved</returns>
+	const SAT_puzzle& getFormula();
+
+	/// <summary>
+	/// Sets the time budget for subsequent runs.
+	/// </summary>
+	/// <param name="maxTime">time budget in milliseconds</param>
+	void setMaxTime(int maxTime);
+
+	/// <summary>
+	/// Sets the seed of the random number source, making runs repeatable.
+	/// </summary>
+	/// <param name="inSeed">seed for subsequent runs; a negative seed draws from the clock</param>
+	void setSeed(int inSeed);
+
+	/// <summary>
+	/// Sets where the search publishes its progress for telemetry.
+	/// </summary>
+	/// <param name="record">progress record owned by the caller, or nullptr for none</param>
+	void setProgress(Search_progress *record);
+
+	/// <summary>
+	/// Sets where improved costs are reported as "o" lines.  By default they are not reported.
+	/// </summary>
+	/// <param name="writer">writer used by the calling thread, or nullptr for none</param>
+	void setReport(TextWriter^ writer);
+
+private:
+
+	/// <summary>
+	/// Builds the clause lists, true-literal counts and weighted break values for the current assignment.
+	/// </summary>
+	void initialize();
+
+	/// <summary>
+	/// Flips a member, updating true-literal counts, weighted breaks, the soft cost and the number of
+	/// falsified hard clauses.
+	/// </summary>
+	/// <param name="member">index of the member to be flipped</param>
+	void flip(int member);
+
+	/// <summary>
+	/// Chooses the member to flip: from a falsified hard clause if there is one, otherwise from a
+	/// falsified soft clause, taking the lowest weighted break or, with probability NOISE, a random member.
+	/// </summary>
+	/// <param name="rand">random number source</param>
+	/// <returns>the index of the chosen member</returns>
+	int pickMember(Random ^ rand);
+
+	/// <summary>
+	/// Writes the best cost as an "o" line, if it has changed since the last one written.
+	/// </summary>
+	void reportCost();
+
+	/// <summary>
+	/// Adds a clause to the falsified list it belongs to.
+	/// </summary>
+	void addFalsified(int clause);
+
+	/// <summary>
+	/// Removes a clause from its falsified list in constant time.
+	/// </summary>
+	void removeFalsified(int clause);
+
+	SAT_puzzle baseFormula;
+	int MAXTIME = 10000;
+	Search_progress *progress = nullptr;
+	int seed = -1;
+	double NOISE = 0.2;
+	//milliseconds between "o" lines while the search runs
+	int REPORTINTERVAL = 1000;
+	gcroot<TextWriter^> report;
+	long long reported_cost; //cost on the last "o" line, or -1
+
+	vector<vector<int>> clauses; //literals of each clause, with repeats removed; none for a tautology
+	vector<long long> weights; //search weight of each clause; hard clauses outweigh all soft ones together
+	vector<char> hard, values;
+	vector<int> true_counts, true_sums;
+	vector<long long> breaks;
+	vector<int> falsified_hard, falsified_soft, falsified_pos, candidates;
+	long long soft_cost, best_cost;
+	bool empty_hard; //a hard clause has no literals, so no assignment is feasible
+};
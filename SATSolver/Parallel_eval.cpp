@@ -0,0 +1,80 @@
+#include "stdafx.h"
+#include "Parallel_eval.h"
+
+/***************************************************
+* public functions START
+***************************************************/
+
+/// <summary>
+/// Evaluates every clause of the puzzle over clause ranges run in parallel.
+/// </summary>
+/// <param name="puzzle">SAT_puzzle object to be evaluated.</param>
+/// <returns>the number of satisfied clauses</returns>
+int Parallel_eval::check_trues(SAT_puzzle* puzzle)
+{
+	//clause_list is a packed vector<bool>, so chunks are aligned to 64 clauses to keep two threads
+	// from ever writing bits of the same word.
+	int numClauses = puzzle->getNumClauses();
+	Parallel_eval^ eval = gcnew Parallel_eval(puzzle, numClauses, chooseChunkSize(numClauses, 64));
+	Parallel::For(0, eval->numChunks, gcnew Action<int>(eval, &Parallel_eval::evaluateClauseChunk));
+
+	//Chunk totals are summed in order so the result does not depend on scheduling
+	int total = 0;
+	for (int i = 0; i < eval->numChunks; i++)
+	{
+		total += eval->chunkValues[i];
+	}
+	return total;
+}
+
+/***************************************************
+* public functions END
+***************************************************/
+
+/***************************************************
+* private functions START
+***************************************************/
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="puzzle">SAT_puzzle object being worked on.</param>
+/// <param name="numItems">total number of clauses or members to be split</param>
+/// <param name="chunkSize">number of items handled by each task</param>
+Parallel_eval::Parallel_eval(SAT_puzzle* puzzle, int numItems, int chunkSize)
+{
+	this->puzzle = puzzle;
+	this->numItems = numItems;
+	this->chunkSize = chunkSize;
+	numChunks = (numItems + chunkSize - 1) / chunkSize;
+	chunkValues = gcnew array<int>(numChunks);
+}
+
+/// <summary>
+/// Evaluates the clauses of one chunk, storing the satisfied count for that chunk.
+/// </summary>
+/// <param name="chunk">index of the chunk to be evaluated</param>
+void Parallel_eval::evaluateClauseChunk(int chunk)
+{
+	int first = chunk * chunkSize;
+	int last = Math::Min(first + chunkSize, numItems);
+	chunkValues[chunk] = puzzle->check_trues_range(first, last);
+}
+
+/// <summary>
+/// Chooses a chunk size giving several chunks per core, so idle threads can steal work.
+/// </summary>
+/// <param name="numItems">total number of items to be split</param>
+/// <param name="alignment">chunk sizes are rounded up to a multiple of this value</param>
+/// <returns>the number of items handled by each task</returns>
+int Parallel_eval::chooseChunkSize(int numItems, int alignment)
+{
+	int numTasks = Environment::ProcessorCount * 4;
+	int size = (numItems + numTasks - 1) / numTasks;
+	size = ((size + alignment - 1) / alignment) * alignment;
+	return size > 0 ? size : alignment;
+}
+
+/***************************************************
+* private functions END
+***************************************************/
@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include "SAT_puzzle.h"
+using namespace std;
+using namespace System;
+using namespace System::Threading::Tasks;
+
+/// <summary>
+/// Splits the full clause evaluation of a large formula into clause ranges that are run on the
+/// .NET work-stealing thread pool.
+/// Partial results are reduced in range order, so the outcome is identical to a serial pass.
+/// </summary>
+ref class Parallel_eval
+{
+public:
+
+	/// <summary>
+	/// Formulas with at least this many clauses are recounted from scratch over clause ranges split across threads.
+	/// </summary>
+	literal int CLAUSE_THRESHOLD = 65536;
+
+	/// <summary>
+	/// Evaluates every clause of the puzzle over clause ranges run in parallel.
+	/// </summary>
+	/// <param name="puzzle">SAT_puzzle object to be evaluated.</param>
+	/// <returns>the number of satisfied clauses</returns>
+	static int check_trues(SAT_puzzle* puzzle);
+
+private:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="puzzle">SAT_puzzle object being worked on.</param>
+	/// <param name="numItems">total number of clauses or members to be split</param>
+	/// <param name="chunkSize">number of items handled by each task</param>
+	Parallel_eval(SAT_puzzle* puzzle, int numItems, int chunkSize);
+
+	/// <summary>
+	/// Evaluates the clauses of one chunk, storing the satisfied count for that chunk.
+	/// </summary>
+	/// <param name="chunk">index of the chunk to be evaluated</param>
+	void evaluateClauseChunk(int chunk);
+
+	/// <summary>
+	/// Chooses a chunk size giving several chunks per core, so idle threads can steal work.
+	/// </summary>
+	/// <param name="numItems">total number of items to be split</param>
+	/// <param name="alignment">chunk sizes are rounded up to a multiple of this value</param>
+	/// <returns>the number of items handled by each task</returns>
+	static int chooseChunkSize(int numItems, int alignment);
+
+	SAT_puzzle* puzzle;
+	int numItems, chunkSize, numChunks;
+	array<int>^ chunkValues;
+};
@@ -0,0 +1,143 @@
+#include "stdafx.h"
+#include "Proof_writer.h"
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="path">proof file to be written</param>
+/// <param name="inLrat">true for LRAT, where every lemma carries an id and its unit propagation hints</param>
+Proof_writer::Proof_writer(String^ path, bool inLrat)
+{
+	file = gcnew FileStream(path, FileMode::Create, FileAccess::Write, FileShare::Read, 4096, FileOptions::SequentialScan);
+	lrat = inLrat;
+	filling = gcnew array<Byte>(BUFFER_SIZE);
+	pending = gcnew array<Byte>(BUFFER_SIZE);
+	used = 0;
+	pendingUsed = 0;
+	closing = false;
+	pendingReady = gcnew AutoResetEvent(false);
+	pendingFree = gcnew AutoResetEvent(true);
+	writerThread = gcnew Thread(gcnew ThreadStart(this, &Proof_writer::Run));
+	writerThread->IsBackground = true;
+	writerThread->Start();
+}
+
+/// <summary>
+/// Determines whether lemmas must be given ids and hints.
+/// </summary>
+/// <returns>true for LRAT, false for DRAT</returns>
+bool Proof_writer::isLRAT()
+{
+	return lrat;
+}
+
+/// <summary>
+/// Adds a DRAT lemma.
+/// </summary>
+/// <param name="literals">literals of the lemma, numbered as in the cnf file</param>
+void Proof_writer::addLemma(const vector<int> &literals)
+{
+	putByte('a');
+	for (unsigned int i = 0; i < literals.size(); i++)
+	{
+		putNumber(literals[i]);
+	}
+	putByte(0);
+}
+
+/// <summary>
+/// Adds an LRAT lemma.
+/// </summary>
+/// <param name="id">id of the lemma; ids continue from the number of clauses in the formula</param>
+/// <param name="literals">literals of the lemma, numbered as in the cnf file</param>
+/// <param name="hints">ids of the clauses that become unit, in order, ending with the falsified one</param>
+void Proof_writer::addLemma(long long id, const vector<int> &literals, const vector<long long> &hints)
+{
+	putByte('a');
+	putNumber(id);
+	for (unsigned int i = 0; i < literals.size(); i++)
+	{
+		putNumber(literals[i]);
+	}
+	putByte(0);
+	for (unsigned int i = 0; i < hints.size(); i++)
+	{
+		putNumber(hints[i]);
+	}
+	putByte(0);
+}
+
+/// <summary>
+/// Writes everything still buffered and closes the file.
+/// </summary>
+void Proof_writer::close()
+{
+	if (closing)
+	{
+		return;
+	}
+	swapBuffers();
+	pendingFree->WaitOne();
+	closing = true;
+	pendingReady->Set();
+	writerThread->Join();
+	file->Close();
+}
+
+/// <summary>
+/// Encodes one number, passing the buffer to the writing thread when it is full.
+/// </summary>
+void Proof_writer::putNumber(long long value)
+{
+	unsigned long long encoded = (value < 0) ? 2 * (unsigned long long)(-value) + 1 : 2 * (unsigned long long)value;
+	while (encoded > 127)
+	{
+		putByte((Byte)(128 | (encoded & 127)));
+		encoded >>= 7;
+	}
+	putByte((Byte)encoded);
+}
+
+/// <summary>
+/// Appends one byte, passing the buffer to the writing thread when it is full.
+/// </summary>
+void Proof_writer::putByte(Byte value)
+{
+	if (used == BUFFER_SIZE)
+	{
+		swapBuffers();
+	}
+	filling[used++] = value;
+}
+
+/// <summary>
+/// Hands the filled buffer to the writing thread and takes the other one.
+/// </summary>
+void Proof_writer::swapBuffers()
+{
+	//wait until the previous buffer is on disk before reusing it
+	pendingFree->WaitOne();
+	array<Byte>^ written = pending;
+	pending = filling;
+	pendingUsed = used;
+	filling = written;
+	used = 0;
+	pendingReady->Set();
+}
+
+/// <summary>
+/// Body of the writing thread.
+/// </summary>
+void Proof_writer::Run()
+{
+	while (true)
+	{
+		pendingReady->WaitOne();
+		if (closing)
+		{
+			return;
+		}
+		file->Write(pending, 0, pendingUsed);
+		pendingFree->Set();
+	}
+}
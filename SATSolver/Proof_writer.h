@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+using namespace System::Threading;
+
+/// <summary>
+/// Writes a clausal proof in binary DRAT or binary LRAT.  Lemmas are encoded into one of two
+/// large buffers; a full buffer is handed to a background thread that writes it to disk while
+/// the solver fills the other, so the solver only waits when the disk falls a whole buffer behind.
+/// Numbers use the variable-length binary DRAT encoding: 2*x for positive and 2*|x|+1 for
+/// negative values, seven bits per byte.
+/// </summary>
+ref class Proof_writer
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="path">proof file to be written</param>
+	/// <param name="inLrat">true for LRAT, where every lemma carries an id and its unit propagation hints</param>
+	Proof_writer(String^ path, bool inLrat);
+
+	/// <summary>
+	/// Determines whether lemmas must be given ids and hints.
+	/// </summary>
+	/// <returns>true for LRAT, false for DRAT</returns>
+	bool isLRAT();
+
+	/// <summary>
+	/// Adds a DRAT lemma.
+	/// </summary>
+	/// <param name="literals">literals of the lemma, numbered as in the cnf file</param>
+	void addLemma(const vector<int> &literals);
+
+	/// <summary>
+	/// Adds an LRAT lemma.
+	/// </summary>
+	/// <param name="id">id of the lemma; ids continue from the number of clauses in the formula</param>
+	/// <param name="literals">literals of the lemma, numbered as in the cnf file</param>
+	/// <param name="hints">ids of the clauses that become unit, in order, ending with the falsified one</param>
+	void addLemma(long long id, const vector<int> &literals, const vector<long long> &hints);
+
+	/// <summary>
+	/// Writes everything still buffered and closes the file.
+	/// </summary>
+	void close();
+
+private:
+
+	/// <summary>
+	/// Encodes one number, passing the buffer to the writing thread when it is full.
+	/// </summary>
+	void putNumber(long long value);
+
+	/// <summary>
+	/// Appends one byte, passing the buffer to the writing thread when it is full.
+	/// </summary>
+	void putByte(Byte value);
+
+	/// <summary>
+	/// Hands the filled buffer to the writing thread and takes the other one.
+	/// </summary>
+	void swapBuffers();
+
+	/// <summary>
+	/// Body of the writing thread.
+	/// </summary>
+	void Run();
+
+	literal int BUFFER_SIZE = 1 << 20;
+
+	FileStream^ file;
+	bool lrat;
+	array<Byte>^ filling; //buffer the solver encodes into
+	array<Byte>^ pending; //buffer handed to the writing thread
+	int used, pendingUsed;
+	bool closing;
+	AutoResetEvent^ pendingReady; //set when pending holds data to write
+	AutoResetEvent^ pendingFree; //set when the writing thread has finished with pending
+	Thread^ writerThread;
+};
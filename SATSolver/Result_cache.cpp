@@ -0,0 +1,192 @@
+#include "stdafx.h"
+#include "Result_cache.h"
+#include "DPLL.h"
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inDirectory">directory holding the entries; created when the first one is stored</param>
+Result_cache::Result_cache(String^ inDirectory)
+{
+	directory = inDirectory;
+}
+
+/// <summary>
+/// Looks a formula up.
+/// </summary>
+/// <param name="formula">formula about to be solved</param>
+/// <param name="result">receives -1 if satisfiable or DPLL::UNSATISFIABLE</param>
+/// <param name="model">receives the checked model of a satisfiable formula, in the file's numbering</param>
+/// <returns>true if a usable entry was found</returns>
+bool Result_cache::lookup(SAT_puzzle &formula, int &result, vector<bool> &model)
+{
+	String^ hash = formula.getCanonicalHash();
+	if (hash == nullptr)
+	{
+		return false;
+	}
+
+	//a missing, unreadable or malformed entry is treated as a miss
+	int status = 0;
+	vector<bool> cached(formula.getNumMembers());
+	try
+	{
+		String^ path = Path::Combine(directory, hash + ".txt");
+		if (!File::Exists(path))
+		{
+			return false;
+		}
+		for each (String^ line in File::ReadAllLines(path))
+		{
+			array<String^>^ token = line->Split((array<wchar_t>^)nullptr, StringSplitOptions::RemoveEmptyEntries);
+			if (token->Length == 2 && token[0] == "s" && token[1] == "SATISFIABLE")
+			{
+				status = -1;
+			}
+			else if (token->Length == 2 && token[0] == "s" && token[1] == "UNSATISFIABLE")
+			{
+				status = DPLL::UNSATISFIABLE;
+			}
+			else if (token->Length > 0 && token[0] == "v")
+			{
+				for (int i = 1; i < token->Length; i++)
+				{
+					int literal = int::Parse(token[i]);
+					if (abs(literal) > (int)cached.size())
+					{
+						return false;
+					}
+					if (literal != 0)
+					{
+						cached[abs(literal) - 1] = literal > 0;
+					}
+				}
+			}
+		}
+	}
+	catch (Exception^ read_error)
+	{
+		return false;
+	}
+
+	if (status == 0 || (status == -1 && !verify(formula, cached)))
+	{
+		return false;
+	}
+	result = status;
+	if (status == -1)
+	{
+		model = cached;
+	}
+	return true;
+}
+
+/// <summary>
+/// Stores a result if it is settled; any other result is ignored.
+/// </summary>
+/// <param name="formula">formula that was solved</param>
+/// <param name="result">result returned by the solver</param>
+/// <param name="model">model of a satisfiable formula, in the file's numbering</param>
+/// <param name="solver">name of the solver that found the result</param>
+/// <param name="budget">time budget the solver was given in milliseconds, or 0 for its default</param>
+void Result_cache::store(SAT_puzzle &formula, int result, const vector<bool> &model, String^ solver, int budget)
+{
+	String^ hash = formula.getCanonicalHash();
+	if (hash == nullptr || (result != -1 && result != DPLL::UNSATISFIABLE) || (result == -1 && !verify(formula, model)))
+	{
+		return;
+	}
+
+	String^ path = Path::Combine(directory, hash + ".txt");
+	String^ temporary = path + "." + Path::GetRandomFileName() + ".tmp";
+	try
+	{
+		Directory::CreateDirectory(directory);
+		StreamWriter^ writer = gcnew StreamWriter(temporary);
+		try
+		{
+			if (result == -1)
+			{
+				writer->WriteLine("s SATISFIABLE");
+			}
+			else
+			{
+				writer->WriteLine("s UNSATISFIABLE");
+			}
+			writer->WriteLine("c solver " + solver);
+			writer->WriteLine("c budget " + budget.ToString());
+			if (result == -1)
+			{
+				String^ line = "v";
+				for (unsigned int i = 0; i < model.size(); i++)
+				{
+					int literal = model[i] ? (int)i + 1 : -((int)i + 1);
+					line += " " + literal.ToString();
+					if ((i + 1) % 20 == 0)
+					{
+						writer->WriteLine(line);
+						line = "v";
+					}
+				}
+				writer->WriteLine(line + " 0");
+			}
+		}
+		finally
+		{
+			writer->Close();
+		}
+
+		//the first complete entry for a formula is kept
+		if (File::Exists(path))
+		{
+			File::Delete(temporary);
+		}
+		else
+		{
+			File::Move(temporary, path);
+		}
+	}
+	//the cache only saves time, so a failed write is not an error
+	catch (Exception^ write_error)
+	{
+		try
+		{
+			File::Delete(temporary);
+		}
+		catch (Exception^ delete_error)
+		{
+		}
+	}
+}
+
+/// <summary>
+/// Determines whether a model, in the file's numbering, satisfies every clause of a formula
+/// that may since have been renumbered.
+/// </summary>
+bool Result_cache::verify(SAT_puzzle &formula, const vector<bool> &model)
+{
+	if ((int)model.size() != formula.getNumMembers())
+	{
+		return false;
+	}
+	const vector<int> &original = formula.getOriginalIndices();
+	for (int i = 0; i < formula.getNumClauses(); i++)
+	{
+		const vector<int> &clause = formula.getClause(i);
+		bool satisfied = false;
+		for (unsigned int j = 0; j < clause.size() && clause[j] != 0 && !satisfied; j++)
+		{
+			int member = abs(clause[j]) - 1;
+			if (!original.empty())
+			{
+				member = original[member];
+			}
+			satisfied = model[member] == (clause[j] > 0);
+		}
+		if (!satisfied)
+		{
+			return false;
+		}
+	}
+	return true;
+}
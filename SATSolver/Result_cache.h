@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SAT_puzzle.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+
+/// <summary>
+/// On-disk cache of settled results, so a formula submitted again, even with its clauses or
+/// literals reordered, is answered without searching.  Each entry is a small text file named by
+/// the formula's canonical hash:
+///   s SATISFIABLE | s UNSATISFIABLE
+///   c solver <name>
+///   c budget <ms>
+///   v lines holding the model, in the file's numbering, for satisfiable formulas
+/// Only proofs of unsatisfiability and models are stored; a search that ran out of time may do
+/// better with another seed or budget.  A cached model is checked against the formula before it
+/// is used, so a stale or damaged entry is simply ignored.  Weighted formulas are not cached.
+/// Entries are written to a temporary file first, so concurrent writers never leave a partial one.
+/// </summary>
+ref class Result_cache
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inDirectory">directory holding the entries; created when the first one is stored</param>
+	Result_cache(String^ inDirectory);
+
+	/// <summary>
+	/// Looks a formula up.
+	/// </summary>
+	/// <param name="formula">formula about to be solved</param>
+	/// <param name="result">receives -1 if satisfiable or DPLL::UNSATISFIABLE</param>
+	/// <param name="model">receives the checked model of a satisfiable formula, in the file's numbering</param>
+	/// <returns>true if a usable entry was found</returns>
+	bool lookup(SAT_puzzle &formula, int &result, vector<bool> &model);
+
+	/// <summary>
+	/// Stores a result if it is settled; any other result is ignored.
+	/// </summary>
+	/// <param name="formula">formula that was solved</param>
+	/// <param name="result">result returned by the solver</param>
+	/// <param name="model">model of a satisfiable formula, in the file's numbering</param>
+	/// <param name="solver">name of the solver that found the result</param>
+	/// <param name="budget">time budget the solver was given in milliseconds, or 0 for its default</param>
+	void store(SAT_puzzle &formula, int result, const vector<bool> &model, String^ solver, int budget);
+
+	//directory used when none is configured, relative to the working directory
+	literal String^ DEFAULT_DIRECTORY = "result_cache";
+
+private:
+
+	/// <summary>
+	/// Determines whether a model, in the file's numbering, satisfies every clause of a formula
+	/// that may since have been renumbered.
+	/// </summary>
+	static bool verify(SAT_puzzle &formula, const vector<bool> &model);
+
+	String^ directory;
+};
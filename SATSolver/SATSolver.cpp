@@ -21,6 +21,19 @@
 #include "Genetic.h"
 #include "Hill_climb.h"
 #include "WalkSAT.h"
+#include "Clause_weighting.h"
+#include "Cooperative_search.h"
+#include "DPLL.h"
+#include "Cube_conquer.h"
+#include "Formula_reorder.h"
+#include "MaxSAT_search.h"
+#include "Component_search.h"
+#include "Exhaustive_search.h"
+#include "Solver_selector.h"
+#include "Solver_server.h"
+#include "Batch_runner.h"
+#include "Result_cache.h"
+#include "Telemetry.h"
 #using <System.dll>
 using namespace std;
 using namespace System;
@@ -28,18 +41,95 @@ using namespace System::IO;
 using namespace System::Diagnostics;
 
 /*Struct used to store both the number of clauses satisfied and the
-* amount of time that a solve attempt took to complete.*/
+* amount of time that a solve attempt took to complete.
+* When the formula is satisfied, model holds the satisfying assignment
+* in the variable numbering of the original file.
+* cost is the weight of the best assignment found by the MaxSAT search,
+* or -1 when no such assignment exists.
+* noise is the random step probability WalkSAT adapted to, or -1 for other solvers.*/
 struct Solve_results
 {
 	int satisfied_clauses;
 	int time_elapsed;
+	vector<bool> model;
+	long long cost;
+	double noise;
 };
 
 SAT_puzzle loadProblem();
-Solve_results runSolver(SAT_puzzle myprob);
+Solve_results runSolver(SAT_puzzle myprob, int masterSeed);
+void printModel(vector<bool> model);
+bool askYesNo(String^ question);
+Initial_assignment::Strategy askInitialization();
+int runCommandLine(array<String^>^ args, int masterSeed);
+int runCheckpointed(String^ solver, String^ filename, String^ checkpoint, int budget, int masterSeed);
+int runProved(String^ filename, String^ proofname, bool lrat);
+int runBench(int formulas, int runs, int masterSeed);
+String^ benchFormula(int index);
 
 int _tmain(int argc, _TCHAR* argv[])
 {
+	//options that may precede any mode, interactive included:
+	// progress lines for long runs, --telemetry <ms> <file|->
+	// repeatable searches, --seed <master seed>
+	int first = 1, masterSeed = -1;
+	while (argc > first)
+	{
+		String^ option = gcnew String(argv[first]);
+		if (option == "--telemetry")
+		{
+			int interval;
+			if (argc < first + 3 || !int::TryParse(gcnew String(argv[first + 1]), interval) || interval <= 0)
+			{
+				Console::WriteLine("Usage: SATSolver --telemetry <ms> <file|-> [mode arguments]");
+				return 1;
+			}
+			String^ target = gcnew String(argv[first + 2]);
+			try
+			{
+				TextWriter^ output = Console::Error;
+				if (target != "-")
+				{
+					//flushed line by line, so the file can be followed while the search runs
+					StreamWriter^ file = gcnew StreamWriter(target, true);
+					file->AutoFlush = true;
+					output = file;
+				}
+				Telemetry::configure(interval, TextWriter::Synchronized(output));
+			}
+			catch (Exception^ open_error)
+			{
+				Console::WriteLine("Telemetry file " + target + " could not be opened: " + open_error->Message);
+				return 1;
+			}
+			first += 3;
+		}
+		else if (option == "--seed")
+		{
+			if (argc < first + 2 || !int::TryParse(gcnew String(argv[first + 1]), masterSeed) || masterSeed < 0)
+			{
+				Console::WriteLine("Usage: SATSolver --seed <non-negative integer> [mode arguments]");
+				return 1;
+			}
+			first += 2;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	//Any other arguments select a non-interactive mode
+	if (argc > first)
+	{
+		array<String^>^ args = gcnew array<String^>(argc - first);
+		for (int i = first; i < argc; i++)
+		{
+			args[i - first] = gcnew String(argv[i]);
+		}
+		return runCommandLine(args, masterSeed);
+	}
+
 	int ret_int = 0;
 	Console::WriteLine("Welcome to SAT Solver!");
 	bool run_solve_algorithm = true, file_loaded = false, load_new = true;
@@ -58,6 +148,21 @@ int _tmain(int argc, _TCHAR* argv[])
 				myprob = loadProblem();
 				Console::WriteLine("Problem loaded.");
 				file_loaded = true;
+
+				//independent sub-problems are worth knowing about before picking a solver
+				Component_split components(myprob);
+				if (components.getNumComponents() > 1)
+				{
+					Console::WriteLine("The formula splits into " + components.getNumComponents().ToString() + " independent components.");
+				}
+
+				//Renumbering is optional; models are still reported in the file's own numbering
+				if (askYesNo("Reorder variables and clauses for cache locality? y/n:"))
+				{
+					Formula_reorder reorderer;
+					reorderer.reorder(myprob);
+					Console::WriteLine("Formula reordered.");
+				}
 			}
 			catch (String^ thrown_string)
 			{
@@ -76,22 +181,41 @@ int _tmain(int argc, _TCHAR* argv[])
 		{
 			Stopwatch ^ timeKeep = gcnew Stopwatch();
 
-			Solve_results results = runSolver(myprob);
+			Solve_results results = runSolver(myprob, masterSeed);
 			if (results.satisfied_clauses == -1)
 			{
 				Console::WriteLine("SATISFIABLE");
 				Console::WriteLine("milliseconds elapsed: " + results.time_elapsed.ToString());
 				Console::WriteLine("clauses satisfied: " + myprob.getNumClauses().ToString());
+				if (results.noise >= 0)
+				{
+					Console::WriteLine("final noise: " + results.noise.ToString("F3"));
+				}
+				printModel(results.model);
 			}
 			else if (results.satisfied_clauses == -2)
 			{
 				Console::WriteLine("Solve attempt aborted.");
 			}
+			else if (results.satisfied_clauses == DPLL::UNSATISFIABLE)
+			{
+				Console::WriteLine("UNSATISFIABLE (proven by complete search)");
+				Console::WriteLine("milliseconds elapsed: " + results.time_elapsed.ToString());
+			}
 			else
 			{
 				Console::WriteLine("UNSATISFIABLE");
 				Console::WriteLine("milliseconds elapsed: " + results.time_elapsed.ToString());
 				Console::WriteLine("clauses satisfied: " + results.satisfied_clauses.ToString());
+				if (results.noise >= 0)
+				{
+					Console::WriteLine("final noise: " + results.noise.ToString("F3"));
+				}
+				if (results.cost >= 0)
+				{
+					Console::WriteLine("best cost: " + results.cost.ToString());
+					printModel(results.model);
+				}
 			}
 			ret_int = 0;
 		}
@@ -181,18 +305,58 @@ SAT_puzzle loadProblem()
 /// given problem.
 /// </summary>
 /// <param name="myprob">SAT problem to be solved.</param>
-Solve_results runSolver(SAT_puzzle myprob)
+/// <param name="masterSeed">seed making the search repeatable, or -1 to draw from the clock.</param>
+Solve_results runSolver(SAT_puzzle myprob, int masterSeed)
 {
 	Stopwatch ^ timeKeep = gcnew Stopwatch();
 	Solve_results Solver_results;
+	Solver_results.cost = -1;
+	Solver_results.noise = -1;
 	bool complete = false;
 
+	//formulas settled before are answered straight away; cached models are checked first
+	Result_cache results(Result_cache::DEFAULT_DIRECTORY);
+	timeKeep->Start();
+	if (results.lookup(myprob, Solver_results.satisfied_clauses, Solver_results.model))
+	{
+		timeKeep->Stop();
+		Solver_results.time_elapsed = timeKeep->ElapsedMilliseconds;
+		Console::WriteLine("Result found in the result cache.");
+		return Solver_results;
+	}
+	timeKeep->Reset();
+
+	//small formulas are settled exactly, faster than any solver on the menu would start up
+	if (Exhaustive_search::suits(myprob))
+	{
+		Console::WriteLine("Formula has " + myprob.getNumMembers().ToString() + " members; trying every assignment.");
+		Exhaustive_search ExhaustiveSolver(myprob);
+		timeKeep->Start();
+		Solver_results.satisfied_clauses = ExhaustiveSolver.run_Exhaustive();
+		timeKeep->Stop();
+		Solver_results.time_elapsed = timeKeep->ElapsedMilliseconds;
+		if (Solver_results.satisfied_clauses == -1)
+			Solver_results.model = ExhaustiveSolver.getFormula().getOriginalMemberList();
+		results.store(myprob, Solver_results.satisfied_clauses, Solver_results.model, "exhaustive", 0);
+		return Solver_results;
+	}
+
 	Console::WriteLine("Please select a SAT-solving method from the following:");
 	Console::WriteLine("0: Genetic evolution");
 	Console::WriteLine("1: Hill-climbing search");
 	Console::WriteLine("2: WalkSAT search");
+	Console::WriteLine("3: Clause-weighting search (PAWS)");
+	Console::WriteLine("4: Clause-weighting search (SAPS)");
+	Console::WriteLine("5: Cooperative parallel WalkSAT");
+	Console::WriteLine("6: DPLL complete search");
+	Console::WriteLine("7: Cube-and-conquer (DPLL in worker processes)");
+	Console::WriteLine("8: Anytime weighted MaxSAT (WalkSAT on wcnf weights)");
+	Console::WriteLine("9: DPLL per independent component, in parallel");
+	Console::WriteLine("a: Automatic selection from instance features");
 	Console::WriteLine("q: Quit the program");
 	String ^ selection = Console::ReadLine();
+	int maxTime = 0;
+	int seed = masterSeed;
 
 	// Check user input to see which of the aforementioned options was chosen
 	// If none of the above are chosen, the user is prompted to enter a valid selection
@@ -207,33 +371,167 @@ Solve_results runSolver(SAT_puzzle myprob)
 		else
 		{
 			int choice;
-			try
+			if (selection == "a" || selection == "A")
 			{
-				choice = int::Parse(selection);
+				// a model in the working directory overrides the built-in one
+				Formula_features features(myprob);
+				Solver_selector selector;
+				try
+				{
+					if (selector.load("solver_model.txt"))
+					{
+						Console::WriteLine("Using solver model solver_model.txt");
+					}
+				}
+				catch (Exception^ thrown_error)
+				{
+					Console::WriteLine(thrown_error->Message);
+					Console::WriteLine("Using the built-in solver model.");
+				}
+				Console::WriteLine("Features: " + features.describe());
+				choice = selector.choose(features);
+				maxTime = selector.getMaxTime();
+				if (masterSeed < 0)
+					seed = selector.getSeed();
+				Console::WriteLine("Selected solver: " + Solver_selector::getSolverName(choice));
+				//genetic, hill climbing, cooperative search and cube and conquer keep their own time limits
+				if (maxTime > 0 && (choice == 0 || choice == 1 || choice == 5 || choice == 7))
+					Console::WriteLine("Warning: " + Solver_selector::getSolverName(choice) + " takes no time limit, ignoring time " + maxTime + " from the solver model.");
 			}
-			catch (Exception^ thrown_error)
+			else
 			{
-				choice = -1;
+				try
+				{
+					choice = int::Parse(selection);
+				}
+				catch (Exception^ thrown_error)
+				{
+					choice = -1;
+				}
 			}
 
 			Genetic GeneSolver = Genetic();
 			Hill_climb HCSolver;
 			WalkSAT WalkSolver;
+			Clause_weighting WeightSolver;
+			Cooperative_search CoopSolver;
+			DPLL DPLLSolver;
+			Cube_conquer CubeSolver;
+			MaxSAT_search MaxSolver;
+			Component_search CompSolver;
+			//one record per processor, as the cooperative search publishes from every worker
+			vector<Search_progress> progress(Environment::ProcessorCount);
+			Telemetry^ telemetry = nullptr;
 			timeKeep->Start();
 			switch (choice)
 			{
 			case 0:
+				if (selection != "a" && selection != "A")
+					GeneSolver.setInitialization(askInitialization());
+				if (seed >= 0)
+					GeneSolver.setSeed(seed);
+				GeneSolver.setProgress(&progress[0]);
+				telemetry = Telemetry::begin(Solver_selector::getSolverName(choice), &progress[0], (int)progress.size());
 				Solver_results.satisfied_clauses = GeneSolver.runGenetic(myprob);
+				if (Solver_results.satisfied_clauses == -1)
+					Solver_results.model = GeneSolver.getSolution().getOriginalMemberList();
 				complete = true;
 				break;
 			case 1:
 				HCSolver = Hill_climb(myprob);
+				if (selection != "a" && selection != "A")
+					HCSolver.setInitialization(askInitialization());
+				if (seed >= 0)
+					HCSolver.setSeed(seed);
+				HCSolver.setProgress(&progress[0]);
+				telemetry = Telemetry::begin(Solver_selector::getSolverName(choice), &progress[0], (int)progress.size());
 				Solver_results.satisfied_clauses = HCSolver.run_HillClimb();
+				if (Solver_results.satisfied_clauses == -1)
+					Solver_results.model = HCSolver.getFormula().getOriginalMemberList();
 				complete = true;
 				break;
 			case 2:
 				WalkSolver = WalkSAT(myprob);
+				if (selection != "a" && selection != "A")
+					WalkSolver.setInitialization(askInitialization());
+				if (maxTime > 0)
+					WalkSolver.setMaxTime(maxTime);
+				if (seed >= 0)
+					WalkSolver.setSeed(seed);
+				WalkSolver.setProgress(&progress[0]);
+				telemetry = Telemetry::begin(Solver_selector::getSolverName(choice), &progress[0], (int)progress.size());
 				Solver_results.satisfied_clauses = WalkSolver.run_WalkSAT();
+				Solver_results.noise = WalkSolver.getNoise();
+				if (Solver_results.satisfied_clauses == -1)
+					Solver_results.model = WalkSolver.getFormula().getOriginalMemberList();
+				complete = true;
+				break;
+			case 3:
+			case 4:
+				WeightSolver = Clause_weighting(myprob, choice == 3 ? Clause_weighting::PAWS : Clause_weighting::SAPS);
+				if (maxTime > 0)
+					WeightSolver.setMaxTime(maxTime);
+				if (seed >= 0)
+					WeightSolver.setSeed(seed);
+				WeightSolver.setProgress(&progress[0]);
+				telemetry = Telemetry::begin(Solver_selector::getSolverName(choice), &progress[0], (int)progress.size());
+				Solver_results.satisfied_clauses = WeightSolver.run_ClauseWeighting();
+				if (Solver_results.satisfied_clauses == -1)
+					Solver_results.model = WeightSolver.getFormula().getOriginalMemberList();
+				complete = true;
+				break;
+			case 5:
+				CoopSolver = Cooperative_search(myprob);
+				if (seed >= 0)
+					CoopSolver.setSeed(seed);
+				CoopSolver.setProgress(&progress[0]);
+				telemetry = Telemetry::begin(Solver_selector::getSolverName(choice), &progress[0], (int)progress.size());
+				Solver_results.satisfied_clauses = CoopSolver.run_Cooperative();
+				if (Solver_results.satisfied_clauses == -1)
+					Solver_results.model = CoopSolver.getFormula().getOriginalMemberList();
+				complete = true;
+				break;
+			case 6:
+				DPLLSolver = DPLL(myprob);
+				if (maxTime > 0)
+					DPLLSolver.setMaxTime(maxTime);
+				DPLLSolver.setProgress(&progress[0]);
+				telemetry = Telemetry::begin(Solver_selector::getSolverName(choice), &progress[0], (int)progress.size());
+				Solver_results.satisfied_clauses = DPLLSolver.run_DPLL();
+				if (Solver_results.satisfied_clauses == -1)
+					Solver_results.model = DPLLSolver.getFormula().getOriginalMemberList();
+				complete = true;
+				break;
+			case 7:
+				CubeSolver = Cube_conquer(myprob);
+				Solver_results.satisfied_clauses = CubeSolver.run_CubeConquer();
+				if (Solver_results.satisfied_clauses == -1)
+					Solver_results.model = CubeSolver.getFormula().getOriginalMemberList();
+				complete = true;
+				break;
+			case 8:
+				MaxSolver = MaxSAT_search(myprob);
+				if (maxTime > 0)
+					MaxSolver.setMaxTime(maxTime);
+				if (seed >= 0)
+					MaxSolver.setSeed(seed);
+				MaxSolver.setReport(Console::Out);
+				MaxSolver.setProgress(&progress[0]);
+				telemetry = Telemetry::begin(Solver_selector::getSolverName(choice), &progress[0], (int)progress.size());
+				Solver_results.satisfied_clauses = MaxSolver.run_MaxSAT();
+				Solver_results.cost = MaxSolver.getBestCost();
+				if (Solver_results.satisfied_clauses == -1 || Solver_results.cost >= 0)
+					Solver_results.model = MaxSolver.getFormula().getOriginalMemberList();
+				complete = true;
+				break;
+			case 9:
+				CompSolver = Component_search(myprob);
+				if (maxTime > 0)
+					CompSolver.setMaxTime(maxTime);
+				Solver_results.satisfied_clauses = CompSolver.run_Components();
+				Console::WriteLine("Components solved: " + CompSolver.getNumComponents().ToString());
+				if (Solver_results.satisfied_clauses == -1)
+					Solver_results.model = CompSolver.getFormula().getOriginalMemberList();
 				complete = true;
 				break;
 			default:
@@ -243,10 +541,412 @@ Solve_results runSolver(SAT_puzzle myprob)
 				break;
 			}
 			timeKeep->Stop();
+			if (telemetry != nullptr)
+			{
+				telemetry->finish();
+			}
 			Solver_results.time_elapsed = timeKeep->ElapsedMilliseconds;
+			if (complete)
+			{
+				results.store(myprob, Solver_results.satisfied_clauses, Solver_results.model, Solver_selector::getSolverName(choice), maxTime);
+			}
 		}
 	}
 	
 	return Solver_results;
 }
 
+/// <summary>
+/// Prints a satisfying assignment as DIMACS "v" lines, terminated by 0.
+/// </summary>
+/// <param name="model">assignment to be printed, indexed from member 0.</param>
+void printModel(vector<bool> model)
+{
+	String ^ line = "v";
+	for (unsigned int i = 0; i < model.size(); i++)
+	{
+		int literal = model[i] ? (int)i + 1 : -((int)i + 1);
+		line += " " + literal.ToString();
+		//wrap long models so each line stays readable
+		if ((i + 1) % 20 == 0)
+		{
+			Console::WriteLine(line);
+			line = "v";
+		}
+	}
+	Console::WriteLine(line + " 0");
+}
+
+/// <summary>
+/// Repeats a yes/no question until the user enters y or n.
+/// </summary>
+/// <param name="question">prompt shown to the user.</param>
+/// <returns>true if the user answered yes.</returns>
+bool askYesNo(String^ question)
+{
+	String ^ response = " ";
+	while (response != "y" && response != "Y" && response != "n" && response != "N")
+	{
+		Console::WriteLine(question);
+		response = Console::ReadLine();
+		if (response != "y" && response != "Y" && response != "n" && response != "N")
+			Console::WriteLine(response + " is not a valid response.  Please enter y or n.");
+	}
+	return response == "y" || response == "Y";
+}
+
+/// <summary>
+/// Asks how a local search should build its starting assignment.
+/// </summary>
+/// <returns>the chosen strategy.</returns>
+Initial_assignment::Strategy askInitialization()
+{
+	Console::WriteLine("Select the starting assignment:");
+	Console::WriteLine("0: Random");
+	Console::WriteLine("1: Jeroslow-Wang polarity");
+	Console::WriteLine("2: Greedy with unit propagation");
+	Console::WriteLine("3: Random, biased towards Jeroslow-Wang polarity");
+	while (true)
+	{
+		String ^ response = Console::ReadLine();
+		int choice;
+		if (int::TryParse(response, choice) && choice >= 0 && choice <= 3)
+		{
+			return (Initial_assignment::Strategy)choice;
+		}
+		Console::WriteLine(response + " is not a valid selection.  Please enter 0, 1, 2 or 3.");
+	}
+}
+
+/// <summary>
+/// Handles the non-interactive modes selected by command line arguments.
+/// </summary>
+/// <param name="args">arguments following the program name.</param>
+/// <param name="masterSeed">seed making the search repeatable, or -1 to draw from the clock.</param>
+/// <returns>process exit code.</returns>
+int runCommandLine(array<String^>^ args, int masterSeed)
+{
+	//worker process started by cube-and-conquer: --cube-worker formula.cnf cubes.icnf
+	if (args[0] == "--cube-worker" && args->Length == 3)
+	{
+		return Cube_conquer::runWorker(args[1], args[2]);
+	}
+
+	//long-running job server: --server [pipe name]
+	if (args[0] == "--server" && args->Length <= 2)
+	{
+		Solver_server^ server = gcnew Solver_server(args->Length == 2 ? args[1] : "SATSolver");
+		return server->run();
+	}
+
+	//directory of formulas, parsed while earlier ones are searched: --batch dir solver budget [memory MB]
+	if (args[0] == "--batch" && (args->Length == 4 || args->Length == 5))
+	{
+		int budget, memory = Batch_runner::DEFAULT_MEMORY_MB;
+		if (!int::TryParse(args[3], budget) || (args->Length == 5 && !int::TryParse(args[4], memory)) || memory <= 0)
+		{
+			Console::WriteLine("The budget must be an integer and the memory a positive integer.");
+			return 1;
+		}
+		Batch_runner^ runner = gcnew Batch_runner(args[1], args[2], budget, (long long)memory << 20, masterSeed);
+		return runner->run();
+	}
+
+	//resumable batch run: --checkpoint state.ckpt walksat|genetic formula.cnf [budget ms]
+	if (args[0] == "--checkpoint" && (args->Length == 4 || args->Length == 5))
+	{
+		int budget = Int32::MaxValue;
+		if (args->Length == 5 && (!int::TryParse(args[4], budget) || budget <= 0))
+		{
+			Console::WriteLine("The budget must be a positive integer.");
+			return 1;
+		}
+		return runCheckpointed(args[2], args[3], args[1], budget, masterSeed);
+	}
+
+	//DPLL with a refutation proof: --prove formula.cnf proof.drat [lrat]
+	if (args[0] == "--prove" && (args->Length == 3 || (args->Length == 4 && args[3] == "lrat")))
+	{
+		return runProved(args[1], args[2], args->Length == 4);
+	}
+
+	//free-running against lockstep cooperative search, with a repeatability check: --bench [formulas] [runs]
+	if (args[0] == "--bench" && args->Length <= 3)
+	{
+		int formulas = 20, runs = 3;
+		if ((args->Length >= 2 && (!int::TryParse(args[1], formulas) || formulas <= 0))
+			|| (args->Length == 3 && (!int::TryParse(args[2], runs) || runs <= 0)))
+		{
+			Console::WriteLine("The number of formulas and of runs must be positive integers.");
+			return 1;
+		}
+		return runBench(formulas, runs, masterSeed);
+	}
+
+	Console::WriteLine("Usage:");
+	Console::WriteLine("  SATSolver                                   interactive mode");
+	Console::WriteLine("  SATSolver --telemetry <ms> <file|-> ...     before any mode: write search progress as JSON lines");
+	Console::WriteLine("                                              every <ms> to <file>, or to stderr for -");
+	Console::WriteLine("  SATSolver --seed <n> ...                    before any mode: seed the searches so runs repeat; the");
+	Console::WriteLine("                                              cooperative search then runs its workers in lockstep");
+	Console::WriteLine("  SATSolver --server [pipe name]              serve solve jobs over a named pipe (default SATSolver)");
+	Console::WriteLine("  SATSolver --batch <dir> <solver> <budget ms> [memory MB]");
+	Console::WriteLine("                                              solve every cnf/wcnf file of <dir> with paws, saps, maxsat,");
+	Console::WriteLine("                                              dpll or exhaustive, parsing ahead within the memory budget");
+	Console::WriteLine("  SATSolver --checkpoint <file> walksat|genetic <cnf> [budget ms]");
+	Console::WriteLine("                                              run with periodic checkpoints, resuming from <file> if present;");
+	Console::WriteLine("                                              walksat runs until solved or the budget, over all resumes, is spent");
+	Console::WriteLine("  SATSolver --prove <cnf> <proof> [lrat]      run DPLL without a time limit, writing a binary DRAT (or LRAT)");
+	Console::WriteLine("                                              proof of unsatisfiability for DRATCheck");
+	Console::WriteLine("  SATSolver --bench [formulas] [runs]         time the cooperative search free running and in lockstep on a");
+	Console::WriteLine("                                              fixed set of random 3-SAT formulas (default 20, 3 runs each),");
+	Console::WriteLine("                                              checking that seeded runs find the same assignment");
+	Console::WriteLine("  SATSolver --cube-worker <cnf> <cubes>       cube-and-conquer worker (started internally)");
+	return 1;
+}
+
+/// <summary>
+/// Runs WalkSAT or the genetic algorithm with checkpointing, resuming from an earlier checkpoint.
+/// Running the same command again after the process is stopped continues the interrupted search.
+/// </summary>
+/// <param name="solver">walksat or genetic</param>
+/// <param name="filename">cnf file to be solved</param>
+/// <param name="checkpoint">checkpoint file</param>
+/// <param name="budget">WalkSAT time budget in milliseconds, summed over resumes; the genetic algorithm runs its generations</param>
+/// <param name="masterSeed">seed of a fresh run, or -1 to draw from the clock; a resumed run keeps its own state</param>
+/// <returns>process exit code.</returns>
+int runCheckpointed(String^ solver, String^ filename, String^ checkpoint, int budget, int masterSeed)
+{
+	SAT_puzzle myprob;
+	try
+	{
+		myprob = SAT_puzzle(filename);
+	}
+	catch (Exception^ thrown_error)
+	{
+		Console::WriteLine("File " + filename + " could not be read: " + thrown_error->Message);
+		return 1;
+	}
+	catch (String^ thrown_error)
+	{
+		return 1;
+	}
+
+	int result;
+	vector<bool> model;
+	Search_progress progress;
+	Telemetry^ telemetry = nullptr;
+	if (solver == "walksat")
+	{
+		WalkSAT WalkSolver(myprob);
+		WalkSolver.setCheckpoint(checkpoint);
+		WalkSolver.setMaxTime(budget);
+		WalkSolver.setSeed(masterSeed);
+		WalkSolver.setProgress(&progress);
+		telemetry = Telemetry::begin(solver, &progress, 1);
+		result = WalkSolver.run_WalkSAT();
+		model = WalkSolver.getFormula().getOriginalMemberList();
+		Console::WriteLine("final noise: " + WalkSolver.getNoise().ToString("F3"));
+	}
+	else if (solver == "genetic")
+	{
+		Genetic GeneSolver;
+		GeneSolver.setCheckpoint(checkpoint);
+		GeneSolver.setSeed(masterSeed);
+		GeneSolver.setProgress(&progress);
+		telemetry = Telemetry::begin(solver, &progress, 1);
+		result = GeneSolver.runGenetic(myprob);
+		if (result == -1)
+			model = GeneSolver.getSolution().getOriginalMemberList();
+	}
+	else
+	{
+		Console::WriteLine("Checkpointing is available for walksat and genetic.");
+		return 1;
+	}
+	if (telemetry != nullptr)
+	{
+		telemetry->finish();
+	}
+
+	if (result == -1)
+	{
+		Console::WriteLine("SATISFIABLE");
+		printModel(model);
+	}
+	else
+	{
+		Console::WriteLine("UNKNOWN");
+		Console::WriteLine("clauses satisfied: " + result.ToString());
+	}
+	return 0;
+}
+
+/// <summary>
+/// Runs DPLL to completion while writing a proof of unsatisfiability.
+/// The proof file is kept only when the formula is refuted.
+/// </summary>
+/// <param name="filename">cnf file to be solved</param>
+/// <param name="proofname">proof file to be written</param>
+/// <param name="lrat">true for binary LRAT, false for binary DRAT</param>
+/// <returns>process exit code: 10 satisfiable, 20 unsatisfiable, 0 unknown, 1 on error.</returns>
+int runProved(String^ filename, String^ proofname, bool lrat)
+{
+	SAT_puzzle myprob;
+	try
+	{
+		myprob = SAT_puzzle(filename);
+	}
+	catch (Exception^ thrown_error)
+	{
+		Console::WriteLine("File " + filename + " could not be read: " + thrown_error->Message);
+		return 1;
+	}
+	catch (String^ thrown_error)
+	{
+		return 1;
+	}
+
+	//the formula is not reordered, so the lemmas are numbered as in the file
+	Proof_writer^ proof = gcnew Proof_writer(proofname, lrat);
+	int result;
+	vector<bool> model;
+	Search_progress progress;
+	Telemetry^ telemetry = nullptr;
+	try
+	{
+		DPLL DPLLSolver(myprob, proof);
+		DPLLSolver.setMaxTime(Int32::MaxValue);
+		DPLLSolver.setProgress(&progress);
+		telemetry = Telemetry::begin("dpll", &progress, 1);
+		result = DPLLSolver.run_DPLL();
+		if (result == -1)
+			model = DPLLSolver.getFormula().getOriginalMemberList();
+	}
+	finally
+	{
+		if (telemetry != nullptr)
+		{
+			telemetry->finish();
+		}
+		proof->close();
+	}
+
+	if (result == DPLL::UNSATISFIABLE)
+	{
+		Console::WriteLine("s UNSATISFIABLE");
+		return 20;
+	}
+	File::Delete(proofname);
+	if (result == -1)
+	{
+		Console::WriteLine("s SATISFIABLE");
+		printModel(model);
+		return 10;
+	}
+	Console::WriteLine("s UNKNOWN");
+	return 0;
+}
+
+/// <summary>
+/// Times the cooperative search running freely against the same search seeded, which runs its
+/// workers in lockstep, and checks that every seeded run of a formula ends on the same assignment.
+/// The formulas come from benchFormula, so every machine measures the same set.
+/// </summary>
+/// <param name="formulas">number of formulas to run</param>
+/// <param name="runs">runs of each search per formula</param>
+/// <param name="masterSeed">seed of the lockstep runs, or -1 for seed 1</param>
+/// <returns>process exit code: 0 if the seeded runs repeated, 2 if any differed.</returns>
+int runBench(int formulas, int runs, int masterSeed)
+{
+	int seed = (masterSeed < 0) ? 1 : masterSeed;
+	Console::WriteLine("Cooperative search on " + Environment::ProcessorCount.ToString() + " processors, "
+		+ runs.ToString() + " runs per formula, lockstep seed " + seed.ToString());
+	Console::WriteLine("formula members   free ms  lockstep ms  repeated");
+	long long freeTotal = 0, lockstepTotal = 0;
+	int differing = 0, unsolved = 0;
+	for (int f = 0; f < formulas; f++)
+	{
+		SAT_puzzle formula(gcnew StringReader(benchFormula(f)));
+		long long freeTime = 0, lockstepTime = 0;
+		vector<bool> firstModel;
+		//only solved runs can be compared, as a run cut off by the clock stops at any round
+		String^ repeated = "yes";
+		for (int r = 0; r < runs; r++)
+		{
+			Stopwatch^ clock = Stopwatch::StartNew();
+			Cooperative_search freeSearch(formula);
+			if (freeSearch.run_Cooperative() != -1)
+				unsolved++;
+			freeTime += clock->ElapsedMilliseconds;
+
+			clock->Restart();
+			Cooperative_search lockstepSearch(formula);
+			lockstepSearch.setSeed(seed);
+			int result = lockstepSearch.run_Cooperative();
+			lockstepTime += clock->ElapsedMilliseconds;
+			if (result != -1)
+			{
+				unsolved++;
+				if (repeated == "yes")
+					repeated = "timed out";
+			}
+			else if (r == 0)
+			{
+				firstModel = lockstepSearch.getFormula().getOriginalMemberList();
+			}
+			else if (lockstepSearch.getFormula().getOriginalMemberList() != firstModel && repeated == "yes")
+			{
+				repeated = "NO";
+				differing++;
+			}
+		}
+		freeTotal += freeTime;
+		lockstepTotal += lockstepTime;
+		Console::WriteLine(f.ToString()->PadLeft(7) + formula.getNumMembers().ToString()->PadLeft(8)
+			+ (freeTime / runs).ToString()->PadLeft(10) + (lockstepTime / runs).ToString()->PadLeft(13) + "  " + repeated);
+	}
+
+	Console::WriteLine("Mean per run: free " + (freeTotal / ((long long)formulas * runs)).ToString() + " ms, lockstep "
+		+ (lockstepTotal / ((long long)formulas * runs)).ToString() + " ms; " + unsolved.ToString() + " runs timed out");
+	if (differing > 0)
+	{
+		Console::WriteLine(differing.ToString() + " formulas gave different assignments for the same seed.");
+		return 2;
+	}
+	Console::WriteLine("Every solved seeded run repeated its assignment.");
+	return 0;
+}
+
+/// <summary>
+/// Builds one formula of the benchmark set: uniform random 3-SAT at a clause/member ratio of
+/// 4.0, below the threshold so nearly all are satisfiable, from a generator seeded by index.
+/// </summary>
+/// <param name="index">number of the formula in the set</param>
+/// <returns>the formula in cnf format</returns>
+String^ benchFormula(int index)
+{
+	Random^ rand = gcnew Random(index);
+	int numMembers = 200 + 50 * (index % 5);
+	int numClauses = 4 * numMembers;
+	Text::StringBuilder^ text = gcnew Text::StringBuilder("p cnf " + numMembers.ToString() + " " + numClauses.ToString() + "\n");
+	for (int c = 0; c < numClauses; c++)
+	{
+		int members[3];
+		for (int k = 0; k < 3; k++)
+		{
+			bool distinct;
+			do
+			{
+				members[k] = rand->Next(numMembers) + 1;
+				distinct = true;
+				for (int j = 0; j < k; j++)
+					distinct = distinct && members[j] != members[k];
+			} while (!distinct);
+			text->Append(rand->Next(2) == 0 ? members[k] : -members[k]);
+			text->Append(' ');
+		}
+		text->Append("0\n");
+	}
+	return text->ToString();
+}
@@ -0,0 +1,111 @@
+#include "stdafx.h"
+#include "Incremental_solver.h"
+#include "SATSolver_api.h"
+
+/***************************************************
+* C interface START
+***************************************************/
+
+/// <summary>
+/// Creates a solver holding an empty formula.
+/// </summary>
+/// <returns>handle passed to the other functions</returns>
+void *satsolver_init()
+{
+	return new Incremental_solver();
+}
+
+/// <summary>
+/// Releases a solver and everything it holds.
+/// </summary>
+void satsolver_release(void *solver)
+{
+	delete static_cast<Incremental_solver *>(solver);
+}
+
+/// <summary>
+/// Adds a literal to the clause being built, or ends the clause when literal is 0.
+/// </summary>
+void satsolver_add(void *solver, int literal)
+{
+	static_cast<Incremental_solver *>(solver)->add(literal);
+}
+
+/// <summary>
+/// Fixes a literal to true for the next call to satsolver_solve only.
+/// </summary>
+void satsolver_assume(void *solver, int literal)
+{
+	static_cast<Incremental_solver *>(solver)->assume(literal);
+}
+
+/// <summary>
+/// Solves the formula under the current assumptions.
+/// </summary>
+/// <returns>10 if satisfiable, 20 if unsatisfiable, 0 if the time limit was reached</returns>
+int satsolver_solve(void *solver)
+{
+	int result = static_cast<Incremental_solver *>(solver)->solve();
+	if (result == -1)
+	{
+		return 10;
+	}
+	else if (result == DPLL::UNSATISFIABLE)
+	{
+		return 20;
+	}
+	else { return 0; }
+}
+
+/// <summary>
+/// Gets the value of a literal in the model found by the last satisfiable solve.
+/// </summary>
+/// <returns>literal if it is true in the model, -literal if it is false</returns>
+int satsolver_val(void *solver, int literal)
+{
+	return static_cast<Incremental_solver *>(solver)->value(literal) ? literal : -literal;
+}
+
+/// <summary>
+/// Sets the time limit for each subsequent solve.
+/// </summary>
+void satsolver_set_time_limit(void *solver, int milliseconds)
+{
+	static_cast<Incremental_solver *>(solver)->setMaxTime(milliseconds);
+}
+
+/// <summary>
+/// Counts the clauses each of a batch of assignments satisfies, without solving.
+/// </summary>
+void satsolver_eval_batch(void *solver, const unsigned long long *assignments, int count, int *satisfied)
+{
+	static_cast<Incremental_solver *>(solver)->getEvaluator().evaluate(assignments, count, satisfied, nullptr);
+}
+
+/// <summary>
+/// Lists the clauses a packed assignment falsifies, numbered from 0 in the order they were added.
+/// </summary>
+/// <returns>the number of falsified clauses; only the first capacity are written to clauses</returns>
+int satsolver_eval_falsified(void *solver, const unsigned long long *assignment, int *clauses, int capacity)
+{
+	int satisfied;
+	vector<vector<int>> falsified;
+	static_cast<Incremental_solver *>(solver)->getEvaluator().evaluate(assignment, 1, &satisfied, &falsified);
+	for (int i = 0; i < capacity && i < (int)falsified[0].size(); i++)
+	{
+		clauses[i] = falsified[0][i];
+	}
+	return (int)falsified[0].size();
+}
+
+/// <summary>
+/// Gets the number of 64-bit words a packed assignment takes for the formula added so far.
+/// </summary>
+int satsolver_eval_words(void *solver)
+{
+	return static_cast<Incremental_solver *>(solver)->getEvaluator().getWordsPerAssignment();
+}
+
+/***************************************************
+* C interface END
+***************************************************/
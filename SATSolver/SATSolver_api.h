@@ -0,0 +1,79 @@
+#pragma once
+
+//the SATSolverDll project defines SATSOLVER_EXPORTS; programs embedding the DLL import the functions
+#ifdef SATSOLVER_EXPORTS
+#define SATSOLVER_API __declspec(dllexport)
+#else
+#define SATSOLVER_API __declspec(dllimport)
+#endif
+
+/// <summary>
+/// C interface to the incremental solver, following the conventions of the IPASIR interface:
+/// clauses are added a literal at a time and ended with 0, assumptions hold for the next solve
+/// only, and solve returns 10 for satisfiable, 20 for unsatisfiable and 0 when time runs out.
+/// A handle is not safe to use from several threads at once.
+/// </summary>
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/// <summary>
+	/// Creates a solver holding an empty formula.
+	/// </summary>
+	/// <returns>handle passed to the other functions</returns>
+	SATSOLVER_API void *satsolver_init();
+
+	/// <summary>
+	/// Releases a solver and everything it holds.
+	/// </summary>
+	SATSOLVER_API void satsolver_release(void *solver);
+
+	/// <summary>
+	/// Adds a literal to the clause being built, or ends the clause when literal is 0.
+	/// </summary>
+	SATSOLVER_API void satsolver_add(void *solver, int literal);
+
+	/// <summary>
+	/// Fixes a literal to true for the next call to satsolver_solve only.
+	/// </summary>
+	SATSOLVER_API void satsolver_assume(void *solver, int literal);
+
+	/// <summary>
+	/// Solves the formula under the current assumptions.
+	/// </summary>
+	/// <returns>10 if satisfiable, 20 if unsatisfiable, 0 if the time limit was reached</returns>
+	SATSOLVER_API int satsolver_solve(void *solver);
+
+	/// <summary>
+	/// Gets the value of a literal in the model found by the last satisfiable solve.
+	/// </summary>
+	/// <returns>literal if it is true in the model, -literal if it is false</returns>
+	SATSOLVER_API int satsolver_val(void *solver, int literal);
+
+	/// <summary>
+	/// Sets the time limit for each subsequent solve.
+	/// </summary>
+	SATSOLVER_API void satsolver_set_time_limit(void *solver, int milliseconds);
+
+	/// <summary>
+	/// Counts the clauses each of a batch of assignments satisfies, without solving.  Each
+	/// assignment is packed into satsolver_eval_words() 64-bit words, bit i of word k holding
+	/// variable 64 * k + i + 1.  Large batches are scored on several threads.
+	/// </summary>
+	SATSOLVER_API void satsolver_eval_batch(void *solver, const unsigned long long *assignments, int count, int *satisfied);
+
+	/// <summary>
+	/// Lists the clauses a packed assignment falsifies, numbered from 0 in the order they were added.
+	/// </summary>
+	/// <returns>the number of falsified clauses; only the first capacity are written to clauses</returns>
+	SATSOLVER_API int satsolver_eval_falsified(void *solver, const unsigned long long *assignment, int *clauses, int capacity);
+
+	/// <summary>
+	/// Gets the number of 64-bit words a packed assignment takes for the formula added so far.
+	/// </summary>
+	SATSOLVER_API int satsolver_eval_words(void *solver);
+
+#ifdef __cplusplus
+}
+#endif
@@ -14,7 +14,10 @@
 */
 
 #include "stdafx.h"
+#include <algorithm>
 #include "SAT_puzzle.h"
+#include "Parallel_eval.h"
+using namespace System::Security::Cryptography;
 
 
 /***************************************************
@@ -22,10 +25,14 @@
 ***************************************************/
 
 /// <summary>
-/// Default constructor; currently does nothing.
+/// Default constructor; creates an empty formula.
 /// </summary>
 SAT_puzzle::SAT_puzzle()
 {
+	unsatisfied_count = 0;
+	num_members = 0;
+	num_clauses = 0;
+	hard_weight = 0;
 }
 
 /// <summary>
@@ -56,160 +63,112 @@ SAT_puzzle::SAT_puzzle(String^ filename)
 	
 	if (Not_opened == false)
 	{
-		String^ line_in = in_file->ReadLine();
-		int number_line = 0;
-		bool descriptorLine_found = false;
-
-		//loop processes each line from the file and converts it into data useable by the puzzle
-		while (line_in != nullptr)
+		//the reader is closed even when parsing fails, so a long-running process does not leak handles
+		try
 		{
-			//records how many lines of numbers have been reached
-			array<String^>^ token = line_in->Split(' ');
-			
-			//Seeks the indicator for the line that describes how many members and clauses there are to
-			// satisfy in the SAT problem.
-			//The expected files represent cnf formulas in a specific format used in the 2002 SAT Competition.
-			//Information on this format can be found at: http://www.satcompetition.org/2004/format-solvers2004.html
-			//All other formula-related lines should have no indicator in front of them, while comment lines should
-			// be denoted by a lower case 'c'.
-			//In this version, a flag has been added to determine if the descriptor line has been found and parsed yet.
-			// This is to prevent error lines or non-cnf files from causing problems for the program.
-			if (token[0]->Equals("p"))
-			{
-				//Attempts to parse the descriptor line for the forumula, extracting the number of members and clauses
-				try
-				{
-					num_members = int::Parse(token[2]);
-				}
-				catch (Exception^ parse_error)
-				{
-					Console::Write("Parsing error with: ");
-					Console::WriteLine(token[2]);
-					throw parse_error;
-				}
-				try
-				{
-					num_clauses = int::Parse(token[3]);
-				}
-				catch (Exception^ parse_error)
-				{
-					Console::Write("Parsing error with: ");
-					Console::WriteLine(token[3]);
-					throw parse_error;
-				}
-
-				//If the numbewr of members and clauses are successfully extracted, problem's member vectors are
-				// re-sized to accommodate a sufficient number of variables.
-				member_list.resize(num_members);
-				clause_list.resize(num_clauses);
-				puzzle_ints.resize(num_clauses);
-				for (int i = 0; i < num_clauses; i++)
-				{
-					puzzle_ints[i].resize(num_members + 1);
-				}
-
-				//The flag indicating the descriptor line was found and parsed is set to true, allowing subsequent
-				// lines to be processed
-				descriptorLine_found = true;
-			}
-			// else if is used here to avoid testing more if statements than necessary
-			//There is no else following this, because lines that do not meet either the above or below
-			// if statements should not be processed.
-			/// <note> Consider adding some sort of error functionality to specifically warn of garbage lines: TJS 1/22/2015
-			else if (!token[0]->Equals("c") && descriptorLine_found)
-			{
-				int offset = 0;
-				for (int i = 0; i < (token->Length - offset); i++)
-				{
-					//Attempts to parse a line into a series of integers which are used to indicate which
-					// of the members needs to either be true (positive) or false (negative).
-					try
-					{
-						int z = number_line;
-						while (token[i + offset]->Equals(""))
-						{
-							offset++;
-						}
-						puzzle_ints[number_line][i] = int::Parse(token[i + offset]);
-					}
-					catch (IndexOutOfRangeException^ index_error)
-					{
-						Console::WriteLine(token[i] + " " + i.ToString());
-						Console::WriteLine("Index OB.");
-						throw index_error;
-					}
-					catch (Exception^ parse_error)
-					{
-						Console::Write("Parsing error with: ");
-						Console::WriteLine(token[i]);
-						throw parse_error;
-					}
-				}
-				number_line++;
-			}
-
-			line_in = in_file->ReadLine();
+			parse(in_file);
 		}
-
-		//To create a base-state a solution is sought from, all member and clause values are set to false
-		for (int i = 0; i < num_members; i++)
+		finally
 		{
-			member_list[i] = false;
+			in_file->Close();
 		}
-		for (int i = 0; i< num_clauses; i++)
-		{
-			clause_list[i] = false;
-		}
-		
 	}
 }
 
+/// <summary>
+/// Constructor based upon text already open for reading, such as a formula held in memory.
+/// </summary>
+/// <param name="source">reader positioned at the start of a cnf or wcnf formula.
+/// </param>
+SAT_puzzle::SAT_puzzle(TextReader^ source)
+{
+	unsatisfied_count = 0;
+	num_members = 0;
+	num_clauses = 0;
+	hard_weight = 0;
+	parse(source);
+}
+
 /// <summary>
 /// Constructor, based upon a previously existing SAT_puzzle object.
 /// </summary>
 /// <param name="base_puzzle"> SAT_puzzle object to be copied.
 /// </param>
-SAT_puzzle::SAT_puzzle(SAT_puzzle &base_puzzle)
+SAT_puzzle::SAT_puzzle(const SAT_puzzle &base_puzzle)
 {
-	base_puzzle.getNumMembers();
-	num_members = base_puzzle.getNumMembers();
-	num_clauses = base_puzzle.getNumClauses();
+	*this = base_puzzle;
+}
 
-	//copy member_list from the previous object
-	vector<bool> member_list_temp = base_puzzle.getMemberList();
-	member_list.resize(num_members);
-	for (int i = 0; i < num_members; i++)
-	{
-		bool temp = member_list_temp[i];
-		member_list[i] = temp;
-	}
+/// <summary>
+/// Constructor that takes over the storage of a SAT_puzzle object about to be discarded.
+/// </summary>
+/// <param name="base_puzzle">SAT_puzzle object to be moved from; it is left empty.</param>
+SAT_puzzle::SAT_puzzle(SAT_puzzle &&base_puzzle)
+{
+	*this = std::move(base_puzzle);
+}
 
-	//copy clause_list from the previous object
-	vector<bool> clause_list_temp = base_puzzle.getClauseList();
-	clause_list.resize(num_clauses);
-	for (int i = 0; i < num_clauses; i++)
+/// <summary>
+/// Copies another SAT_puzzle object into this one, reusing this object's storage where it can.
+/// </summary>
+/// <param name="base_puzzle">SAT_puzzle object to be copied.</param>
+SAT_puzzle& SAT_puzzle::operator=(const SAT_puzzle &base_puzzle)
+{
+	if (this == &base_puzzle)
 	{
-		bool temp = clause_list_temp[i];
-		clause_list[i] = temp;
+		return *this;
 	}
+	num_members = base_puzzle.num_members;
+	num_clauses = base_puzzle.num_clauses;
+	puzzle_ints = base_puzzle.puzzle_ints;
+	original_index = base_puzzle.original_index;
+	occurrences = base_puzzle.occurrences;
+	clause_weights = base_puzzle.clause_weights;
+	hard_weight = base_puzzle.hard_weight;
+	canonical_hash = base_puzzle.canonical_hash;
+
+	//the counts are consistent with the copied clause_list, so nothing needs evaluating
+	cloneAssignment(base_puzzle);
+	return *this;
+}
 
-	//copy puzzle_ints from the previous object
-	vector<vector<int>> puzzle_ints_temp = base_puzzle.getPuzzleInts();
-	puzzle_ints.resize(num_clauses);
-	for (int i = 0; i < num_clauses; i++)
-	{
-		puzzle_ints[i].resize(num_members);
-	}
-	for (int i = 0; i < num_clauses; i++)
+/// <summary>
+/// Takes over the storage of a SAT_puzzle object about to be discarded.
+/// </summary>
+/// <param name="base_puzzle">SAT_puzzle object to be moved from; it is left empty.</param>
+SAT_puzzle& SAT_puzzle::operator=(SAT_puzzle &&base_puzzle)
+{
+	if (this == &base_puzzle)
 	{
-		for (int j = 0; j < num_members; j++)
-		{
-			int temp = puzzle_ints_temp[i][j];
-			puzzle_ints[i][j] = temp;
-		}
+		return *this;
 	}
-
-	int k = check_trues();
+	num_members = base_puzzle.num_members;
+	num_clauses = base_puzzle.num_clauses;
+	unsatisfied_count = base_puzzle.unsatisfied_count;
+	hard_weight = base_puzzle.hard_weight;
+	member_list = std::move(base_puzzle.member_list);
+	clause_list = std::move(base_puzzle.clause_list);
+	puzzle_ints = std::move(base_puzzle.puzzle_ints);
+	original_index = std::move(base_puzzle.original_index);
+	occurrences = std::move(base_puzzle.occurrences);
+	clause_weights = std::move(base_puzzle.clause_weights);
+	true_literals = std::move(base_puzzle.true_literals);
+	canonical_hash = std::move(base_puzzle.canonical_hash);
+
+	//leave the source a consistent empty formula
+	base_puzzle.member_list.clear();
+	base_puzzle.clause_list.clear();
+	base_puzzle.puzzle_ints.clear();
+	base_puzzle.original_index.clear();
+	base_puzzle.occurrences.clear();
+	base_puzzle.clause_weights.clear();
+	base_puzzle.true_literals.clear();
+	base_puzzle.canonical_hash.clear();
+	base_puzzle.num_members = 0;
+	base_puzzle.num_clauses = 0;
+	base_puzzle.unsatisfied_count = 0;
+	base_puzzle.hard_weight = 0;
+	return *this;
 }
 
 /// <summary>
@@ -229,97 +188,199 @@ SAT_puzzle::~SAT_puzzle()
 
 /// <summary>
 /// checks to see how many of the puzzle's clauses are satisfied as true.
+/// The count is kept up to date by the mutators, so this does not walk the clauses.
 /// </summary>
 /// <returns>the number of satisfied clauses</returns>
-int SAT_puzzle::check_trues()
+int SAT_puzzle::check_trues() const
 {
-	true_clause_count = 0;
-	for (int i = 0; i < num_clauses; i++)
-	{
-		clause_list[i] = false;
-	}
+	return num_clauses - unsatisfied_count;
+}
+
+/// <summary>
+/// Evaluates the clauses in the range [first, last) from scratch, updating clause_list and the
+/// count of true literals for each of them.
+/// </summary>
+/// <param name="first">index of the first clause to evaluate</param>
+/// <param name="last">index one past the last clause to evaluate</param>
+/// <returns>the number of satisfied clauses within the range</returns>
+int SAT_puzzle::check_trues_range(int first, int last)
+{
+	int count = 0;
 	//Iterates through each clause to check the values of the clauses' members
-	for (int i = 0; i < num_clauses; i++)
+	for (int i = first; i < last; i++)
 	{
-		//Iterates through the members of a clause, checking to see if any of the members satisfy the
+		int trues = 0;
+		//Iterates through the members of a clause, counting the members that satisfy the
 		// requirements to make the clause true.
-		for (int j = 0; j < num_members; j++)
+		for (unsigned int j = 0; j < puzzle_ints[i].size(); j++)
 		{
+			int index = puzzle_ints[i][j];
 			//Zero indicates the termination of a clause
-			if (puzzle_ints[i][j] != 0)
+			if (index == 0)
+			{
+				break;
+			}
+			bool literal_value = (index > 0) ? member_list[index - 1] : !member_list[(-index) - 1];
+			if (literal_value)
 			{
-				int index = puzzle_ints[i][j];
-				if (index > 0)
+				//a repeated literal is counted once, as it is listed once in the occurrence lists
+				bool repeated = false;
+				for (unsigned int k = 0; k < j && !repeated; k++)
 				{
-					clause_list[i] = clause_list[i] | member_list[index - 1];
+					repeated = puzzle_ints[i][k] == index;
 				}
-				else
+				if (!repeated)
 				{
-					clause_list[i] = clause_list[i] | !member_list[(-index) - 1];
+					trues++;
 				}
 			}
-			else
-			{
-				j = num_members;
-			}
 		}
-		if (clause_list[i])
+		true_literals[i] = trues;
+		clause_list[i] = trues > 0;
+		if (trues > 0)
 		{
-			true_clause_count++;
+			count++;
 		}
 	}
-	return true_clause_count;
+	return count;
 }
 
 /// <summary>
 /// Determines whether or not the formula is satisfied and returns true or false accordingly.
 /// </summary>
 /// <returns>true if the formula is satisfied or false if it is not.</returns>
-bool SAT_puzzle::satisfied()
+bool SAT_puzzle::satisfied() const
 {
-	bool isSatisfied = true;
+	return unsatisfied_count == 0;
+}
+
+/// <summary>
+/// Gets the number of clauses the current assignment leaves unsatisfied.
+/// </summary>
+/// <returns></returns>
+int SAT_puzzle::getUnsatisfiedCount() const
+{
+	return unsatisfied_count;
+}
+
+/// <summary>
+/// Writes the formula to a file in the DIMACS cnf format it is read from.
+/// </summary>
+/// <param name="filename">Filename to be written.</param>
+void SAT_puzzle::writeToFile(String^ filename)
+{
+	StreamWriter^ out_file = gcnew StreamWriter(filename);
+	if (clause_weights.empty())
+	{
+		out_file->WriteLine("p cnf " + num_members.ToString() + " " + num_clauses.ToString());
+	}
+	else
+	{
+		out_file->WriteLine("p wcnf " + num_members.ToString() + " " + num_clauses.ToString() + " " + hard_weight.ToString());
+	}
 	for (int i = 0; i < num_clauses; i++)
 	{
-		isSatisfied = isSatisfied & clause_list[i];
+		if (!clause_weights.empty())
+		{
+			out_file->Write(clause_weights[i].ToString() + " ");
+		}
+		for (unsigned int j = 0; j < puzzle_ints[i].size() && puzzle_ints[i][j] != 0; j++)
+		{
+			out_file->Write(puzzle_ints[i][j].ToString() + " ");
+		}
+		out_file->WriteLine("0");
 	}
-	return isSatisfied;
+	out_file->Close();
 }
 
 ////////////////////////////////////////////////////////////
 //Accessors
 
 /// <summary>
-/// Gets the list of bool variables used in the formula.
+/// Gets the list of bool variables used in the formula, without copying it.
+/// The reference follows later changes to the assignment.
 /// </summary>
 /// <returns></returns>
-vector<bool> SAT_puzzle::getMemberList()
+const vector<bool>& SAT_puzzle::getMemberList() const
 {
 	return member_list;
 }
 
 /// <summary>
-/// Gets the list of clauses used in the formula.
+/// Gets the list of clauses used in the formula, without copying it.
 /// </summary>
 /// <returns></returns>
-vector<bool> SAT_puzzle::getClauseList()
+const vector<bool>& SAT_puzzle::getClauseList() const
 {
 	return clause_list;
 }
 
 /// <summary>
-/// Gets the array of integers representing member indices within each clause
+/// Gets the array of integers representing member indices within each clause, without copying it.
 /// </summary>
 /// <returns></returns>
-vector<vector<int>> SAT_puzzle::getPuzzleInts()
+const vector<vector<int>>& SAT_puzzle::getPuzzleInts() const
 {
 	return puzzle_ints;
 }
 
+/// <summary>
+/// Gets the literals of one clause, terminated by 0, without copying them.
+/// </summary>
+/// <param name="clause">index of the clause</param>
+/// <returns></returns>
+const vector<int>& SAT_puzzle::getClause(int clause) const
+{
+	return puzzle_ints[clause];
+}
+
+/// <summary>
+/// Gets the literals of one clause with repeats removed, as local searches count them.
+/// </summary>
+/// <param name="clause">index of the clause</param>
+/// <param name="literals">receives the literals, without the terminating 0; left empty for a tautology</param>
+/// <returns>false if the clause holds both literals of a member, so no assignment falsifies it</returns>
+bool SAT_puzzle::getDistinctLiterals(int clause, vector<int> &literals) const
+{
+	literals.clear();
+	const vector<int> &row = puzzle_ints[clause];
+	for (unsigned int j = 0; j < row.size() && row[j] != 0; j++)
+	{
+		int literal = row[j];
+		bool repeated = false;
+		for (unsigned int k = 0; k < literals.size() && !repeated; k++)
+		{
+			if (literals[k] == -literal)
+			{
+				literals.clear();
+				return false;
+			}
+			repeated = literals[k] == literal;
+		}
+		if (!repeated)
+		{
+			literals.push_back(literal);
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// Gets the number of distinct literals of a clause that the current assignment makes true.
+/// Tautologies keep the count they were last evaluated with, which is never 0.
+/// </summary>
+/// <param name="clause">index of the clause</param>
+/// <returns></returns>
+int SAT_puzzle::getTrueCount(int clause) const
+{
+	return true_literals[clause];
+}
+
 /// <summary>
 /// Get the number of member variables in the formula.
 /// </summary>
 /// <returns></returns>
-int SAT_puzzle::getNumMembers()
+int SAT_puzzle::getNumMembers() const
 {
 	return num_members;
 }
@@ -328,11 +389,108 @@ int SAT_puzzle::getNumMembers()
 /// Get the number of clauses in the formula.
 /// </summary>
 /// <returns></returns>
-int SAT_puzzle::getNumClauses()
+int SAT_puzzle::getNumClauses() const
 {
 	return num_clauses;
 }
 
+/// <summary>
+/// Gets the assignment in the variable numbering of the original file, undoing any
+/// renumbering applied by applyOrdering().
+/// </summary>
+/// <returns></returns>
+vector<bool> SAT_puzzle::getOriginalMemberList() const
+{
+	if (original_index.empty())
+	{
+		return member_list;
+	}
+	vector<bool> original_members(num_members);
+	for (int i = 0; i < num_members; i++)
+	{
+		original_members[original_index[i]] = member_list[i];
+	}
+	return original_members;
+}
+
+/// <summary>
+/// Gets the original file index of each member, or an empty list if the formula has not been renumbered.
+/// </summary>
+/// <returns></returns>
+const vector<int>& SAT_puzzle::getOriginalIndices() const
+{
+	return original_index;
+}
+
+/// <summary>
+/// Gets the indices of the clauses that contain the given literal, in ascending order.
+/// Tautologies are left out, as no flip can change whether they are satisfied.
+/// </summary>
+/// <param name="literal">a member number as used in the file: positive for the member, negative for its negation</param>
+/// <returns></returns>
+const vector<int>& SAT_puzzle::getOccurrences(int literal) const
+{
+	return occurrences[occurrenceSlot(literal)];
+}
+
+/// <summary>
+/// Determines whether the formula was read from a weighted (wcnf) file.
+/// </summary>
+/// <returns>true if clauses carry weights</returns>
+bool SAT_puzzle::isWeighted() const
+{
+	return !clause_weights.empty();
+}
+
+/// <summary>
+/// Gets the weight of a clause; every clause of an unweighted formula weighs 1.
+/// </summary>
+/// <param name="clause">index of the clause</param>
+/// <returns></returns>
+long long SAT_puzzle::getClauseWeight(int clause) const
+{
+	return clause_weights.empty() ? 1 : clause_weights[clause];
+}
+
+/// <summary>
+/// Determines whether a clause is hard, i.e. must be satisfied by any acceptable assignment.
+/// Clauses of an unweighted formula are all treated as soft.
+/// </summary>
+/// <param name="clause">index of the clause</param>
+/// <returns></returns>
+bool SAT_puzzle::isHardClause(int clause) const
+{
+	return !clause_weights.empty() && clause_weights[clause] >= hard_weight;
+}
+
+/// <summary>
+/// Gets the weight of every clause, or an empty list for an unweighted formula.
+/// </summary>
+/// <returns></returns>
+const vector<long long>& SAT_puzzle::getClauseWeights() const
+{
+	return clause_weights;
+}
+
+/// <summary>
+/// Gets the weight at and above which clauses are hard.
+/// </summary>
+/// <returns></returns>
+long long SAT_puzzle::getHardWeight() const
+{
+	return hard_weight;
+}
+
+/// <summary>
+/// Gets a hash of the clause set as parsed, with the literals of each clause sorted, clauses
+/// sorted and repeats of either removed, so reordered copies of a formula hash alike.
+/// </summary>
+/// <returns>hex SHA-256, or nullptr for weighted formulas and formulas extended by addClause</returns>
+String^ SAT_puzzle::getCanonicalHash() const
+{
+	return canonical_hash.empty() ? nullptr : gcnew String(canonical_hash.c_str());
+}
+
 ////////////////////////////////////////////////////////////
 //Mutators
 
@@ -343,7 +501,11 @@ int SAT_puzzle::getNumClauses()
 /// </param>
 void SAT_puzzle::setTrueAtIndex(int index)
 {
-	member_list[index] = true;
+	if (!member_list[index])
+	{
+		member_list[index] = true;
+		updateCounts(index);
+	}
 }
 
 /// <summary>
@@ -353,7 +515,11 @@ void SAT_puzzle::setTrueAtIndex(int index)
 /// </param>
 void SAT_puzzle::setFalseAtIndex(int index)
 {
-	member_list[index] = false;
+	if (member_list[index])
+	{
+		member_list[index] = false;
+		updateCounts(index);
+	}
 }
 
 /// <summary>
@@ -363,6 +529,7 @@ void SAT_puzzle::setFalseAtIndex(int index)
 void SAT_puzzle::negateAtIndex(int index)
 {
 	member_list[index] = !member_list[index];
+	updateCounts(index);
 }
 
 /// <summary>
@@ -372,9 +539,415 @@ void SAT_puzzle::negateAtIndex(int index)
 /// <param name="inputValue">the value the index is to be set to</param>
 void SAT_puzzle::setMemberAtIndex(int index, bool inputValue)
 {
-	member_list[index] = inputValue;
+	if (member_list[index] != inputValue)
+	{
+		member_list[index] = inputValue;
+		updateCounts(index);
+	}
+}
+
+/// <summary>
+/// Copies the assignment of another SAT_puzzle object built from the same formula, leaving the
+/// clauses alone.  No allocation happens once this object holds an assignment of the same size.
+/// </summary>
+/// <param name="source">SAT_puzzle object whose assignment is copied</param>
+void SAT_puzzle::cloneAssignment(const SAT_puzzle &source)
+{
+	member_list = source.member_list;
+	clause_list = source.clause_list;
+	true_literals = source.true_literals;
+	unsatisfied_count = source.unsatisfied_count;
+}
+
+/// <summary>
+/// Renumbers the members and reorders the clauses of the formula.
+/// The mapping back to the original numbering is kept for model reporting.
+/// </summary>
+/// <param name="new_member_index">new index of each current member</param>
+/// <param name="clause_order">current index of the clause to be placed at each new position</param>
+void SAT_puzzle::applyOrdering(const vector<int> &new_member_index, const vector<int> &clause_order)
+{
+	//move member values and the original numbering to their new positions
+	vector<bool> new_members(num_members);
+	vector<int> new_original(num_members);
+	for (int i = 0; i < num_members; i++)
+	{
+		new_members[new_member_index[i]] = member_list[i];
+		new_original[new_member_index[i]] = original_index.empty() ? i : original_index[i];
+	}
+	member_list = new_members;
+	original_index = new_original;
+
+	//rebuild the clauses in their new order with every literal renamed
+	vector<vector<int>> new_puzzle_ints(num_clauses);
+	vector<long long> new_weights(clause_weights.size());
+	for (int i = 0; i < num_clauses; i++)
+	{
+		new_puzzle_ints[i] = puzzle_ints[clause_order[i]];
+		if (!clause_weights.empty())
+		{
+			new_weights[i] = clause_weights[clause_order[i]];
+		}
+		for (unsigned int j = 0; j < new_puzzle_ints[i].size(); j++)
+		{
+			int index = new_puzzle_ints[i][j];
+			if (index > 0)
+			{
+				new_puzzle_ints[i][j] = new_member_index[index - 1] + 1;
+			}
+			else if (index < 0)
+			{
+				new_puzzle_ints[i][j] = -(new_member_index[(-index) - 1] + 1);
+			}
+		}
+	}
+	puzzle_ints.swap(new_puzzle_ints);
+	clause_weights.swap(new_weights);
+	buildOccurrences();
+
+	recount();
+}
+
+/// <summary>
+/// Appends a clause, adding members when it names ones the formula does not have yet.
+/// New members start false; in a weighted formula the clause is added as hard.
+/// </summary>
+/// <param name="literals">literals of the clause, numbered as in the file, without the terminating 0</param>
+void SAT_puzzle::addClause(const vector<int> &literals)
+{
+	canonical_hash.clear();
+	for (unsigned int i = 0; i < literals.size(); i++)
+	{
+		addMembers(abs(literals[i]));
+	}
+
+	int clause = num_clauses;
+	puzzle_ints.push_back(literals);
+	puzzle_ints[clause].push_back(0);
+	clause_list.push_back(false);
+	if (!clause_weights.empty())
+	{
+		clause_weights.push_back(hard_weight);
+	}
+	num_clauses++;
+
+	vector<int> distinct;
+	getDistinctLiterals(clause, distinct);
+	for (unsigned int i = 0; i < distinct.size(); i++)
+	{
+		occurrences[occurrenceSlot(distinct[i])].push_back(clause);
+	}
+
+	true_literals.push_back(0);
+	if (check_trues_range(clause, clause + 1) == 0)
+	{
+		unsatisfied_count++;
+	}
+}
+
+/// <summary>
+/// Raises the number of members; the new ones start false and appear in no clause.
+/// </summary>
+/// <param name="numMembers">new number of members, ignored if not above the current one</param>
+void SAT_puzzle::addMembers(int numMembers)
+{
+	if (numMembers <= num_members)
+	{
+		return;
+	}
+	canonical_hash.clear();
+	//renumbered formulas map the new members onto themselves
+	for (int i = num_members; i < numMembers && !original_index.empty(); i++)
+	{
+		original_index.push_back(i);
+	}
+	num_members = numMembers;
+	member_list.resize(num_members, false);
+	occurrences.resize(2 * num_members);
 }
 
 /***************************************************
 * member functions END
-***************************************************/
\ No newline at end of file
+***************************************************/
+
+/***************************************************
+* private functions START
+***************************************************/
+
+/// <summary>
+/// Reads a cnf or wcnf formula line by line, filling the member, clause and weight data.
+/// </summary>
+/// <param name="in_file">reader positioned at the start of the formula</param>
+void SAT_puzzle::parse(TextReader^ in_file)
+{
+	String^ line_in = in_file->ReadLine();
+	int number_line = 0;
+	bool descriptorLine_found = false;
+
+	//loop processes each line from the file and converts it into data useable by the puzzle
+	while (line_in != nullptr)
+	{
+		//records how many lines of numbers have been reached
+		array<String^>^ token = line_in->Split(' ');
+		
+		//Seeks the indicator for the line that describes how many members and clauses there are to
+		// satisfy in the SAT problem.
+		//The expected files represent cnf formulas in a specific format used in the 2002 SAT Competition.
+		//Information on this format can be found at: http://www.satcompetition.org/2004/format-solvers2004.html
+		//All other formula-related lines should have no indicator in front of them, while comment lines should
+		// be denoted by a lower case 'c'.
+		//In this version, a flag has been added to determine if the descriptor line has been found and parsed yet.
+		// This is to prevent error lines or non-cnf files from causing problems for the program.
+		if (token[0]->Equals("p"))
+		{
+			//Attempts to parse the descriptor line for the forumula, extracting the number of members and clauses
+			try
+			{
+				num_members = int::Parse(token[2]);
+			}
+			catch (Exception^ parse_error)
+			{
+				Console::Write("Parsing error with: ");
+				Console::WriteLine(token[2]);
+				throw parse_error;
+			}
+			try
+			{
+				num_clauses = int::Parse(token[3]);
+			}
+			catch (Exception^ parse_error)
+			{
+				Console::Write("Parsing error with: ");
+				Console::WriteLine(token[3]);
+				throw parse_error;
+			}
+
+			//If the numbewr of members and clauses are successfully extracted, problem's member vectors are
+			// re-sized to accommodate a sufficient number of variables.
+			//Clause rows are left empty and grow to the length of their clause (plus the terminating 0),
+			// rather than reserving num_members + 1 entries for every clause.
+			member_list.resize(num_members);
+			clause_list.resize(num_clauses);
+			puzzle_ints.resize(num_clauses);
+
+			//Weighted MaxSAT files ("p wcnf members clauses top") give every clause a weight; clauses
+			// weighing at least top are hard.  Without a top weight only "h" clauses are hard.
+			if (token[1]->Equals("wcnf"))
+			{
+				clause_weights.resize(num_clauses);
+				hard_weight = (token->Length > 4) ? Int64::Parse(token[4]) : Int64::MaxValue;
+			}
+
+			//The flag indicating the descriptor line was found and parsed is set to true, allowing subsequent
+			// lines to be processed
+			descriptorLine_found = true;
+		}
+		// else if is used here to avoid testing more if statements than necessary
+		//There is no else following this, because lines that do not meet either the above or below
+		// if statements should not be processed.
+		/// <note> Consider adding some sort of error functionality to specifically warn of garbage lines: TJS 1/22/2015
+		else if (!token[0]->Equals("c") && descriptorLine_found)
+		{
+			//In wcnf files the clause's weight comes first, and is removed before the literals are read
+			if (!clause_weights.empty())
+			{
+				int first = 0;
+				while (first < token->Length - 1 && token[first]->Equals(""))
+				{
+					first++;
+				}
+				try
+				{
+					clause_weights[number_line] = token[first]->Equals("h") ? hard_weight : Int64::Parse(token[first]);
+				}
+				catch (Exception^ parse_error)
+				{
+					Console::Write("Parsing error with: ");
+					Console::WriteLine(token[first]);
+					throw parse_error;
+				}
+				array<String^>^ literals = gcnew array<String^>(token->Length - first - 1);
+				Array::Copy(token, first + 1, literals, 0, literals->Length);
+				token = literals;
+			}
+
+			int offset = 0;
+			for (int i = 0; i < (token->Length - offset); i++)
+			{
+				//Attempts to parse a line into a series of integers which are used to indicate which
+				// of the members needs to either be true (positive) or false (negative).
+				try
+				{
+					int z = number_line;
+					while (token[i + offset]->Equals(""))
+					{
+						offset++;
+					}
+					puzzle_ints[number_line].push_back(int::Parse(token[i + offset]));
+				}
+				catch (IndexOutOfRangeException^ index_error)
+				{
+					Console::WriteLine(token[i] + " " + i.ToString());
+					Console::WriteLine("Index OB.");
+					throw index_error;
+				}
+				catch (Exception^ parse_error)
+				{
+					Console::Write("Parsing error with: ");
+					Console::WriteLine(token[i]);
+					throw parse_error;
+				}
+			}
+			number_line++;
+		}
+
+		line_in = in_file->ReadLine();
+	}
+
+	//To create a base-state a solution is sought from, all member and clause values are set to false
+	for (int i = 0; i < num_members; i++)
+	{
+		member_list[i] = false;
+	}
+	for (int i = 0; i< num_clauses; i++)
+	{
+		clause_list[i] = false;
+	}
+
+	buildOccurrences();
+	recount();
+	hashCanonical();
+}
+
+/// <summary>
+/// Rebuilds the occurrence lists from puzzle_ints.  A clause that repeats a literal is listed
+/// once, and a tautology is not listed.
+/// </summary>
+void SAT_puzzle::buildOccurrences()
+{
+	occurrences.assign(2 * num_members, vector<int>());
+	vector<int> distinct;
+	for (int i = 0; i < num_clauses; i++)
+	{
+		getDistinctLiterals(i, distinct);
+		for (unsigned int j = 0; j < distinct.size(); j++)
+		{
+			occurrences[occurrenceSlot(distinct[j])].push_back(i);
+		}
+	}
+}
+
+/// <summary>
+/// Evaluates every clause from scratch, resetting the true literal counts and the unsatisfied count.
+/// </summary>
+void SAT_puzzle::recount()
+{
+	true_literals.resize(num_clauses);
+	int count;
+	//Very large formulas are split into clause ranges and evaluated on the thread pool.
+	if (num_clauses >= Parallel_eval::CLAUSE_THRESHOLD)
+	{
+		count = Parallel_eval::check_trues(this);
+	}
+	else
+	{
+		count = check_trues_range(0, num_clauses);
+	}
+	unsatisfied_count = num_clauses - count;
+}
+
+/// <summary>
+/// Updates the clauses containing a member after its value has changed.
+/// </summary>
+/// <param name="index">index of the member that changed</param>
+void SAT_puzzle::updateCounts(int index)
+{
+	int literal = member_list[index] ? index + 1 : -(index + 1);
+
+	//clauses gaining their first true literal become satisfied
+	const vector<int> &made = occurrences[occurrenceSlot(literal)];
+	for (unsigned int i = 0; i < made.size(); i++)
+	{
+		if (true_literals[made[i]]++ == 0)
+		{
+			clause_list[made[i]] = true;
+			unsatisfied_count--;
+		}
+	}
+
+	//clauses losing their last true literal become unsatisfied
+	const vector<int> &broken = occurrences[occurrenceSlot(-literal)];
+	for (unsigned int i = 0; i < broken.size(); i++)
+	{
+		if (--true_literals[broken[i]] == 0)
+		{
+			clause_list[broken[i]] = false;
+			unsatisfied_count++;
+		}
+	}
+}
+
+/// <summary>
+/// Maps a literal onto its position in the occurrence lists.
+/// </summary>
+/// <param name="literal">a member number as used in the file: positive for the member, negative for its negation</param>
+/// <returns>2 * (member index) for positive literals, plus one for negative literals</returns>
+int SAT_puzzle::occurrenceSlot(int literal) const
+{
+	return literal > 0 ? 2 * (literal - 1) : 2 * (-literal - 1) + 1;
+}
+
+/// <summary>
+/// Computes canonical_hash from puzzle_ints; left empty for weighted formulas, whose repeated
+/// clauses add up rather than being redundant.
+/// </summary>
+void SAT_puzzle::hashCanonical()
+{
+	canonical_hash.clear();
+	if (!clause_weights.empty())
+	{
+		return;
+	}
+
+	vector<vector<int>> clauses(num_clauses);
+	for (int i = 0; i < num_clauses; i++)
+	{
+		for (unsigned int j = 0; j < puzzle_ints[i].size() && puzzle_ints[i][j] != 0; j++)
+		{
+			clauses[i].push_back(puzzle_ints[i][j]);
+		}
+		sort(clauses[i].begin(), clauses[i].end());
+		clauses[i].erase(unique(clauses[i].begin(), clauses[i].end()), clauses[i].end());
+	}
+	sort(clauses.begin(), clauses.end());
+	clauses.erase(unique(clauses.begin(), clauses.end()), clauses.end());
+
+	//the member count leads, since models of the same clauses over more members differ in length;
+	// each clause is then written out with its terminating 0
+	vector<int> text(1, num_members);
+	for (unsigned int i = 0; i < clauses.size(); i++)
+	{
+		text.insert(text.end(), clauses[i].begin(), clauses[i].end());
+		text.push_back(0);
+	}
+	array<Byte>^ bytes = gcnew array<Byte>(4 * (int)text.size());
+	for (unsigned int i = 0; i < text.size(); i++)
+	{
+		for (int b = 0; b < 4; b++)
+		{
+			bytes[4 * i + b] = (Byte)((unsigned int)text[i] >> (8 * b));
+		}
+	}
+
+	array<Byte>^ digest = SHA256::Create()->ComputeHash(bytes);
+	const char *hex = "0123456789abcdef";
+	for (int i = 0; i < digest->Length; i++)
+	{
+		canonical_hash.push_back(hex[digest[i] >> 4]);
+		canonical_hash.push_back(hex[digest[i] & 15]);
+	}
+}
+
+/***************************************************
+* private functions END
+***************************************************/
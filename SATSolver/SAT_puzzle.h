@@ -17,6 +17,7 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <utility>
 using namespace std;
 using namespace System;
 using namespace System::IO;
@@ -30,7 +31,7 @@ public:
 	***************************************************/
 
 	/// <summary>
-	/// Default constructor; currently does nothing.
+	/// Default constructor; creates an empty formula.
 	/// </summary>
 	SAT_puzzle();
 
@@ -40,12 +41,36 @@ public:
 	/// <param name="filename">Filename of a SAT formula.</param>
 	SAT_puzzle(String^ filename);
 
+	/// <summary>
+	/// Constructor based upon text already open for reading, such as a formula held in memory.
+	/// </summary>
+	/// <param name="source">reader positioned at the start of a cnf or wcnf formula.</param>
+	SAT_puzzle(TextReader^ source);
+
 	/// <summary>
 	/// Constructor, based upon a previously existing SAT_puzzle object.
 	/// </summary>
 	/// <param name="base_puzzle"> SAT_puzzle object to be copied.
 	/// </param>
-	SAT_puzzle(SAT_puzzle &base_puzzle);
+	SAT_puzzle(const SAT_puzzle &base_puzzle);
+
+	/// <summary>
+	/// Constructor that takes over the storage of a SAT_puzzle object about to be discarded.
+	/// </summary>
+	/// <param name="base_puzzle">SAT_puzzle object to be moved from; it is left empty.</param>
+	SAT_puzzle(SAT_puzzle &&base_puzzle);
+
+	/// <summary>
+	/// Copies another SAT_puzzle object into this one, reusing this object's storage where it can.
+	/// </summary>
+	/// <param name="base_puzzle">SAT_puzzle object to be copied.</param>
+	SAT_puzzle& operator=(const SAT_puzzle &base_puzzle);
+
+	/// <summary>
+	/// Takes over the storage of a SAT_puzzle object about to be discarded.
+	/// </summary>
+	/// <param name="base_puzzle">SAT_puzzle object to be moved from; it is left empty.</param>
+	SAT_puzzle& operator=(SAT_puzzle &&base_puzzle);
 
 	/// <summary>
 	/// Destructor.
@@ -62,48 +87,155 @@ public:
 
 	/// <summary>
 	/// checks to see how many of the puzzle's clauses are satisfied as true.
+	/// The count is kept up to date by the mutators, so this does not walk the clauses.
 	/// </summary>
 	/// <returns>the number of satisfied clauses</returns>
-	int check_trues();
+	int check_trues() const;
+
+	/// <summary>
+	/// Evaluates the clauses in the range [first, last) from scratch, updating clause_list and the
+	/// count of true literals for each of them.
+	/// </summary>
+	/// <param name="first">index of the first clause to evaluate</param>
+	/// <param name="last">index one past the last clause to evaluate</param>
+	/// <returns>the number of satisfied clauses within the range</returns>
+	int check_trues_range(int first, int last);
 
 	/// <summary>
 	/// Determines whether or not the formula is satisfied and returns true or false accordingly.
 	/// </summary>
 	/// <returns>true if the formula is satisfied or false if it is not.</returns>
-	bool satisfied();
+	bool satisfied() const;
+
+	/// <summary>
+	/// Gets the number of clauses the current assignment leaves unsatisfied.
+	/// </summary>
+	/// <returns></returns>
+	int getUnsatisfiedCount() const;
+
+	/// <summary>
+	/// Writes the formula to a file in the DIMACS cnf format it is read from.
+	/// </summary>
+	/// <param name="filename">Filename to be written.</param>
+	void writeToFile(String^ filename);
 
 	////////////////////////////////////////////////////////////
 	//Accessors
 
 	/// <summary>
-	/// Gets the list of bool variables used in the formula.
+	/// Gets the list of bool variables used in the formula, without copying it.
+	/// The reference follows later changes to the assignment.
+	/// </summary>
+	/// <returns></returns>
+	const vector<bool>& getMemberList() const;
+
+	/// <summary>
+	/// Gets the list of clauses used in the formula, without copying it.
 	/// </summary>
 	/// <returns></returns>
-	vector<bool> getMemberList();
+	const vector<bool>& getClauseList() const;
 
 	/// <summary>
-	/// Gets the list of clauses used in the formula.
+	/// Gets the array of integers representing member indices within each clause, without copying it.
 	/// </summary>
 	/// <returns></returns>
-	vector<bool> getClauseList();
+	const vector<vector<int>>& getPuzzleInts() const;
 
 	/// <summary>
-	/// Gets the array of integers representing member indices within each clause
+	/// Gets the literals of one clause, terminated by 0, without copying them.
 	/// </summary>
+	/// <param name="clause">index of the clause</param>
 	/// <returns></returns>
-	vector<vector<int>> getPuzzleInts();
+	const vector<int>& getClause(int clause) const;
+
+	/// <summary>
+	/// Gets the literals of one clause with repeats removed, as local searches count them.
+	/// </summary>
+	/// <param name="clause">index of the clause</param>
+	/// <param name="literals">receives the literals, without the terminating 0; left empty for a tautology</param>
+	/// <returns>false if the clause holds both literals of a member, so no assignment falsifies it</returns>
+	bool getDistinctLiterals(int clause, vector<int> &literals) const;
+
+	/// <summary>
+	/// Gets the number of distinct literals of a clause that the current assignment makes true.
+	/// Tautologies keep the count they were last evaluated with, which is never 0.
+	/// </summary>
+	/// <param name="clause">index of the clause</param>
+	/// <returns></returns>
+	int getTrueCount(int clause) const;
 
 	/// <summary>
 	/// Get the number of member variables in the formula.
 	/// </summary>
 	/// <returns></returns>
-	int getNumMembers();
+	int getNumMembers() const;
 
 	/// <summary>
 	/// Get the number of clauses in the formula.
 	/// </summary>
 	/// <returns></returns>
-	int getNumClauses();
+	int getNumClauses() const;
+
+	/// <summary>
+	/// Gets the assignment in the variable numbering of the original file, undoing any
+	/// renumbering applied by applyOrdering().
+	/// </summary>
+	/// <returns></returns>
+	vector<bool> getOriginalMemberList() const;
+
+	/// <summary>
+	/// Gets the original file index of each member, or an empty list if the formula has not been renumbered.
+	/// </summary>
+	/// <returns></returns>
+	const vector<int>& getOriginalIndices() const;
+
+	/// <summary>
+	/// Gets the indices of the clauses that contain the given literal, in ascending order.
+	/// Tautologies are left out, as no flip can change whether they are satisfied.
+	/// </summary>
+	/// <param name="literal">a member number as used in the file: positive for the member, negative for its negation</param>
+	/// <returns></returns>
+	const vector<int>& getOccurrences(int literal) const;
+
+	/// <summary>
+	/// Determines whether the formula was read from a weighted (wcnf) file.
+	/// </summary>
+	/// <returns>true if clauses carry weights</returns>
+	bool isWeighted() const;
+
+	/// <summary>
+	/// Gets the weight of a clause; every clause of an unweighted formula weighs 1.
+	/// </summary>
+	/// <param name="clause">index of the clause</param>
+	/// <returns></returns>
+	long long getClauseWeight(int clause) const;
+
+	/// <summary>
+	/// Determines whether a clause is hard, i.e. must be satisfied by any acceptable assignment.
+	/// Clauses of an unweighted formula are all treated as soft.
+	/// </summary>
+	/// <param name="clause">index of the clause</param>
+	/// <returns></returns>
+	bool isHardClause(int clause) const;
+
+	/// <summary>
+	/// Gets the weight of every clause, or an empty list for an unweighted formula.
+	/// </summary>
+	/// <returns></returns>
+	const vector<long long>& getClauseWeights() const;
+
+	/// <summary>
+	/// Gets the weight at and above which clauses are hard.
+	/// </summary>
+	/// <returns></returns>
+	long long getHardWeight() const;
+
+	/// <summary>
+	/// Gets a hash of the clause set as parsed, with the literals of each clause sorted, clauses
+	/// sorted and repeats of either removed, so reordered copies of a formula hash alike.
+	/// </summary>
+	/// <returns>hex SHA-256, or nullptr for weighted formulas and formulas extended by addClause or addMembers</returns>
+	String^ getCanonicalHash() const;
 
 	////////////////////////////////////////////////////////////
 	//Mutators
@@ -135,11 +267,83 @@ public:
 	/// <param name="inputValue">the value the index is to be set to</param>
 	void setMemberAtIndex(int index, bool inputValue);
 
+	/// <summary>
+	/// Copies the assignment of another SAT_puzzle object built from the same formula, leaving the
+	/// clauses alone.  No allocation happens once this object holds an assignment of the same size.
+	/// </summary>
+	/// <param name="source">SAT_puzzle object whose assignment is copied</param>
+	void cloneAssignment(const SAT_puzzle &source);
+
+	/// <summary>
+	/// Renumbers the members and reorders the clauses of the formula.
+	/// The mapping back to the original numbering is kept for model reporting.
+	/// </summary>
+	/// <param name="new_member_index">new index of each current member</param>
+	/// <param name="clause_order">current index of the clause to be placed at each new position</param>
+	void applyOrdering(const vector<int> &new_member_index, const vector<int> &clause_order);
+
+	/// <summary>
+	/// Appends a clause, adding members when it names ones the formula does not have yet.
+	/// New members start false; in a weighted formula the clause is added as hard.
+	/// </summary>
+	/// <param name="literals">literals of the clause, numbered as in the file, without the terminating 0</param>
+	void addClause(const vector<int> &literals);
+
+	/// <summary>
+	/// Raises the number of members; the new ones start false and appear in no clause.
+	/// </summary>
+	/// <param name="numMembers">new number of members, ignored if not above the current one</param>
+	void addMembers(int numMembers);
+
 	/***************************************************
 	* member functions END
 	***************************************************/
 
 private:
+	/***************************************************
+	* private functions START
+	***************************************************/
+
+	/// <summary>
+	/// Reads a cnf or wcnf formula line by line, filling the member, clause and weight data.
+	/// </summary>
+	/// <param name="in_file">reader positioned at the start of the formula</param>
+	void parse(TextReader^ in_file);
+
+	/// <summary>
+	/// Rebuilds the occurrence lists from puzzle_ints.  A clause that repeats a literal is listed
+	/// once, and a tautology is not listed.
+	/// </summary>
+	void buildOccurrences();
+
+	/// <summary>
+	/// Evaluates every clause from scratch, resetting the true literal counts and the unsatisfied count.
+	/// </summary>
+	void recount();
+
+	/// <summary>
+	/// Updates the clauses containing a member after its value has changed.
+	/// </summary>
+	/// <param name="index">index of the member that changed</param>
+	void updateCounts(int index);
+
+	/// <summary>
+	/// Maps a literal onto its position in the occurrence lists.
+	/// </summary>
+	/// <param name="literal">a member number as used in the file: positive for the member, negative for its negation</param>
+	/// <returns>2 * (member index) for positive literals, plus one for negative literals</returns>
+	int occurrenceSlot(int literal) const;
+
+	/// <summary>
+	/// Computes canonical_hash from puzzle_ints; left empty for weighted formulas, whose repeated
+	/// clauses add up rather than being redundant.
+	/// </summary>
+	void hashCanonical();
+
+	/***************************************************
+	* private functions END
+	***************************************************/
+
 	/***************************************************
 	* member variables START
 	***************************************************/
@@ -147,16 +351,29 @@ private:
 	vector<bool> member_list; //variables used in the formulas
 	vector<bool> clause_list; //clauses results of the formula
 	//2D int array describing which member indicies are used in a clause and whether
-	// those members are negated or not.  Each row terminates in a 0 to signal the end
-	// of the clause.
+	// those members are negated or not.  Each row is sized to its clause and terminates
+	// in a 0 to signal the end of the clause.
 	vector<vector<int>> puzzle_ints;
+	//original file index of each member; empty until the formula is renumbered
+	vector<int> original_index;
+	//clause indices containing each literal, stored at occurrenceSlot(literal)
+	vector<vector<int>> occurrences;
+	//weight of each clause for weighted (wcnf) formulas; empty for plain cnf
+	vector<long long> clause_weights;
+	//clauses weighing at least this much are hard
+	long long hard_weight;
+	//number of distinct true literals in each clause, kept current by every mutator; tautologies,
+	// being in no occurrence list, keep the count they were last evaluated with, which is never 0
+	vector<int> true_literals;
+	//see getCanonicalHash; set by parse and cleared when clauses are added
+	string canonical_hash;
 
 	/// <summary>
-	/// true_clause_count: the number of clauses that have resolved as true
+	/// unsatisfied_count: the number of clauses with no true literal
 	/// num_members: the total number of member variables used in the formula
 	/// num_clauses: the total number of clauses contained in the formula
 	/// </summary>
-	int true_clause_count, num_members, num_clauses;
+	int unsatisfied_count, num_members, num_clauses;
 
 	/***************************************************
 	* member variables END
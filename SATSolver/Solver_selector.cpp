@@ -0,0 +1,224 @@
+#include "stdafx.h"
+#include "Solver_selector.h"
+
+// Menu numbers of runSolver, in order
+const char *Solver_selector::SOLVERS[] =
+{
+	"genetic", "hillclimb", "walksat", "paws", "saps", "coop", "dpll", "cube", "maxsat", "components"
+};
+
+// Hand-set starting point: complete search for small or Horn-heavy formulas, clause weighting for
+// large random-looking ones, WalkSAT for large under-constrained ones, and MaxSAT for wcnf.
+// A model trained on a benchmark set should replace it through solver_model.txt.
+const char *Solver_selector::DEFAULT_MODEL =
+	"solver dpll\n"
+	"bias 3.0\n"
+	"log_members -1.2\n"
+	"horn 1.5\n"
+	"len2 0.5\n"
+	"ratio 0.2\n"
+	"solver paws\n"
+	"bias 0.2\n"
+	"log_members 0.4\n"
+	"len3 0.5\n"
+	"degree_cv -0.5\n"
+	"solver walksat\n"
+	"bias 1.0\n"
+	"log_members 0.3\n"
+	"ratio -0.2\n"
+	"solver maxsat\n"
+	"bias -5.0\n"
+	"weighted 20.0\n";
+
+/***************************************************
+* public functions START
+***************************************************/
+
+/// <summary>
+/// Creates a selector holding the built-in model.
+/// </summary>
+Solver_selector::Solver_selector()
+{
+	chosen = -1;
+	parse(gcnew StringReader(gcnew String(DEFAULT_MODEL)));
+}
+
+/// <summary>
+/// Replaces the model with one read from a file, if the file exists.
+/// </summary>
+/// <param name="path">model file</param>
+/// <returns>true if the file was read, false if it does not exist</returns>
+bool Solver_selector::load(String^ path)
+{
+	if (!File::Exists(path))
+	{
+		return false;
+	}
+	StreamReader^ reader = gcnew StreamReader(path);
+	try
+	{
+		parse(reader);
+	}
+	finally
+	{
+		reader->Close();
+	}
+	return true;
+}
+
+/// <summary>
+/// Scores every solver of the model against a formula's features.
+/// </summary>
+/// <param name="features">features of the formula to be solved</param>
+/// <returns>menu number of the chosen solver</returns>
+int Solver_selector::choose(const Formula_features &features)
+{
+	double best = 0.0;
+	chosen = -1;
+	for (unsigned int i = 0; i < rules.size(); i++)
+	{
+		double score = rules[i].bias;
+		for (int f = 0; f < Formula_features::COUNT; f++)
+		{
+			score += rules[i].weights[f] * features.get(f);
+		}
+		if (chosen < 0 || score > best)
+		{
+			best = score;
+			chosen = i;
+		}
+	}
+	return rules[chosen].choice;
+}
+
+/// <summary>
+/// Time limit the model gives the solver last chosen, 0 to leave the solver's own.
+/// </summary>
+/// <returns></returns>
+int Solver_selector::getMaxTime()
+{
+	return chosen < 0 ? 0 : rules[chosen].maxTime;
+}
+
+/// <summary>
+/// Seed the model gives the solver last chosen, -1 to leave the solver's own.
+/// </summary>
+/// <returns></returns>
+int Solver_selector::getSeed()
+{
+	return chosen < 0 ? -1 : rules[chosen].seed;
+}
+
+/// <summary>
+/// Gets the model name of a solver.
+/// </summary>
+/// <param name="choice">menu number of the solver</param>
+/// <returns></returns>
+String^ Solver_selector::getSolverName(int choice)
+{
+	return gcnew String(SOLVERS[choice]);
+}
+
+/***************************************************
+* public functions END
+***************************************************/
+
+/***************************************************
+* private functions START
+***************************************************/
+
+/// <summary>
+/// Reads a model, replacing the current one only once all of it has been read.
+/// </summary>
+/// <param name="reader">model text</param>
+void Solver_selector::parse(TextReader^ reader)
+{
+	vector<Rule> parsed;
+	array<wchar_t>^ separators = { ' ', '\t' };
+	int lineNumber = 0;
+	String^ line;
+	while ((line = reader->ReadLine()) != nullptr)
+	{
+		lineNumber++;
+		int comment = line->IndexOf('#');
+		if (comment >= 0)
+		{
+			line = line->Substring(0, comment);
+		}
+		array<String^>^ tokens = line->Split(separators, StringSplitOptions::RemoveEmptyEntries);
+		if (tokens->Length == 0)
+		{
+			continue;
+		}
+		if (tokens->Length != 2)
+		{
+			throw gcnew FormatException("Solver model line " + lineNumber + ": expected a key and a value.");
+		}
+		String^ key = tokens[0]->ToLowerInvariant();
+		if (key == "solver")
+		{
+			Rule rule;
+			rule.choice = -1;
+			for (int i = 0; i < NUM_SOLVERS; i++)
+			{
+				if (tokens[1]->ToLowerInvariant()->Equals(gcnew String(SOLVERS[i])))
+				{
+					rule.choice = i;
+				}
+			}
+			if (rule.choice < 0)
+			{
+				throw gcnew FormatException("Solver model line " + lineNumber + ": unknown solver " + tokens[1] + ".");
+			}
+			rule.bias = 0.0;
+			for (int f = 0; f < Formula_features::COUNT; f++)
+			{
+				rule.weights[f] = 0.0;
+			}
+			rule.maxTime = 0;
+			rule.seed = -1;
+			parsed.push_back(rule);
+			continue;
+		}
+		if (parsed.empty())
+		{
+			throw gcnew FormatException("Solver model line " + lineNumber + ": " + tokens[0] + " comes before any solver.");
+		}
+		Rule &rule = parsed.back();
+		if (key == "time")
+		{
+			rule.maxTime = int::Parse(tokens[1]);
+		}
+		else if (key == "seed")
+		{
+			rule.seed = int::Parse(tokens[1]);
+		}
+		else
+		{
+			double value = double::Parse(tokens[1], Globalization::CultureInfo::InvariantCulture);
+			if (key == "bias")
+			{
+				rule.bias = value;
+			}
+			else
+			{
+				int feature = Formula_features::find(key);
+				if (feature < 0)
+				{
+					throw gcnew FormatException("Solver model line " + lineNumber + ": unknown feature " + tokens[0] + ".");
+				}
+				rule.weights[feature] = value;
+			}
+		}
+	}
+	if (parsed.empty())
+	{
+		throw gcnew FormatException("Solver model names no solvers.");
+	}
+	rules = parsed;
+	chosen = -1;
+}
+
+/***************************************************
+* private functions END
+***************************************************/
@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+#include "Formula_features.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+
+/// <summary>
+/// Picks a solver for a formula from its features with a linear one-vs-rest model: every solver
+/// has a bias and a weight per feature, and the solver whose score is highest is chosen.
+/// A model is plain text, one entry per line, with # starting a comment:
+///   solver walksat      starts the entry for a solver (genetic, hillclimb, walksat, paws, saps,
+///                       coop, dpll, cube, maxsat, components)
+///   bias 0.5            constant term of the score
+///   ratio -0.2          weight of a feature, by the names in Formula_features
+///   time 30000          time limit handed to the solver in ms, where it takes one
+///   seed 7              random seed handed to the solver, where it takes one
+/// </summary>
+class Solver_selector
+{
+public:
+
+	/// <summary>
+	/// Creates a selector holding the built-in model.
+	/// </summary>
+	Solver_selector();
+
+	/// <summary>
+	/// Replaces the model with one read from a file, if the file exists.
+	/// </summary>
+	/// <param name="path">model file</param>
+	/// <returns>true if the file was read, false if it does not exist</returns>
+	bool load(String^ path);
+
+	/// <summary>
+	/// Scores every solver of the model against a formula's features.
+	/// </summary>
+	/// <param name="features">features of the formula to be solved</param>
+	/// <returns>menu number of the chosen solver</returns>
+	int choose(const Formula_features &features);
+
+	/// <summary>
+	/// Time limit the model gives the solver last chosen, 0 to leave the solver's own.
+	/// </summary>
+	/// <returns></returns>
+	int getMaxTime();
+
+	/// <summary>
+	/// Seed the model gives the solver last chosen, -1 to leave the solver's own.
+	/// </summary>
+	/// <returns></returns>
+	int getSeed();
+
+	/// <summary>
+	/// Gets the model name of a solver.
+	/// </summary>
+	/// <param name="choice">menu number of the solver</param>
+	/// <returns></returns>
+	static String^ getSolverName(int choice);
+
+private:
+
+	struct Rule
+	{
+		int choice;
+		double bias;
+		double weights[Formula_features::COUNT];
+		int maxTime;
+		int seed;
+	};
+
+	static const char *SOLVERS[];
+	static const int NUM_SOLVERS = 10;
+	static const char *DEFAULT_MODEL;
+
+	vector<Rule> rules;
+	int chosen;
+
+	void parse(TextReader^ reader);
+};
@@ -0,0 +1,409 @@
+#include "stdafx.h"
+#include "Solver_server.h"
+#include "Clause_weighting.h"
+#include "MaxSAT_search.h"
+#include "DPLL.h"
+#include "Exhaustive_search.h"
+#include "Result_cache.h"
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inKey">hash of the formula text</param>
+/// <param name="inFormula">parsed formula; the entry takes ownership.</param>
+Cached_formula::Cached_formula(String^ inKey, SAT_puzzle *inFormula)
+{
+	key = inKey;
+	formula = inFormula;
+}
+
+/// <summary>
+/// Destructor; releases the parsed formula.
+/// </summary>
+Cached_formula::~Cached_formula()
+{
+	this->!Cached_formula();
+}
+
+/// <summary>
+/// Finalizer; releases the parsed formula if the entry was never disposed.
+/// </summary>
+Cached_formula::!Cached_formula()
+{
+	delete formula;
+	formula = NULL;
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inCapacity">number of formulas kept</param>
+Formula_cache::Formula_cache(int inCapacity)
+{
+	capacity = inCapacity;
+	order = gcnew LinkedList<Cached_formula^>();
+	entries = gcnew Dictionary<String^, LinkedListNode<Cached_formula^>^>();
+}
+
+/// <summary>
+/// Copies a cached formula and marks it as most recently used.
+/// </summary>
+/// <param name="key">hash of the formula text</param>
+/// <param name="copy">receives the formula when it is cached</param>
+/// <returns>true if the formula was cached</returns>
+bool Formula_cache::lookup(String^ key, SAT_puzzle &copy)
+{
+	Monitor::Enter(order);
+	try
+	{
+		LinkedListNode<Cached_formula^>^ node;
+		if (!entries->TryGetValue(key, node))
+		{
+			return false;
+		}
+		order->Remove(node);
+		order->AddFirst(node);
+		copy = *node->Value->formula;
+		return true;
+	}
+	finally
+	{
+		Monitor::Exit(order);
+	}
+}
+
+/// <summary>
+/// Adds a parsed formula, evicting the least recently used one when the cache is full.
+/// </summary>
+/// <param name="key">hash of the formula text</param>
+/// <param name="formula">parsed formula; the cache takes ownership.</param>
+void Formula_cache::insert(String^ key, SAT_puzzle *formula)
+{
+	Cached_formula^ entry = gcnew Cached_formula(key, formula);
+	Monitor::Enter(order);
+	try
+	{
+		//two jobs may parse the same formula at once; the first copy cached is kept
+		if (entries->ContainsKey(key))
+		{
+			delete entry;
+			return;
+		}
+		entries->Add(key, order->AddFirst(entry));
+		while (order->Count > capacity)
+		{
+			Cached_formula^ oldest = order->Last->Value;
+			order->RemoveLast();
+			entries->Remove(oldest->key);
+			delete oldest;
+		}
+	}
+	finally
+	{
+		Monitor::Exit(order);
+	}
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inPipeName">name of the pipe clients connect to</param>
+Solver_server::Solver_server(String^ inPipeName)
+{
+	pipeName = inPipeName;
+	cache = gcnew Formula_cache(CACHE_ENTRIES);
+	workers = gcnew Semaphore(Environment::ProcessorCount, Environment::ProcessorCount);
+}
+
+/// <summary>
+/// Accepts connections until the process is ended.
+/// </summary>
+/// <returns>process exit code</returns>
+int Solver_server::run()
+{
+	Console::WriteLine("Serving jobs on pipe " + pipeName);
+	while (true)
+	{
+		NamedPipeServerStream^ pipe;
+		try
+		{
+			pipe = gcnew NamedPipeServerStream(pipeName, PipeDirection::InOut,
+				NamedPipeServerStream::MaxAllowedServerInstances, PipeTransmissionMode::Byte);
+			pipe->WaitForConnection();
+		}
+		catch (IOException^ pipe_error)
+		{
+			Console::WriteLine("Pipe " + pipeName + " could not be opened: " + pipe_error->Message);
+			return 1;
+		}
+
+		//each connection is read on its own thread; the worker semaphore bounds how many jobs run
+		Thread^ client = gcnew Thread(gcnew ParameterizedThreadStart(this, &Solver_server::serveClient));
+		client->IsBackground = true;
+		client->Start(pipe);
+	}
+}
+
+/// <summary>
+/// Reads and answers the jobs sent over one connection.
+/// </summary>
+/// <param name="connection">the connected NamedPipeServerStream</param>
+void Solver_server::serveClient(Object^ connection)
+{
+	NamedPipeServerStream^ pipe = safe_cast<NamedPipeServerStream^>(connection);
+	StreamReader^ reader = gcnew StreamReader(pipe);
+	StreamWriter^ writer = gcnew StreamWriter(pipe);
+	writer->AutoFlush = true;
+
+	try
+	{
+		String^ line = reader->ReadLine();
+		while (line != nullptr && line != "quit")
+		{
+			array<String^>^ request = line->Split((array<wchar_t>^)nullptr, StringSplitOptions::RemoveEmptyEntries);
+			if (request->Length > 0 && request[0] == "solve")
+			{
+				runJob(request, reader, writer);
+			}
+			else if (request->Length > 0)
+			{
+				writer->WriteLine("error unknown command " + request[0]);
+				writer->WriteLine("done");
+			}
+			line = reader->ReadLine();
+		}
+	}
+	//the client closed its end of the pipe
+	catch (IOException^ closed_error)
+	{
+	}
+	finally
+	{
+		pipe->Close();
+	}
+}
+
+/// <summary>
+/// Runs one job once a worker is free and writes its results.
+/// </summary>
+/// <param name="request">tokens of the solve line</param>
+/// <param name="reader">connection reader, used for inline formulas</param>
+/// <param name="writer">connection writer</param>
+void Solver_server::runJob(array<String^>^ request, StreamReader^ reader, StreamWriter^ writer)
+{
+	//An inline formula is always read to its end line first, so a rejected job never leaves
+	// formula lines behind to be taken for commands.
+	array<Byte>^ text = nullptr;
+	String^ problem = nullptr;
+	if (request->Length == 5 && request[4] == "inline")
+	{
+		StringBuilder^ formulaText = gcnew StringBuilder();
+		String^ line = reader->ReadLine();
+		while (line != nullptr && line != "end")
+		{
+			//blank lines are dropped here, as the parser would take them for empty clauses
+			if (line->Trim()->Length > 0)
+			{
+				formulaText->AppendLine(line);
+			}
+			line = reader->ReadLine();
+		}
+		text = Encoding::UTF8->GetBytes(formulaText->ToString());
+	}
+	else if (request->Length >= 6 && request[4] == "file")
+	{
+		try
+		{
+			text = File::ReadAllBytes(String::Join(" ", request, 5, request->Length - 5));
+		}
+		catch (Exception^ read_error)
+		{
+			problem = read_error->Message;
+		}
+	}
+	else
+	{
+		problem = "expected: solve <solver> <budget ms> <seed> file <path> | inline";
+	}
+
+	int budget = 0, seed = -1;
+	if (problem == nullptr && (!int::TryParse(request[2], budget) || !int::TryParse(request[3], seed)))
+	{
+		problem = "budget and seed must be integers";
+	}
+	if (problem != nullptr)
+	{
+		writer->WriteLine("error " + problem);
+		writer->WriteLine("done");
+		return;
+	}
+
+	writer->WriteLine("c queued");
+	workers->WaitOne();
+	try
+	{
+		writer->WriteLine("c started");
+		Stopwatch ^ timeKeep = gcnew Stopwatch();
+		timeKeep->Start();
+
+		SAT_puzzle formula;
+		if (loadFormula(text, formula))
+		{
+			writer->WriteLine("c formula found in cache");
+		}
+		else
+		{
+			writer->WriteLine("c formula parsed in " + timeKeep->ElapsedMilliseconds.ToString() + " ms");
+		}
+
+		long long cost = -1;
+		vector<bool> model;
+		//improved MaxSAT costs are streamed to the client as "o" lines while the search runs
+		int result = solve(request[1], budget, seed, formula, cost, model, writer);
+		timeKeep->Stop();
+
+		if (result == -1)
+		{
+			writer->WriteLine("s SATISFIABLE");
+		}
+		else if (result == DPLL::UNSATISFIABLE)
+		{
+			writer->WriteLine("s UNSATISFIABLE");
+		}
+		else
+		{
+			writer->WriteLine("s UNKNOWN");
+			writer->WriteLine("c clauses satisfied: " + result.ToString());
+		}
+		if (!model.empty())
+		{
+			writeModel(writer, model);
+		}
+		writer->WriteLine("c milliseconds elapsed: " + timeKeep->ElapsedMilliseconds.ToString());
+	}
+	catch (IOException^ closed_error)
+	{
+		throw;
+	}
+	catch (Exception^ job_error)
+	{
+		writer->WriteLine("error " + job_error->Message);
+	}
+	finally
+	{
+		workers->Release();
+	}
+	writer->WriteLine("done");
+}
+
+/// <summary>
+/// Gets a job's formula from the cache, parsing and caching it on a miss.
+/// </summary>
+/// <param name="text">the formula text</param>
+/// <param name="formula">receives a copy of the parsed formula</param>
+/// <returns>true if the formula came from the cache</returns>
+bool Solver_server::loadFormula(array<Byte>^ text, SAT_puzzle &formula)
+{
+	//the hash of the text identifies the formula, whether it arrived by path or inline
+	HashAlgorithm^ hasher = SHA256::Create();
+	String^ key = BitConverter::ToString(hasher->ComputeHash(text));
+	if (cache->lookup(key, formula))
+	{
+		return true;
+	}
+
+	SAT_puzzle *parsed = new SAT_puzzle(gcnew StreamReader(gcnew MemoryStream(text)));
+	formula = *parsed;
+	cache->insert(key, parsed);
+	return false;
+}
+
+/// <summary>
+/// Runs the named solver on a formula.  Also used by batch runs.
+/// Formulas settled before are answered from the result cache without searching.
+/// </summary>
+/// <param name="solver">paws, saps, maxsat, dpll or exhaustive</param>
+/// <param name="budget">time budget in milliseconds</param>
+/// <param name="seed">random seed; negative seeds draw from the clock</param>
+/// <param name="formula">formula to be solved</param>
+/// <param name="cost">receives the best MaxSAT cost, or -1</param>
+/// <param name="model">receives the assignment to report, in the file's numbering</param>
+/// <param name="report">writer for the MaxSAT search's "o" lines, or nullptr to leave them out</param>
+/// <returns>-1 if satisfied, DPLL::UNSATISFIABLE if proven unsatisfiable, otherwise the clauses satisfied</returns>
+int Solver_server::solve(String^ solver, int budget, int seed, SAT_puzzle &formula, long long &cost, vector<bool> &model,
+	TextWriter^ report)
+{
+	int result;
+	cost = -1;
+	Result_cache results(Result_cache::DEFAULT_DIRECTORY);
+	if (results.lookup(formula, result, model))
+	{
+		return result;
+	}
+
+	if (solver == "exhaustive" || (Exhaustive_search::suits(formula) && solver != "maxsat"))
+	{
+		Exhaustive_search exhaustiveSolver(formula);
+		exhaustiveSolver.setMaxTime(budget);
+		result = exhaustiveSolver.run_Exhaustive();
+		if (result == -1)
+			model = exhaustiveSolver.getFormula().getOriginalMemberList();
+	}
+	else if (solver == "paws" || solver == "saps")
+	{
+		Clause_weighting weightSolver(formula, solver == "paws" ? Clause_weighting::PAWS : Clause_weighting::SAPS);
+		weightSolver.setMaxTime(budget);
+		weightSolver.setSeed(seed);
+		result = weightSolver.run_ClauseWeighting();
+		if (result == -1)
+			model = weightSolver.getFormula().getOriginalMemberList();
+	}
+	else if (solver == "maxsat")
+	{
+		MaxSAT_search maxSolver(formula);
+		maxSolver.setMaxTime(budget);
+		maxSolver.setSeed(seed);
+		maxSolver.setReport(report);
+		result = maxSolver.run_MaxSAT();
+		cost = maxSolver.getBestCost();
+		if (result == -1 || cost >= 0)
+			model = maxSolver.getFormula().getOriginalMemberList();
+	}
+	else if (solver == "dpll")
+	{
+		DPLL dpllSolver(formula);
+		dpllSolver.setMaxTime(budget);
+		result = dpllSolver.run_DPLL();
+		if (result == -1)
+			model = dpllSolver.getFormula().getOriginalMemberList();
+	}
+	else
+	{
+		throw gcnew ArgumentException("unknown solver " + solver);
+	}
+	results.store(formula, result, model, solver, budget);
+	return result;
+}
+
+/// <summary>
+/// Writes an assignment as DIMACS "v" lines, terminated by 0.
+/// </summary>
+/// <param name="writer">connection writer</param>
+/// <param name="model">assignment to be written, indexed from member 0</param>
+void Solver_server::writeModel(StreamWriter^ writer, vector<bool> &model)
+{
+	StringBuilder^ line = gcnew StringBuilder("v");
+	for (unsigned int i = 0; i < model.size(); i++)
+	{
+		int literal = model[i] ? (int)i + 1 : -((int)i + 1);
+		line->Append(" ")->Append(literal);
+		//wrap long models the same way the console output does
+		if ((i + 1) % 20 == 0)
+		{
+			writer->WriteLine(line->ToString());
+			line->Clear();
+			line->Append("v");
+		}
+	}
+	writer->WriteLine(line->Append(" 0")->ToString());
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SAT_puzzle.h"
+#using <System.dll>
+#using <System.Core.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+using namespace System::IO::Pipes;
+using namespace System::Text;
+using namespace System::Threading;
+using namespace System::Diagnostics;
+using namespace System::Collections::Generic;
+using namespace System::Security::Cryptography;
+
+/// <summary>
+/// A parsed formula owned by the formula cache.
+/// </summary>
+ref class Cached_formula
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inKey">hash of the formula text</param>
+	/// <param name="inFormula">parsed formula; the entry takes ownership.</param>
+	Cached_formula(String^ inKey, SAT_puzzle *inFormula);
+
+	/// <summary>
+	/// Destructor; releases the parsed formula.
+	/// </summary>
+	~Cached_formula();
+
+	/// <summary>
+	/// Finalizer; releases the parsed formula if the entry was never disposed.
+	/// </summary>
+	!Cached_formula();
+
+	String^ key;
+	SAT_puzzle *formula;
+};
+
+/// <summary>
+/// Least-recently-used cache of parsed formulas, keyed by a hash of the formula text so the same
+/// formula is only parsed once however it reaches the server.  All access is under one lock;
+/// callers receive copies, so evicting an entry never affects a running job.
+/// </summary>
+ref class Formula_cache
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inCapacity">number of formulas kept</param>
+	Formula_cache(int inCapacity);
+
+	/// <summary>
+	/// Copies a cached formula and marks it as most recently used.
+	/// </summary>
+	/// <param name="key">hash of the formula text</param>
+	/// <param name="copy">receives the formula when it is cached</param>
+	/// <returns>true if the formula was cached</returns>
+	bool lookup(String^ key, SAT_puzzle &copy);
+
+	/// <summary>
+	/// Adds a parsed formula, evicting the least recently used one when the cache is full.
+	/// </summary>
+	/// <param name="key">hash of the formula text</param>
+	/// <param name="formula">parsed formula; the cache takes ownership.</param>
+	void insert(String^ key, SAT_puzzle *formula);
+
+private:
+	int capacity;
+	//most recently used entries are kept at the front
+	LinkedList<Cached_formula^>^ order;
+	Dictionary<String^, LinkedListNode<Cached_formula^>^>^ entries;
+};
+
+/// <summary>
+/// Long-running solver that accepts jobs over a named pipe, so callers avoid process start-up and
+/// repeated parsing.  Each connection may send any number of jobs, one at a time:
+///   solve <solver> <budget ms> <seed> file <path>
+///   solve <solver> <budget ms> <seed> inline
+///   (cnf or wcnf lines)
+///   end
+///   quit
+/// where solver is paws, saps, maxsat, dpll or exhaustive and a negative seed draws from the clock.
+/// Unweighted formulas of at most Exhaustive_search::DISPATCH_MEMBERS members are always solved
+/// exhaustively, since that is exact and quicker than setting up any other solver.  Settled
+/// results are kept in the result cache, so a repeated formula is answered without a search.
+/// Progress comes back as "c" lines, and for maxsat as "o" lines while the cost improves, followed
+/// by an "s" status line, "v" model lines when an
+/// assignment is reported, and a final "done" line.  Failed jobs answer "error <reason>" then "done".
+/// At most one job per processor runs at a time; the rest wait for a free worker.
+/// </summary>
+ref class Solver_server
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inPipeName">name of the pipe clients connect to</param>
+	Solver_server(String^ inPipeName);
+
+	/// <summary>
+	/// Accepts connections until the process is ended.
+	/// </summary>
+	/// <returns>process exit code</returns>
+	int run();
+
+	/// <summary>
+	/// Runs the named solver on a formula.  Also used by batch runs.
+	/// Formulas settled before are answered from the result cache without searching.
+	/// </summary>
+	/// <param name="solver">paws, saps, maxsat, dpll or exhaustive</param>
+	/// <param name="budget">time budget in milliseconds</param>
+	/// <param name="seed">random seed; negative seeds draw from the clock</param>
+	/// <param name="formula">formula to be solved</param>
+	/// <param name="cost">receives the best MaxSAT cost, or -1</param>
+	/// <param name="model">receives the assignment to report, in the file's numbering</param>
+	/// <param name="report">writer for the MaxSAT search's "o" lines, or nullptr to leave them out</param>
+	/// <returns>-1 if satisfied, DPLL::UNSATISFIABLE if proven unsatisfiable, otherwise the clauses satisfied</returns>
+	static int solve(String^ solver, int budget, int seed, SAT_puzzle &formula, long long &cost, vector<bool> &model,
+		TextWriter^ report);
+
+	//number of parsed formulas kept in memory
+	literal int CACHE_ENTRIES = 16;
+
+private:
+
+	/// <summary>
+	/// Reads and answers the jobs sent over one connection.
+	/// </summary>
+	/// <param name="connection">the connected NamedPipeServerStream</param>
+	void serveClient(Object^ connection);
+
+	/// <summary>
+	/// Runs one job once a worker is free and writes its results.
+	/// </summary>
+	/// <param name="request">tokens of the solve line</param>
+	/// <param name="reader">connection reader, used for inline formulas</param>
+	/// <param name="writer">connection writer</param>
+	void runJob(array<String^>^ request, StreamReader^ reader, StreamWriter^ writer);
+
+	/// <summary>
+	/// Gets a job's formula from the cache, parsing and caching it on a miss.
+	/// </summary>
+	/// <param name="text">the formula text</param>
+	/// <param name="formula">receives a copy of the parsed formula</param>
+	/// <returns>true if the formula came from the cache</returns>
+	bool loadFormula(array<Byte>^ text, SAT_puzzle &formula);
+
+	/// <summary>
+	/// Writes an assignment as DIMACS "v" lines, terminated by 0.
+	/// </summary>
+	/// <param name="writer">connection writer</param>
+	/// <param name="model">assignment to be written, indexed from member 0</param>
+	void writeModel(StreamWriter^ writer, vector<bool> &model);
+
+	String^ pipeName;
+	Formula_cache^ cache;
+	Semaphore^ workers;
+};
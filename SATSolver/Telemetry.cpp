@@ -0,0 +1,175 @@
+#include "stdafx.h"
+#include "Telemetry.h"
+
+/// <summary>
+/// Publishes the state of a local search.
+/// </summary>
+/// <param name="inSteps">flips made so far</param>
+/// <param name="inCurrent">clauses the current assignment leaves unsatisfied</param>
+/// <param name="inBest">fewest clauses any assignment so far left unsatisfied</param>
+void Search_progress::publish(long long inSteps, int inCurrent, int inBest)
+{
+	steps = (unsigned int)inSteps;
+	current = inCurrent;
+	best = inBest;
+}
+
+/// <summary>
+/// Turns telemetry on for the searches started from now on.
+/// </summary>
+/// <param name="inInterval">milliseconds between lines</param>
+/// <param name="inOutput">where the lines are written; the writer must be thread-safe</param>
+void Telemetry::configure(int inInterval, TextWriter^ inOutput)
+{
+	interval = inInterval;
+	output = inOutput;
+}
+
+/// <summary>
+/// Starts reporting on a search, if telemetry has been configured.
+/// </summary>
+/// <param name="solver">name of the search, written on every line</param>
+/// <param name="records">progress records the search publishes to, owned by the caller</param>
+/// <param name="count">number of records</param>
+/// <returns>the running reporter, or nullptr if telemetry is off</returns>
+Telemetry^ Telemetry::begin(String^ solver, Search_progress *records, int count)
+{
+	if (interval <= 0 || output == nullptr)
+	{
+		return nullptr;
+	}
+	Telemetry^ telemetry = gcnew Telemetry(solver, records, count);
+	telemetry->thread->Start();
+	return telemetry;
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+Telemetry::Telemetry(String^ inSolver, Search_progress *inRecords, int inCount)
+{
+	solver = inSolver;
+	records = inRecords;
+	count = inCount;
+	lastSteps = gcnew array<unsigned int>(count);
+	steps = lastTotal = lastTime = 0;
+	best = fitness = -1;
+	lastImprovement = 0;
+	timeKeeper = gcnew Stopwatch();
+	timeKeeper->Start();
+	stopping = gcnew ManualResetEvent(false);
+
+	//the reporter must never take time from the search, nor keep the process alive
+	thread = gcnew Thread(gcnew ThreadStart(this, &Telemetry::Run));
+	thread->Priority = ThreadPriority::Lowest;
+	thread->IsBackground = true;
+}
+
+/// <summary>
+/// Stops the reporting thread and writes a last line with the final counters.
+/// </summary>
+void Telemetry::finish()
+{
+	stopping->Set();
+	thread->Join();
+	report(true);
+	timeKeeper->Stop();
+}
+
+/// <summary>
+/// Thread entry point: writes a line every interval until finish is called.
+/// </summary>
+void Telemetry::Run()
+{
+	while (!stopping->WaitOne(interval))
+	{
+		report(false);
+	}
+}
+
+/// <summary>
+/// Samples the records and writes one line.
+/// </summary>
+/// <param name="last">true for the line written when the search has ended</param>
+void Telemetry::report(bool last)
+{
+	long long now = timeKeeper->ElapsedMilliseconds;
+	int current = -1, bestNow = -1, restarts = -1, generation = -1, fitnessNow = -1;
+	for (int i = 0; i < count; i++)
+	{
+		//the difference of two 32-bit samples is exact as long as fewer than 2^32 steps fall between them
+		unsigned int sampled = records[i].steps;
+		steps += (unsigned int)(sampled - lastSteps[i]);
+		lastSteps[i] = sampled;
+
+		int value = records[i].current;
+		if (value >= 0 && (current < 0 || value < current))
+		{
+			current = value;
+		}
+		value = records[i].best;
+		if (value >= 0 && (bestNow < 0 || value < bestNow))
+		{
+			bestNow = value;
+		}
+		value = records[i].restarts;
+		if (value >= 0)
+		{
+			restarts = Math::Max(restarts, 0) + value;
+		}
+		generation = Math::Max(generation, (int)records[i].generation);
+		fitnessNow = Math::Max(fitnessNow, (int)records[i].fitness);
+	}
+
+	if ((bestNow >= 0 && (best < 0 || bestNow < best)) || fitnessNow > fitness)
+	{
+		lastImprovement = now;
+	}
+	if (bestNow >= 0 && (best < 0 || bestNow < best))
+	{
+		best = bestNow;
+	}
+	fitness = Math::Max(fitness, fitnessNow);
+
+	long long rate = (steps - lastTotal) * 1000 / Math::Max(now - lastTime, 1LL);
+	lastTotal = steps;
+	lastTime = now;
+
+	String^ line = "{\"elapsed_ms\":" + now.ToString() + ",\"solver\":\"" + solver + "\"";
+	if (last)
+	{
+		line += ",\"final\":true";
+	}
+	line += ",\"steps\":" + steps.ToString() + ",\"steps_per_sec\":" + rate.ToString();
+	if (current >= 0)
+	{
+		line += ",\"current_unsat\":" + current.ToString();
+	}
+	if (best >= 0)
+	{
+		line += ",\"best_unsat\":" + best.ToString();
+	}
+	if (restarts >= 0)
+	{
+		line += ",\"restarts\":" + restarts.ToString();
+	}
+	if (generation >= 0)
+	{
+		line += ",\"generation\":" + generation.ToString();
+	}
+	if (fitness >= 0)
+	{
+		line += ",\"best_fitness\":" + fitness.ToString();
+	}
+	line += ",\"since_improvement_ms\":" + (now - lastImprovement).ToString()
+		+ ",\"working_set\":" + Environment::WorkingSet.ToString() + "}";
+
+	//telemetry only observes the search, so a failed write is not an error
+	try
+	{
+		output->WriteLine(line);
+	}
+	catch (Exception^ write_error)
+	{
+	}
+}
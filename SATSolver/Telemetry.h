@@ -0,0 +1,101 @@
+#pragma once
+#include <string>
+#include <vector>
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::IO;
+using namespace System::Threading;
+using namespace System::Diagnostics;
+
+/// <summary>
+/// Progress counters a search publishes for the telemetry thread.  Each field is a single
+/// aligned 32-bit store, so the search writes them without locking and the reader never sees a
+/// torn value.  Searches only publish at their existing clock checks, keeping it off the flip path.
+/// A field left at -1 is not reported by that search.
+/// </summary>
+struct Search_progress
+{
+	/// <summary>
+	/// Publishes the state of a local search.
+	/// </summary>
+	/// <param name="inSteps">flips made so far</param>
+	/// <param name="inCurrent">clauses the current assignment leaves unsatisfied</param>
+	/// <param name="inBest">fewest clauses any assignment so far left unsatisfied</param>
+	void publish(long long inSteps, int inCurrent, int inBest);
+
+	//flips, or decisions for DPLL; only the low 32 bits are kept, so the reader works with differences
+	volatile unsigned int steps = 0;
+	volatile int current = -1;
+	volatile int best = -1;
+	volatile int restarts = -1;
+	volatile int generation = -1;
+	volatile int fitness = -1; //clauses satisfied by the fittest individual
+};
+
+/// <summary>
+/// Streams the progress of a running search as one JSON object per line, so long runs can be
+/// watched and stalled ones flagged.  A background thread of low priority samples the searches'
+/// Search_progress records every interval; the searches themselves never wait on it.  Records of
+/// parallel workers are combined: steps and restarts are summed, unsatisfied counts take the minimum.
+/// Each line holds the elapsed time, the solver, the step count and rate, the unsatisfied counts,
+/// the restarts, the generation and best fitness of a genetic search, the working set in bytes,
+/// and the milliseconds since the best count last improved.
+/// </summary>
+ref class Telemetry
+{
+public:
+
+	/// <summary>
+	/// Turns telemetry on for the searches started from now on.
+	/// </summary>
+	/// <param name="inInterval">milliseconds between lines</param>
+	/// <param name="inOutput">where the lines are written; the writer must be thread-safe</param>
+	static void configure(int inInterval, TextWriter^ inOutput);
+
+	/// <summary>
+	/// Starts reporting on a search, if telemetry has been configured.
+	/// </summary>
+	/// <param name="solver">name of the search, written on every line</param>
+	/// <param name="records">progress records the search publishes to, owned by the caller</param>
+	/// <param name="count">number of records</param>
+	/// <returns>the running reporter, or nullptr if telemetry is off</returns>
+	static Telemetry^ begin(String^ solver, Search_progress *records, int count);
+
+	/// <summary>
+	/// Stops the reporting thread and writes a last line with the final counters.
+	/// </summary>
+	void finish();
+
+private:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	Telemetry(String^ inSolver, Search_progress *inRecords, int inCount);
+
+	/// <summary>
+	/// Thread entry point: writes a line every interval until finish is called.
+	/// </summary>
+	void Run();
+
+	/// <summary>
+	/// Samples the records and writes one line.
+	/// </summary>
+	/// <param name="last">true for the line written when the search has ended</param>
+	void report(bool last);
+
+	static int interval; //0 while telemetry is off
+	static TextWriter^ output;
+
+	String^ solver;
+	Search_progress *records;
+	int count;
+	array<unsigned int>^ lastSteps; //steps of each record at the previous sample
+	long long steps, lastTotal, lastTime;
+	int best, fitness;
+	long long lastImprovement;
+	Stopwatch ^ timeKeeper;
+	ManualResetEvent^ stopping;
+	Thread^ thread;
+};
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "WalkSAT.h"
+#include "Checkpoint.h"
 
 
 
@@ -8,6 +9,7 @@
 /// </summary>
 WalkSAT::WalkSAT()
 {
+	noise = 0.0;
 }
 
 /// <summary>
@@ -16,7 +18,8 @@ WalkSAT::WalkSAT()
 /// <param name="inPuzzle">SAT_puzzle object to be solved.</param>
 WalkSAT::WalkSAT(SAT_puzzle inPuzzle)
 {
-	baseFormula = inPuzzle;
+	baseFormula = std::move(inPuzzle);
+	noise = 0.0;
 
 	baseFormula.check_trues();
 	bool t = baseFormula.satisfied();
@@ -24,66 +27,128 @@ WalkSAT::WalkSAT(SAT_puzzle inPuzzle)
 }
 
 /// <summary>
-/// Runs the hill climb algorithm
+/// Runs the WalkSAT algorithm until the formula is satisfied or MAXTIME milliseconds have passed.
+/// Each step flips a random member with probability noise, and otherwise the member whose flip
+/// gains the most.  The noise adapts to the instance: it is raised whenever the number of
+/// satisfied clauses has not improved for THETA * clauses steps, and lowered on every improvement.
 /// </summary>
-/// <returns>an integer representing success, failure, or timing out.</returns>
+/// <returns>-1 if the formula was satisfied, otherwise the most clauses satisfied at once.</returns>
 int WalkSAT::run_WalkSAT()
 {
-	Random ^ rand = gcnew Random();
+	Random ^ rand = nullptr;
 	Stopwatch ^ timeKeeper = gcnew Stopwatch();
 	timeKeeper->Start();
+	String ^ path = checkpointPath;
+	long long flips = 0, lastSaved = 0, elapsedBefore = 0;
+	int bestSatisfied = -1;
+	vector<bool> best;
+	long long adaptFlips = 0;
+	int adaptSatisfied = -1;
+	noise = 0.0;
 
-	for (int i = 0; i < baseFormula.getNumMembers(); i++)
+	//resume an interrupted run when a checkpoint for this formula exists
+	BinaryReader ^ saved = (path == nullptr) ? nullptr : Checkpoint::open(path, Checkpoint::WALKSAT, &baseFormula);
+	if (saved != nullptr)
 	{
-		if (rand->Next(2) == 1)
+		flips = saved->ReadInt64();
+		elapsedBefore = saved->ReadInt64();
+		bestSatisfied = saved->ReadInt32();
+		noise = saved->ReadDouble();
+		adaptFlips = saved->ReadInt64();
+		adaptSatisfied = saved->ReadInt32();
+		best = Checkpoint::readAssignment(saved);
+		vector<bool> current = Checkpoint::readAssignment(saved);
+		rand = Checkpoint::readRandom(saved);
+		saved->Close();
+		for (int i = 0; i < baseFormula.getNumMembers(); i++)
 		{
-			baseFormula.setTrueAtIndex(i);
-		}
-		else
-		{
-			baseFormula.setFalseAtIndex(i);
+			baseFormula.setMemberAtIndex(i, current[i]);
 		}
+		lastSaved = elapsedBefore;
+		Console::WriteLine("Resumed from checkpoint after " + flips.ToString() + " flips and "
+			+ elapsedBefore.ToString() + " ms.");
+	}
+	else
+	{
+		rand = (seed < 0) ? gcnew Random() : gcnew Random(seed);
+		Initial_assignment start(baseFormula);
+		start.assign(baseFormula, initialization, rand);
+		adaptSatisfied = baseFormula.check_trues();
 	}
 
-	int index = 1;
+	scores.load(baseFormula);
+	double stallSteps = THETA * baseFormula.getNumClauses();
 
-	while (index >= 0)
+	while (!baseFormula.satisfied() && baseFormula.getNumMembers() > 0)
 	{
-		//check for an index to improve the current solution fitness
-		if (rand->Next(2) == 1)
+		//the clock is only read, snapshots taken and progress published every 256 steps to keep
+		// them off the flip path; time spent before a resumed checkpoint counts against the budget
+		if ((flips & 255) == 0)
+		{
+			long long elapsed = elapsedBefore + timeKeeper->ElapsedMilliseconds;
+			if (elapsed >= MAXTIME)
+			{
+				break;
+			}
+			if (path != nullptr && elapsed - lastSaved >= Checkpoint::INTERVAL)
+			{
+				saveCheckpoint(rand, flips, elapsed, bestSatisfied, best, adaptFlips, adaptSatisfied);
+				lastSaved = elapsed;
+			}
+			if (progress != nullptr)
+			{
+				int unsatisfied = baseFormula.getUnsatisfiedCount();
+				progress->publish(flips, unsatisfied, Math::Min(unsatisfied, baseFormula.getNumClauses() - bestSatisfied));
+			}
+		}
+
+		int index;
+		if (rand->NextDouble() < noise)
 		{
-			index = bestStep();
+			index = randStep(rand);
 		}
 		else
 		{
-			index = randStep();
+			index = bestStep(rand);
 		}
-		int blah2 = 0;
+		baseFormula.negateAtIndex(index);
+		scores.flip(index);
+		flips++;
 
-		//If an index is found, which improves the current solution fitness when the variable
-		// at that location is flipped, then that value is flipped.
-		//If more than one such index is found, the best among them is flipped.
-		if (index >= 0)
+		int num_trues = baseFormula.check_trues();
+		if (num_trues > bestSatisfied)
 		{
-			baseFormula.negateAtIndex(index);
-			int num_trues = baseFormula.check_trues();
-			int blah = 0;
-			if (baseFormula.satisfied())
-			{
-				return -1;
-			}
+			bestSatisfied = num_trues;
+			best = baseFormula.getMemberList();
 		}
-		else
+
+		//Hoos' adaptive noise: improvements lower the noise gently, stagnation raises it sharply
+		if (num_trues > adaptSatisfied)
 		{
-			if (baseFormula.satisfied())
-			{
-				return -1;
-			}
-			else { return baseFormula.check_trues(); }
+			noise -= noise * PHI / 2;
+			adaptSatisfied = num_trues;
+			adaptFlips = flips;
+		}
+		else if (flips - adaptFlips > stallSteps)
+		{
+			noise += (1 - noise) * PHI;
+			adaptSatisfied = num_trues;
+			adaptFlips = flips;
 		}
 	}
 
 	timeKeeper->Stop();
+	if (path != nullptr)
+		Checkpoint::remove(path);
+
+	//report the best assignment seen rather than wherever the walk stopped
+	if (bestSatisfied > baseFormula.check_trues())
+	{
+		for (int i = 0; i < baseFormula.getNumMembers(); i++)
+		{
+			baseFormula.setMemberAtIndex(i, best[i]);
+		}
+	}
 	if (baseFormula.satisfied())
 	{
 		return -1;
@@ -109,42 +174,105 @@ int WalkSAT::checkPuzzle()
 	return baseFormula.check_trues();
 }
 
+/// <summary>
+/// Gets the formula in its current state, including the assignment reached by the search.
+/// </summary>
+/// <returns>the SAT_puzzle object being solved</returns>
+const SAT_puzzle& WalkSAT::getFormula()
+{
+	return baseFormula;
+}
 
+/// <summary>
+/// Sets a checkpoint file.  A checkpoint left in it by an interrupted run on the same formula
+/// is resumed, and the search state is saved to it every Checkpoint::INTERVAL milliseconds.
+/// </summary>
+/// <param name="path">checkpoint file</param>
+void WalkSAT::setCheckpoint(String^ path)
+{
+	checkpointPath = path;
+}
 
 /// <summary>
-/// Searches for the best index to flip to improve solution fitness.
+/// Sets the time budget for subsequent runs.  A resumed run counts the time spent before
+/// its checkpoint against the budget.
 /// </summary>
-/// <returns>the index of the best variable to flip</returns>
-int WalkSAT::bestStep()
+/// <param name="maxTime">time budget in milliseconds</param>
+void WalkSAT::setMaxTime(int maxTime)
 {
-	int index = -1;
-	int currentSatisfied = baseFormula.check_trues();
+	MAXTIME = maxTime;
+}
 
-	vector<int> satisfiedClauses;
-	satisfiedClauses.resize(baseFormula.getNumMembers());
-	for (int i = -0; i < satisfiedClauses.capacity(); i++)
-	{
-		satisfiedClauses[i] = 0;
-	}
+/// <summary>
+/// Gets the noise level the last run ended with.
+/// </summary>
+/// <returns>probability of a random step, between 0 and 1</returns>
+double WalkSAT::getNoise()
+{
+	return noise;
+}
 
-	//determine which variable satisfies the greatest number of clauses when it is flipped
-	for (int i = 0; i < satisfiedClauses.capacity(); i++)
-	{
-		baseFormula.negateAtIndex(i);
-		satisfiedClauses[i] = baseFormula.check_trues();
-		baseFormula.negateAtIndex(i);
+/// <summary>
+/// Sets how the starting assignment is built.  The default is a fair coin flip per member.
+/// </summary>
+/// <param name="strategy"></param>
+void WalkSAT::setInitialization(Initial_assignment::Strategy strategy)
+{
+	initialization = strategy;
+}
 
-		if (satisfiedClauses[i] > currentSatisfied)
-		{
-			index = i;
-			currentSatisfied = satisfiedClauses[i];
-		}
-	}
-	return index;
+/// <summary>
+/// Sets where the search publishes its progress for telemetry.
+/// </summary>
+/// <param name="record">progress record owned by the caller, or nullptr for none</param>
+void WalkSAT::setProgress(Search_progress *record)
+{
+	progress = record;
 }
 
-int WalkSAT::randStep()
+/// <summary>
+/// Sets the seed of the random number source, making runs repeatable.
+/// </summary>
+/// <param name="inSeed">seed for subsequent runs; a negative seed draws from the clock</param>
+void WalkSAT::setSeed(int inSeed)
+{
+	seed = inSeed;
+}
+
+
+
+/// <summary>
+/// Picks the member whose flip gains the most, breaking ties randomly.  At a local minimum
+/// this is a sideways or downhill move; escaping from there is left to the noise.
+/// </summary>
+/// <param name="rand">random number source for tie-breaking</param>
+/// <returns>the index of the best variable to flip</returns>
+int WalkSAT::bestStep(Random ^ rand)
+{
+	//the scores are kept up to date by every flip, so the best one is read off the top bucket
+	return scores.pickBest(rand);
+}
+
+int WalkSAT::randStep(Random ^ rand)
 {
-	Random ^ rand = gcnew Random();
 	return rand->Next(baseFormula.getNumMembers());
+}
+
+/// <summary>
+/// Saves the current and best assignments, the flip count, the time spent, the noise state and
+/// the random number source.
+/// </summary>
+void WalkSAT::saveCheckpoint(Random ^ rand, long long flips, long long elapsed, int bestSatisfied, const vector<bool> &best, long long adaptFlips, int adaptSatisfied)
+{
+	BinaryWriter ^ writer = Checkpoint::create(checkpointPath, Checkpoint::WALKSAT, &baseFormula);
+	writer->Write(flips);
+	writer->Write(elapsed);
+	writer->Write(bestSatisfied);
+	writer->Write(noise);
+	writer->Write(adaptFlips);
+	writer->Write(adaptSatisfied);
+	Checkpoint::writeAssignment(writer, best);
+	Checkpoint::writeAssignment(writer, baseFormula.getMemberList());
+	Checkpoint::writeRandom(writer, rand);
+	Checkpoint::commit(writer, checkpointPath);
 }
\ No newline at end of file
@@ -1,7 +1,11 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <vcclr.h>
 #include "SAT_puzzle.h"
+#include "Telemetry.h"
+#include "Flip_scores.h"
+#include "Initial_assignment.h"
 #using <System.dll>
 using namespace std;
 using namespace System;
@@ -28,9 +32,12 @@ public:
 	WalkSAT(SAT_puzzle inPuzzle);
 
 	/// <summary>
-	/// Runs the hill climb algorithm
+	/// Runs the WalkSAT algorithm until the formula is satisfied or MAXTIME milliseconds have passed.
+	/// Each step flips a random member with probability noise, and otherwise the member whose flip
+	/// gains the most.  The noise adapts to the instance: it is raised whenever the number of
+	/// satisfied clauses has not improved for THETA * clauses steps, and lowered on every improvement.
 	/// </summary>
-	/// <returns>an integer representing success, failure, or timing out.</returns>
+	/// <returns>-1 if the formula was satisfied, otherwise the most clauses satisfied at once.</returns>
 	int run_WalkSAT();
 
 	/// <summary>
@@ -45,17 +52,78 @@ public:
 	/// <returns>an integer equal to the number of satisfied clauses</returns>
 	int checkPuzzle();
 
+	/// <summary>
+	/// Gets the formula in its current state, including the assignment reached by the search.
+	/// </summary>
+	/// <returns>the SAT_puzzle object being solved</returns>
+	const SAT_puzzle& getFormula();
+
+	/// <summary>
+	/// Sets a checkpoint file.  A checkpoint left in it by an interrupted run on the same formula
+	/// is resumed, and the search state is saved to it every Checkpoint::INTERVAL milliseconds.
+	/// </summary>
+	/// <param name="path">checkpoint file</param>
+	void setCheckpoint(String^ path);
+
+	/// <summary>
+	/// Sets the time budget for subsequent runs.  A resumed run counts the time spent before
+	/// its checkpoint against the budget.
+	/// </summary>
+	/// <param name="maxTime">time budget in milliseconds</param>
+	void setMaxTime(int maxTime);
+
+	/// <summary>
+	/// Gets the noise level the last run ended with.
+	/// </summary>
+	/// <returns>probability of a random step, between 0 and 1</returns>
+	double getNoise();
+
+	/// <summary>
+	/// Sets how the starting assignment is built.  The default is a fair coin flip per member.
+	/// </summary>
+	/// <param name="strategy"></param>
+	void setInitialization(Initial_assignment::Strategy strategy);
+
+	/// <summary>
+	/// Sets where the search publishes its progress for telemetry.
+	/// </summary>
+	/// <param name="record">progress record owned by the caller, or nullptr for none</param>
+	void setProgress(Search_progress *record);
+
+	/// <summary>
+	/// Sets the seed of the random number source, making runs repeatable.
+	/// </summary>
+	/// <param name="inSeed">seed for subsequent runs; a negative seed draws from the clock</param>
+	void setSeed(int inSeed);
+
 private:
 
 	/// <summary>
-	/// Searches for the best index to flip to improve solution fitness.
+	/// Picks the member whose flip gains the most, breaking ties randomly.  At a local minimum
+	/// this is a sideways or downhill move; escaping from there is left to the noise.
 	/// </summary>
+	/// <param name="rand">random number source for tie-breaking</param>
 	/// <returns>the index of the best variable to flip</returns>
-	int bestStep();
+	int bestStep(Random ^ rand);
+
+	int randStep(Random ^ rand);
 
-	int randStep();
+	/// <summary>
+	/// Saves the current and best assignments, the flip count, the time spent, the noise state and
+	/// the random number source.
+	/// </summary>
+	void saveCheckpoint(Random ^ rand, long long flips, long long elapsed, int bestSatisfied, const vector<bool> &best, long long adaptFlips, int adaptSatisfied);
 
 	SAT_puzzle baseFormula;
+	Flip_scores scores; //score of flipping each member, for the current assignment
 	int MAXTIME = 10000;
+	Search_progress *progress = nullptr;
+	int seed = -1;
+	gcroot<String^> checkpointPath;
+	Initial_assignment::Strategy initialization = Initial_assignment::RANDOM;
+
+	//adaptive noise: stagnation is THETA * clauses steps without improvement, and PHI sets the step size
+	double THETA = 1.0 / 6, PHI = 0.2;
+	double noise; //current probability of a random step
 };
 
@@ -0,0 +1,334 @@
+#include "stdafx.h"
+#include "Model_verifier.h"
+
+/***************************************************
+* public functions START
+***************************************************/
+
+/// <summary>
+/// Default constructor.
+/// </summary>
+Model_verifier::Model_verifier()
+{
+	clause_count = 0;
+	falsified_count = 0;
+	first_falsified = 0;
+	weighted = false;
+	top = -1;
+	soft_cost = 0;
+	claimed_cost = -1;
+}
+
+/// <summary>
+/// Reads a model: "v" lines as printed by solvers, or plain lists of literals.
+/// "c" and "s" lines are skipped, the last "o" line gives the claimed cost, and a 0 ends the model.
+/// </summary>
+/// <param name="in">reader positioned at the start of the model</param>
+/// <returns>false if the model says the formula is not satisfiable</returns>
+bool Model_verifier::loadModel(Token_reader^ in)
+{
+	long long literal;
+	while (true)
+	{
+		in->skipSpace();
+		int c = in->peek();
+		if (c < 0)
+		{
+			return true;
+		}
+		if (c == 's')
+		{
+			//"s UNSATISFIABLE" or "s UNKNOWN" leave nothing to verify; MaxSAT solvers may say "s OPTIMUM FOUND"
+			in->next();
+			in->skipSpace();
+			bool satisfiable = in->peek() == 'S' || in->peek() == 'O';
+			in->skipLine();
+			if (!satisfiable)
+			{
+				return false;
+			}
+		}
+		else if (c == 'c')
+		{
+			in->skipLine();
+		}
+		else if (c == 'o')
+		{
+			in->next();
+			if (!in->readNumber(claimed_cost))
+			{
+				throw gcnew FormatException("The \"o\" line of the model has no cost.");
+			}
+		}
+		else if (c == 'v')
+		{
+			in->next();
+		}
+		else if (in->readNumber(literal))
+		{
+			if (literal == 0)
+			{
+				return true;
+			}
+			assign(literal);
+		}
+		else
+		{
+			throw gcnew FormatException("Unexpected character '" + Convert::ToChar(c) + "' in the model.");
+		}
+	}
+}
+
+/// <summary>
+/// Streams the formula, checking every clause against the model.
+/// </summary>
+/// <param name="in">reader positioned at the start of the formula</param>
+/// <returns>true if every hard clause is satisfied</returns>
+bool Model_verifier::verify(Token_reader^ in)
+{
+	clause_count = 0;
+	falsified_count = 0;
+	first_falsified = 0;
+	first_clause.clear();
+	weighted = false;
+	top = -1;
+	soft_cost = 0;
+
+	bool clause_started = false, satisfied = false, hard = true;
+	vector<int> clause;
+	long long literal, weight = 0;
+	while (true)
+	{
+		in->skipSpace();
+		int c = in->peek();
+		//a '%' line ends the formula in some benchmark files
+		if (c < 0 || c == '%')
+		{
+			break;
+		}
+		if (c == 'c')
+		{
+			in->skipLine();
+			continue;
+		}
+		if (c == 'p')
+		{
+			in->next();
+			readHeader(in);
+			continue;
+		}
+
+		//the weight of a wcnf clause comes before its literals, and "h" marks a hard clause
+		if (weighted && !clause_started)
+		{
+			if (c == 'h')
+			{
+				in->next();
+				hard = true;
+			}
+			else if (!in->readNumber(weight))
+			{
+				throw gcnew FormatException("Clause " + (clause_count + 1).ToString() + " has no weight.");
+			}
+			else
+			{
+				hard = top >= 0 && weight >= top;
+			}
+			clause_started = true;
+			continue;
+		}
+		if (c == 'h')
+		{
+			throw gcnew FormatException("Clause " + (clause_count + 1).ToString() + " is marked hard, but there is no \"p wcnf\" line.");
+		}
+
+		if (!in->readNumber(literal))
+		{
+			throw gcnew FormatException("Unexpected character '" + Convert::ToChar(c) + "' in clause " + (clause_count + 1).ToString() + ".");
+		}
+		if (literal != 0)
+		{
+			clause_started = true;
+			satisfied = satisfied || isTrue(literal);
+			//only the first falsified clause is reported, so later clauses need not be kept
+			if (first_falsified == 0)
+			{
+				clause.push_back((int)literal);
+			}
+			continue;
+		}
+
+		endClause(clause, satisfied, hard, weight);
+		clause.clear();
+		clause_started = false;
+		satisfied = false;
+		hard = true;
+	}
+
+	//a last clause missing its terminating 0 still counts
+	if (clause_started)
+	{
+		endClause(clause, satisfied, hard, weight);
+	}
+	return falsified_count == 0;
+}
+
+/// <summary>
+/// Gets the number of clauses read by verify.
+/// </summary>
+/// <returns></returns>
+long long Model_verifier::getClauseCount()
+{
+	return clause_count;
+}
+
+/// <summary>
+/// Gets the number of falsified clauses found by verify.
+/// </summary>
+/// <returns></returns>
+long long Model_verifier::getFalsifiedCount()
+{
+	return falsified_count;
+}
+
+/// <summary>
+/// Gets the 1-based position in the file of the first falsified clause.
+/// </summary>
+/// <returns>the position, or 0 if no clause was falsified</returns>
+long long Model_verifier::getFirstFalsified()
+{
+	return first_falsified;
+}
+
+/// <summary>
+/// Gets the literals of the first falsified clause.
+/// </summary>
+/// <returns></returns>
+const vector<int> &Model_verifier::getFirstFalsifiedClause()
+{
+	return first_clause;
+}
+
+/// <summary>
+/// Determines whether verify read a wcnf formula.
+/// </summary>
+/// <returns></returns>
+bool Model_verifier::isWeighted()
+{
+	return weighted;
+}
+
+/// <summary>
+/// Gets the summed weight of the soft clauses falsified by the model.
+/// </summary>
+/// <returns></returns>
+long long Model_verifier::getSoftCost()
+{
+	return soft_cost;
+}
+
+/// <summary>
+/// Gets the cost given by the last "o" line of the model.
+/// </summary>
+/// <returns>the cost, or -1 if the model has no "o" line</returns>
+long long Model_verifier::getClaimedCost()
+{
+	return claimed_cost;
+}
+
+/***************************************************
+* public functions END
+***************************************************/
+
+/***************************************************
+* private functions START
+***************************************************/
+
+/// <summary>
+/// Records the value given to a member by a model literal.
+/// </summary>
+void Model_verifier::assign(long long literal)
+{
+	long long member = (literal > 0 ? literal : -literal) - 1;
+	unsigned int word = (unsigned int)(member >> 5), bit = 1u << (member & 31);
+	if (word >= assigned.size())
+	{
+		assigned.resize(word + 1, 0);
+		values.resize(word + 1, 0);
+	}
+	assigned[word] |= bit;
+	if (literal > 0)
+	{
+		values[word] |= bit;
+	}
+	else
+	{
+		values[word] &= ~bit;
+	}
+}
+
+/// <summary>
+/// Reads the rest of a "p" line, taking the top weight from a "p wcnf" line.
+/// </summary>
+void Model_verifier::readHeader(Token_reader^ in)
+{
+	//the line is read whole, as readNumber would run on into the clauses when the top weight is left out
+	String^ line = "";
+	int c = in->next();
+	while (c >= 0 && c != '\n')
+	{
+		line += Convert::ToChar(c);
+		c = in->next();
+	}
+	array<String^>^ fields = line->Split((array<Char>^)nullptr, StringSplitOptions::RemoveEmptyEntries);
+	weighted = fields->Length > 0 && fields[0]->Equals("wcnf");
+	if (weighted && fields->Length > 3)
+	{
+		top = Int64::Parse(fields[3]);
+	}
+}
+
+/// <summary>
+/// Counts a clause once its terminating 0 has been read.
+/// </summary>
+/// <param name="clause">literals kept for the report</param>
+/// <param name="satisfied">true if the model satisfies the clause</param>
+/// <param name="hard">true if the clause must be satisfied</param>
+/// <param name="weight">weight of a soft clause</param>
+void Model_verifier::endClause(const vector<int> &clause, bool satisfied, bool hard, long long weight)
+{
+	clause_count++;
+	if (satisfied)
+	{
+		return;
+	}
+	if (!hard)
+	{
+		soft_cost += weight;
+		return;
+	}
+	falsified_count++;
+	if (first_falsified == 0)
+	{
+		first_falsified = clause_count;
+		first_clause = clause;
+	}
+}
+
+/// <summary>
+/// Determines whether the model makes a literal true.
+/// </summary>
+bool Model_verifier::isTrue(long long literal)
+{
+	long long member = (literal > 0 ? literal : -literal) - 1;
+	unsigned int word = (unsigned int)(member >> 5), bit = 1u << (member & 31);
+	if (word >= assigned.size() || !(assigned[word] & bit))
+	{
+		return false;
+	}
+	return ((values[word] & bit) != 0) == (literal > 0);
+}
+
+/***************************************************
+* private functions END
+***************************************************/
@@ -0,0 +1,115 @@
+#pragma once
+#include <vector>
+#include "Token_reader.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+
+/// <summary>
+/// Checks a model against a cnf (or wcnf) formula in a single pass over the formula.
+/// Only the assignment is held in memory, as a pair of bitsets; clauses are checked as they
+/// are read and then forgotten, apart from the first falsified one, which is kept for the report.
+/// A clause whose literals are all unassigned or false counts as falsified.
+/// In a wcnf formula only the hard clauses, those marked "h" or weighing at least the top weight
+/// of the "p wcnf" line, must be satisfied; the weights of falsified soft clauses add up to the cost.
+/// </summary>
+class Model_verifier
+{
+public:
+
+	/// <summary>
+	/// Default constructor.
+	/// </summary>
+	Model_verifier();
+
+	/// <summary>
+	/// Reads a model: "v" lines as printed by solvers, or plain lists of literals.
+	/// "c" and "s" lines are skipped, the last "o" line gives the claimed cost, and a 0 ends the model.
+	/// </summary>
+	/// <param name="in">reader positioned at the start of the model</param>
+	/// <returns>false if the model says the formula is not satisfiable</returns>
+	bool loadModel(Token_reader^ in);
+
+	/// <summary>
+	/// Streams the formula, checking every clause against the model.
+	/// </summary>
+	/// <param name="in">reader positioned at the start of the formula</param>
+	/// <returns>true if every hard clause is satisfied</returns>
+	bool verify(Token_reader^ in);
+
+	/// <summary>
+	/// Gets the number of clauses read by verify.
+	/// </summary>
+	/// <returns></returns>
+	long long getClauseCount();
+
+	/// <summary>
+	/// Gets the number of falsified hard clauses found by verify.
+	/// </summary>
+	/// <returns></returns>
+	long long getFalsifiedCount();
+
+	/// <summary>
+	/// Gets the 1-based position in the file of the first falsified hard clause.
+	/// </summary>
+	/// <returns>the position, or 0 if no clause was falsified</returns>
+	long long getFirstFalsified();
+
+	/// <summary>
+	/// Gets the literals of the first falsified hard clause.
+	/// </summary>
+	/// <returns></returns>
+	const vector<int> &getFirstFalsifiedClause();
+
+	/// <summary>
+	/// Determines whether verify read a wcnf formula.
+	/// </summary>
+	/// <returns></returns>
+	bool isWeighted();
+
+	/// <summary>
+	/// Gets the summed weight of the soft clauses falsified by the model.
+	/// </summary>
+	/// <returns></returns>
+	long long getSoftCost();
+
+	/// <summary>
+	/// Gets the cost given by the last "o" line of the model.
+	/// </summary>
+	/// <returns>the cost, or -1 if the model has no "o" line</returns>
+	long long getClaimedCost();
+
+private:
+
+	/// <summary>
+	/// Records the value given to a member by a model literal.
+	/// </summary>
+	void assign(long long literal);
+
+	/// <summary>
+	/// Reads the rest of a "p" line, taking the top weight from a "p wcnf" line.
+	/// </summary>
+	void readHeader(Token_reader^ in);
+
+	/// <summary>
+	/// Counts a clause once its terminating 0 has been read.
+	/// </summary>
+	/// <param name="clause">literals kept for the report</param>
+	/// <param name="satisfied">true if the model satisfies the clause</param>
+	/// <param name="hard">true if the clause must be satisfied</param>
+	/// <param name="weight">weight of a soft clause</param>
+	void endClause(const vector<int> &clause, bool satisfied, bool hard, long long weight);
+
+	/// <summary>
+	/// Determines whether the model makes a literal true.
+	/// </summary>
+	bool isTrue(long long literal);
+
+	vector<unsigned int> assigned; //bit per member: the model gives it a value
+	vector<unsigned int> values; //bit per member: the model makes it true
+	long long clause_count, falsified_count, first_falsified;
+	vector<int> first_clause;
+	bool weighted;
+	long long top; //soft clauses weigh less than this; -1 if the "p wcnf" line gives none
+	long long soft_cost, claimed_cost;
+};
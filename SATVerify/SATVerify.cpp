@@ -0,0 +1,82 @@
+// SATVerify.cpp : Defines the entry point for the console application.
+// Checks a model against a cnf or wcnf formula without loading the formula into memory.
+//
+
+#include "stdafx.h"
+#include "Model_verifier.h"
+#include "Token_reader.h"
+#using <System.dll>
+using namespace std;
+using namespace System;
+using namespace System::Diagnostics;
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	if (argc != 3)
+	{
+		Console::WriteLine("Usage: SATVerify <cnf or wcnf file> <model file>");
+		Console::WriteLine("Either file may be gzipped.  Exit code 0: model satisfies the formula, 1: it does not, 2: error.");
+		Console::WriteLine("For a wcnf file the hard clauses must hold, and the cost of the soft clauses must match the model's \"o\" line if it has one.");
+		return 2;
+	}
+	String^ formulaName = gcnew String(argv[1]);
+	String^ modelName = gcnew String(argv[2]);
+
+	Model_verifier verifier;
+	Stopwatch^ timeKeeper = Stopwatch::StartNew();
+	bool verified = false;
+	Token_reader^ model = nullptr;
+	Token_reader^ formula = nullptr;
+	try
+	{
+		model = Token_reader::open(modelName);
+		if (!verifier.loadModel(model))
+		{
+			Console::WriteLine("c the model file does not claim satisfiability");
+			Console::WriteLine("s NOT VERIFIED");
+			return 1;
+		}
+		formula = Token_reader::open(formulaName);
+		verified = verifier.verify(formula);
+	}
+	catch (Exception^ thrown_error)
+	{
+		Console::WriteLine("c " + thrown_error->Message);
+		return 2;
+	}
+	finally
+	{
+		if (model != nullptr)
+			model->close();
+		if (formula != nullptr)
+			formula->close();
+	}
+
+	Console::WriteLine("c clauses checked: " + verifier.getClauseCount().ToString());
+	Console::WriteLine("c falsified " + (verifier.isWeighted() ? "hard " : "") + "clauses: " + verifier.getFalsifiedCount().ToString());
+	if (verifier.isWeighted())
+	{
+		Console::WriteLine("c soft cost: " + verifier.getSoftCost().ToString());
+	}
+	Console::WriteLine("c time: " + timeKeeper->ElapsedMilliseconds.ToString() + " ms");
+	if (!verified)
+	{
+		String^ line = "c first falsified clause: #" + verifier.getFirstFalsified().ToString() + ":";
+		const vector<int> &clause = verifier.getFirstFalsifiedClause();
+		for (unsigned int i = 0; i < clause.size(); i++)
+		{
+			line += " " + clause[i].ToString();
+		}
+		Console::WriteLine(line + " 0");
+		Console::WriteLine("s NOT VERIFIED");
+		return 1;
+	}
+	if (verifier.isWeighted() && verifier.getClaimedCost() >= 0 && verifier.getClaimedCost() != verifier.getSoftCost())
+	{
+		Console::WriteLine("c the model claims cost " + verifier.getClaimedCost().ToString());
+		Console::WriteLine("s NOT VERIFIED");
+		return 1;
+	}
+	Console::WriteLine("s VERIFIED");
+	return 0;
+}
@@ -0,0 +1,135 @@
+#include "stdafx.h"
+#include "Token_reader.h"
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="inStream">stream to be read, already decompressed</param>
+Token_reader::Token_reader(Stream^ inStream)
+{
+	stream = inStream;
+	buffer = gcnew array<Byte>(BUFFER_SIZE);
+	position = 0;
+	length = 0;
+}
+
+/// <summary>
+/// Opens a file, decompressing it when it is gzipped.
+/// </summary>
+/// <param name="path">file to be read</param>
+/// <returns>reader positioned at the start of the file</returns>
+Token_reader^ Token_reader::open(String^ path)
+{
+	FileStream^ file = gcnew FileStream(path, FileMode::Open, FileAccess::Read, FileShare::Read, 1 << 16, FileOptions::SequentialScan);
+	int first = file->ReadByte();
+	int second = file->ReadByte();
+	file->Position = 0;
+	if (first == 0x1F && second == 0x8B)
+	{
+		return gcnew Token_reader(gcnew GZipStream(file, CompressionMode::Decompress));
+	}
+	return gcnew Token_reader(file);
+}
+
+/// <summary>
+/// Gets the next byte without consuming it.
+/// </summary>
+/// <returns>the byte, or -1 at the end of the stream</returns>
+int Token_reader::peek()
+{
+	if (position == length)
+	{
+		fill();
+		if (length == 0)
+		{
+			return -1;
+		}
+	}
+	return buffer[position];
+}
+
+/// <summary>
+/// Consumes and returns the next byte.
+/// </summary>
+/// <returns>the byte, or -1 at the end of the stream</returns>
+int Token_reader::next()
+{
+	int c = peek();
+	if (c >= 0)
+	{
+		position++;
+	}
+	return c;
+}
+
+/// <summary>
+/// Skips spaces, tabs and line breaks.
+/// </summary>
+void Token_reader::skipSpace()
+{
+	int c = peek();
+	while (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+	{
+		position++;
+		c = peek();
+	}
+}
+
+/// <summary>
+/// Consumes the rest of the current line, including the line break.
+/// </summary>
+void Token_reader::skipLine()
+{
+	int c = next();
+	while (c >= 0 && c != '\n')
+	{
+		c = next();
+	}
+}
+
+/// <summary>
+/// Reads a signed decimal number after skipping spaces.
+/// </summary>
+/// <param name="value">receives the number</param>
+/// <returns>false if the next token is not a number</returns>
+bool Token_reader::readNumber(long long &value)
+{
+	skipSpace();
+	bool negative = false;
+	if (peek() == '-')
+	{
+		negative = true;
+		position++;
+	}
+	int c = peek();
+	if (c < '0' || c > '9')
+	{
+		return false;
+	}
+	long long number = 0;
+	while (c >= '0' && c <= '9')
+	{
+		number = number * 10 + (c - '0');
+		position++;
+		c = peek();
+	}
+	value = negative ? -number : number;
+	return true;
+}
+
+/// <summary>
+/// Closes the underlying stream.
+/// </summary>
+void Token_reader::close()
+{
+	stream->Close();
+}
+
+/// <summary>
+/// Refills the buffer from the stream.
+/// </summary>
+void Token_reader::fill()
+{
+	length = stream->Read(buffer, 0, BUFFER_SIZE);
+	position = 0;
+}
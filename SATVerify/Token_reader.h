@@ -0,0 +1,75 @@
+#pragma once
+#using <System.dll>
+using namespace System;
+using namespace System::IO;
+using namespace System::IO::Compression;
+
+/// <summary>
+/// Reads numbers and single bytes from a stream through a large buffer, so that files far
+/// larger than memory can be scanned once.  Files starting with the gzip magic bytes are
+/// decompressed on the fly.
+/// </summary>
+ref class Token_reader
+{
+public:
+
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="inStream">stream to be read, already decompressed</param>
+	Token_reader(Stream^ inStream);
+
+	/// <summary>
+	/// Opens a file, decompressing it when it is gzipped.
+	/// </summary>
+	/// <param name="path">file to be read</param>
+	/// <returns>reader positioned at the start of the file</returns>
+	static Token_reader^ open(String^ path);
+
+	/// <summary>
+	/// Gets the next byte without consuming it.
+	/// </summary>
+	/// <returns>the byte, or -1 at the end of the stream</returns>
+	int peek();
+
+	/// <summary>
+	/// Consumes and returns the next byte.
+	/// </summary>
+	/// <returns>the byte, or -1 at the end of the stream</returns>
+	int next();
+
+	/// <summary>
+	/// Skips spaces, tabs and line breaks.
+	/// </summary>
+	void skipSpace();
+
+	/// <summary>
+	/// Consumes the rest of the current line, including the line break.
+	/// </summary>
+	void skipLine();
+
+	/// <summary>
+	/// Reads a signed decimal number after skipping spaces.
+	/// </summary>
+	/// <param name="value">receives the number</param>
+	/// <returns>false if the next token is not a number</returns>
+	bool readNumber(long long &value);
+
+	/// <summary>
+	/// Closes the underlying stream.
+	/// </summary>
+	void close();
+
+private:
+
+	/// <summary>
+	/// Refills the buffer from the stream.
+	/// </summary>
+	void fill();
+
+	literal int BUFFER_SIZE = 1 << 20;
+
+	Stream^ stream;
+	array<Byte>^ buffer;
+	int position, length;
+};
@@ -0,0 +1,34 @@
+@echo off
+rem Runs SATVerify on the fixtures beside this script and compares every exit code with the
+rem expected one: 0 for a model that must be verified, 1 for one that must be rejected.
+rem Usage: run_fixtures.cmd <path to SATVerify.exe>
+setlocal
+if "%~1"=="" (
+	echo Usage: run_fixtures.cmd ^<path to SATVerify.exe^>
+	exit /b 2
+)
+set VERIFY=%~1
+set DIR=%~dp0
+set FAILED=0
+
+call :expect 0 "%DIR%formula.cnf" "%DIR%satisfying.model"
+call :expect 1 "%DIR%formula.cnf" "%DIR%falsifying.model"
+call :expect 0 "%DIR%formula.cnf.gz" "%DIR%satisfying.model"
+call :expect 1 "%DIR%formula.cnf.gz" "%DIR%falsifying.model"
+call :expect 0 "%DIR%formula.wcnf" "%DIR%optimum.model"
+call :expect 1 "%DIR%formula.wcnf" "%DIR%wrong_cost.model"
+
+if %FAILED%==0 echo All fixtures gave the expected result.
+exit /b %FAILED%
+
+rem Runs the verifier on the second and third arguments and compares its exit code with the first.
+:expect
+"%VERIFY%" %2 %3 >nul
+set GOT=%ERRORLEVEL%
+if "%GOT%"=="%1" (
+	echo ok: %~nx2 %~nx3
+) else (
+	echo FAILED: %~nx2 %~nx3 exited with %GOT%, expected %1
+	set FAILED=1
+)
+exit /b 0